@@ -2,37 +2,48 @@
 
 #define BDL block->data.len
 
-int tx_id_cpy(llist_node_t tx, unsigned int iter, void *buffer);
-
 /**
  * block_hash - hashes a block using sha256
  * @block: block to hash
  * @hash_buf: buffer to store computed hash
- * Return: hash buffer or NULL
+ * Return: hash buffer or NULL, also for a pending block of a lazy chain
+ *
+ * Description: The info, data and transaction ids are fed to the SHA-256
+ * context one after the other, so no preimage buffer is ever allocated.
+ * A block whose transactions chain_lazy_txs() hasn't loaded yet would hash
+ * without its transaction ids, so it is refused.
  */
 uint8_t *block_hash(block_t const *block,
 					uint8_t hash_buf[SHA256_DIGEST_LENGTH])
 {
-	size_t num_tx = 0, buff_len = 0, block_sz = 0;
-	uint8_t *buffer;
+	SHA256_CTX ctx;
 
-	if (!block || !hash_buf)
+	if (!block || !hash_buf || block->lazy)
 		return (NULL);
 
-	if (block->transactions)
-		num_tx = llist_size(block->transactions);
-
-	buff_len = sizeof(block->info) + BDL + (num_tx * SHA256_DIGEST_LENGTH);
-	block_sz = sizeof(block->info) + BDL;
-	buffer = calloc(1, buff_len);
-
-	memcpy(buffer, block, block_sz);
-	llist_for_each(block->transactions, tx_id_cpy, buffer + block_sz);
-	SHA256(buffer, buff_len, hash_buf);
+	SHA256_Init(&ctx);
+	SHA256_Update(&ctx, block, sizeof(block->info) + BDL);
+	llist_for_each(block->transactions, tx_id_update, &ctx);
+	SHA256_Final(hash_buf, &ctx);
 
 	return (hash_buf);
 }
 
+/**
+ * tx_id_update - function to feed a tx_id to a SHA-256 context
+ * @tx: Transaction to hash the id of
+ * @iter: index of transaction
+ * @ctx: SHA256_CTX to update
+ * Return: 1 on Fail, otherwise 0
+ */
+int tx_id_update(llist_node_t tx, unsigned int iter, void *ctx)
+{
+	(void)iter;
+	if (!SHA256_Update(ctx, ((transaction_t *)tx)->id, SHA256_DIGEST_LENGTH))
+		return (1);
+	return (0);
+}
+
 /**
  * tx_id_cpy - function to copy tx_id into a buffer
  * @tx: Transaction to store to buffer
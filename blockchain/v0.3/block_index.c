@@ -0,0 +1,156 @@
+#include "blockchain.h"
+#include <fcntl.h>
+
+int block_index_cmp(void const *a, void const *b);
+
+/**
+ * block_index_add - records the offset of the next block of a chain file
+ * @index: index to add to
+ * @offset: offset of the block record
+ * @hash: hash of the block
+ * Return: 0 on success, 1 on fail
+ */
+int block_index_add(block_index_t *index, uint64_t offset,
+	uint8_t const hash[SHA256_DIGEST_LENGTH])
+{
+	uint64_t *offsets;
+	block_index_entry_t *by_hash;
+	uint32_t capacity, *crcs;
+
+	/* One more offset than blocks, for the end of the last one */
+	if (index->count + 1 >= index->capacity)
+	{
+		capacity = index->capacity ? index->capacity * 2 : 64;
+		offsets = realloc(index->offsets, capacity * sizeof(*offsets));
+		if (!offsets)
+			return (1);
+		index->offsets = offsets;
+		by_hash = realloc(index->by_hash, capacity * sizeof(*by_hash));
+		if (!by_hash)
+			return (1);
+		index->by_hash = by_hash;
+		crcs = realloc(index->crcs, capacity * sizeof(*crcs));
+		if (!crcs)
+			return (1);
+		index->crcs = crcs;
+		index->capacity = capacity;
+	}
+	index->offsets[index->count] = offset;
+	memcpy(index->by_hash[index->count].hash, hash, SHA256_DIGEST_LENGTH);
+	index->by_hash[index->count].height = index->count;
+	index->count++;
+	return (0);
+}
+
+/**
+ * block_index_free - frees the arrays of a block index
+ * @index: index to empty
+ */
+void block_index_free(block_index_t *index)
+{
+	free(index->offsets);
+	free(index->by_hash);
+	free(index->crcs);
+	memset(index, 0, sizeof(*index));
+}
+
+/**
+ * block_index_path - names the block index sidecar of a chain file
+ * @path: chain file
+ * Return: path of the sidecar, to free, or NULL
+ */
+char *block_index_path(char const *path)
+{
+	char *idx = malloc(strlen(path) + sizeof(HBLK_INDEX_EXT));
+
+	if (idx)
+		sprintf(idx, "%s%s", path, HBLK_INDEX_EXT);
+	return (idx);
+}
+
+/**
+ * block_index_save - writes the block index sidecar of a chain file
+ * @index: offsets of the blocks, NULL to only remove a stale sidecar
+ * @path: chain file
+ * @blocks_end: offset right past the last block
+ * @chain_size: size of the chain file, to tell when the sidecar is stale
+ * along with the hash of the last block
+ * @flags: HBLK_INDEX_CRC if @index->crcs are to be trusted, 0 otherwise
+ * Return: 0 on success, 1 on fail
+ *
+ * Description: The sidecar holds a header, then one offset per block plus
+ * @blocks_end, then the hash and height of each block sorted by hash, then
+ * the CRC-32C of each block if @flags has HBLK_INDEX_CRC.
+ */
+int block_index_save(block_index_t const *index, char const *path,
+	uint64_t blocks_end, uint64_t chain_size, uint32_t flags)
+{
+	serial_buf_t sb = {-1, NULL, 0, 0, 0, NULL, 0, 0};
+	char *idx = block_index_path(path), *tmp = NULL;
+	block_index_entry_t *sorted = NULL;
+	uint32_t i;
+	uint8_t *p;
+	int ret = 1;
+
+	if (!idx)
+		return (1);
+	remove(idx);
+	if (!index)
+	{
+		ret = 0;
+		goto out;
+	}
+	tmp = malloc(strlen(idx) + 5);
+	sorted = malloc((index->count + 1) * sizeof(*sorted));
+	sb.buf = malloc(SERIAL_BUF_SIZE);
+	if (!tmp || !sorted || !sb.buf)
+		goto out;
+	sprintf(tmp, "%s.tmp", idx);
+	sb.fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (sb.fd == -1)
+		goto out;
+
+	p = serial_reserve(&sb, HBLK_INDEX_HEADER_SIZE);
+	memcpy(&p[0], HBLK_INDEX_MAGIC, 7);
+	memcpy(&p[7], END, 1);
+	memcpy(&p[8], &index->count, 4);
+	memcpy(&p[12], &flags, 4);
+	memcpy(&p[16], &chain_size, 8);
+	memset(&p[24], 0, SHA256_DIGEST_LENGTH);
+	if (index->count)
+		memcpy(&p[24], index->by_hash[index->count - 1].hash,
+			SHA256_DIGEST_LENGTH);
+	for (i = 0; i <= index->count && (p = serial_reserve(&sb, 8)); i++)
+		memcpy(p, i < index->count ? &index->offsets[i] : &blocks_end, 8);
+	memcpy(sorted, index->by_hash, index->count * sizeof(*sorted));
+	qsort(sorted, index->count, sizeof(*sorted), block_index_cmp);
+	for (i = 0; i < index->count &&
+		(p = serial_reserve(&sb, HBLK_INDEX_ENTRY_SIZE)); i++)
+		memcpy(p, &sorted[i], HBLK_INDEX_ENTRY_SIZE);
+	for (i = 0; (flags & HBLK_INDEX_CRC) && i < index->count &&
+		(p = serial_reserve(&sb, 4)); i++)
+		memcpy(p, &index->crcs[i], 4);
+	serial_flush(&sb);
+	if (close(sb.fd) || sb.error || rename(tmp, idx))
+		remove(tmp);
+	else
+		ret = 0;
+out:
+	free(sb.buf);
+	free(sorted);
+	free(tmp);
+	free(idx);
+	return (ret);
+}
+
+/**
+ * block_index_cmp - qsort() comparison of index entries by hash
+ * @a: first entry
+ * @b: second entry
+ * Return: memcmp() of the hashes
+ */
+int block_index_cmp(void const *a, void const *b)
+{
+	return (memcmp(((block_index_entry_t const *)a)->hash,
+		((block_index_entry_t const *)b)->hash, SHA256_DIGEST_LENGTH));
+}
@@ -0,0 +1,329 @@
+#include "blockchain.h"
+#include <fcntl.h>
+
+/**
+ * blockchain_load_block - loads one block of a chain file
+ * @path: chain file
+ * @index: height of the block
+ * Return: pointer to the block or NULL
+ *
+ * Description: The offset of the block comes from the block index
+ * sidecar, rebuilt first if it is missing or stale, so the block is read
+ * with a single seek whatever its height.
+ */
+block_t *blockchain_load_block(char const *path, uint32_t index)
+{
+	block_t *block;
+	uint32_t nblocks;
+	int fd, rebuild;
+
+	/* A stale sidecar of the right size shows as a block of another height */
+	for (rebuild = 0; rebuild < 2; rebuild++)
+	{
+		fd = block_index_open(path, &nblocks, rebuild);
+		if (fd == -1)
+			return (NULL);
+		block = index < nblocks ? block_index_read(path, fd, index) : NULL;
+		close(fd);
+		if (block && block->info.index == index)
+			return (block);
+		block_destroy(block);
+		if (index >= nblocks)
+			break;
+	}
+	return (NULL);
+}
+
+/**
+ * blockchain_load_block_by_hash - loads the block of a chain file with the
+ * given hash
+ * @path: chain file
+ * @hash: hash of the block
+ * Return: pointer to the block or NULL if the chain holds no such block
+ */
+block_t *blockchain_load_block_by_hash(char const *path,
+	uint8_t const hash[SHA256_DIGEST_LENGTH])
+{
+	block_index_entry_t entry;
+	uint32_t nblocks, lo, hi, mid;
+	off_t sorted;
+	block_t *block;
+	int fd, cmp = 1;
+
+	if (!hash)
+		return (NULL);
+	fd = block_index_open(path, &nblocks, 0);
+	if (fd == -1)
+		return (NULL);
+	sorted = HBLK_INDEX_HEADER_SIZE + ((off_t)nblocks + 1) * 8;
+	for (lo = 0, hi = nblocks; lo < hi;)
+	{
+		mid = lo + (hi - lo) / 2;
+		if (pread(fd, &entry, HBLK_INDEX_ENTRY_SIZE,
+			sorted + (off_t)mid * HBLK_INDEX_ENTRY_SIZE) !=
+			HBLK_INDEX_ENTRY_SIZE)
+		{
+			cmp = 1;
+			break;
+		}
+		cmp = memcmp(entry.hash, hash, SHA256_DIGEST_LENGTH);
+		if (!cmp)
+			break;
+		if (cmp < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	close(fd);
+	if (cmp)
+		return (NULL);
+	block = blockchain_load_block(path, entry.height);
+	if (block && memcmp(block->hash, hash, SHA256_DIGEST_LENGTH))
+	{
+		block_destroy(block);
+		block = NULL;
+	}
+	return (block);
+}
+
+/**
+ * block_index_open - opens the block index sidecar of a chain file
+ * @path: chain file
+ * @nblocks: set to the number of blocks of the chain
+ * @rebuild: 1 to rebuild the sidecar first even if it looks up to date,
+ * 0 to rebuild it only if it is missing or stale, -1 never to rebuild it
+ * Return: file descriptor of the sidecar, or -1
+ *
+ * Description: The sidecar is stale if the chain file changed size, or if
+ * the block at its last indexed offset doesn't have the tip hash it
+ * recorded, as when the chain was rewritten with as many bytes.
+ */
+int block_index_open(char const *path, uint32_t *nblocks, int rebuild)
+{
+	char *idx = path ? block_index_path(path) : NULL;
+	uint8_t header[HBLK_INDEX_HEADER_SIZE];
+	uint64_t chain_size;
+	struct stat st;
+	int fd = -1, tries, chain = -1;
+
+	if (!idx)
+		goto out;
+	chain = open(path, O_RDONLY);
+	if (chain == -1 || fstat(chain, &st))
+		goto out;
+	for (tries = rebuild < 0; tries < 2; tries++, rebuild = 1)
+	{
+		if (rebuild > 0 && block_index_rebuild(path))
+			break;
+		fd = open(idx, O_RDONLY);
+		if (fd == -1)
+			continue;
+		if (read(fd, header, sizeof(header)) == sizeof(header) &&
+			!memcmp(header, HBLK_INDEX_MAGIC, 7) &&
+			header[7] == (uint8_t)END[0])
+		{
+			memcpy(nblocks, header + 8, 4);
+			memcpy(&chain_size, header + 16, 8);
+			if (chain_size == (uint64_t)st.st_size &&
+				block_index_tip_ok(chain, fd, *nblocks, header + 24))
+				break;
+		}
+		close(fd);
+		fd = -1;
+	}
+out:
+	if (chain != -1)
+		close(chain);
+	free(idx);
+	return (fd);
+}
+
+/**
+ * block_index_tip_ok - checks the last block a sidecar indexes is still
+ * the one it was written for
+ * @chain: chain file
+ * @fd: block index sidecar
+ * @nblocks: number of blocks the sidecar indexes
+ * @tip: hash of the last block recorded in the sidecar header
+ * Return: 1 if the block at the last indexed offset has hash @tip, or if
+ * there is no block, 0 otherwise
+ */
+int block_index_tip_ok(int chain, int fd, uint32_t nblocks,
+	uint8_t const tip[SHA256_DIGEST_LENGTH])
+{
+	uint8_t hash[SHA256_DIGEST_LENGTH];
+	uint64_t offset;
+	uint32_t len;
+
+	if (!nblocks)
+		return (1);
+	if (pread(fd, &offset, 8, HBLK_INDEX_HEADER_SIZE +
+		((off_t)nblocks - 1) * 8) != 8 ||
+		pread(chain, &len, 4, offset + sizeof(block_info_t)) != 4 ||
+		len > BLOCKCHAIN_DATA_MAX ||
+		pread(chain, hash, SHA256_DIGEST_LENGTH,
+		offset + sizeof(block_info_t) + 4 + len) != SHA256_DIGEST_LENGTH)
+		return (0);
+	return (!memcmp(hash, tip, SHA256_DIGEST_LENGTH));
+}
+
+/**
+ * block_index_read - reads one block of a chain file at its indexed offset
+ * @path: chain file
+ * @fd: block index sidecar
+ * @height: height of the block, below the number of blocks
+ * Return: pointer to the block or NULL
+ */
+block_t *block_index_read(char const *path, int fd, uint32_t height)
+{
+	uint64_t range[2];
+	uint8_t *record;
+	block_t *block = NULL;
+	int chain;
+
+	if (pread(fd, range, sizeof(range),
+		HBLK_INDEX_HEADER_SIZE + (off_t)height * 8) != sizeof(range) ||
+		range[1] <= range[0])
+		return (NULL);
+	chain = open(path, O_RDONLY);
+	if (chain == -1)
+		return (NULL);
+	record = malloc(range[1] - range[0]);
+	if (record && pread(chain, record, range[1] - range[0], range[0]) ==
+		(ssize_t)(range[1] - range[0]))
+		block = hblk_block_decode(record, range[1] - range[0]);
+	free(record);
+	close(chain);
+	return (block);
+}
+
+/**
+ * block_index_rebuild - writes the block index sidecar of a chain file
+ * from the file itself
+ * @path: chain file
+ * Return: 0 on success, 1 on fail
+ *
+ * Description: Nothing vouches for the bytes of the file, so the sidecar
+ * gets no CRCs and blockchain_load_trusted() checks every hash.
+ */
+int block_index_rebuild(char const *path)
+{
+	chain_map_t *map = chain_map_open(path);
+	int ret;
+
+	if (!map)
+		return (1);
+	ret = block_index_map_save(map, path, 0);
+	chain_map_close(map);
+	return (ret);
+}
+
+/**
+ * block_index_map_save - writes the block index sidecar of a mapped chain
+ * file
+ * @map: mapped chain file
+ * @path: chain file
+ * @flags: HBLK_INDEX_CRC to store the CRC-32C of the blocks as mapped,
+ * only once their hashes were checked, 0 otherwise
+ * Return: 0 on success, 1 on fail
+ */
+int block_index_map_save(chain_map_t const *map, char const *path,
+	uint32_t flags)
+{
+	block_index_t index = {NULL, NULL, NULL, 0, 0};
+	block_view_t view;
+	uint32_t i;
+	size_t end;
+	int ret = 1;
+
+	for (i = 0; i < map->nblocks; i++)
+	{
+		chain_map_block_view(map, i, &view);
+		if (block_index_add(&index, map->blocks[i], view.hash))
+			break;
+		end = i + 1 < map->nblocks ? map->blocks[i + 1] : map->unspent;
+		if (flags & HBLK_INDEX_CRC)
+			index.crcs[i] = crc32c(0, map->base + map->blocks[i],
+				end - map->blocks[i]);
+	}
+	if (i == map->nblocks)
+		ret = block_index_save(&index, path, map->unspent, map->size, flags);
+	block_index_free(&index);
+	return (ret);
+}
+
+/**
+ * hblk_block_decode - makes a mutable copy of a block record
+ * @record: block record, followed by its transactions
+ * @size: number of bytes of the record and its transactions
+ * Return: pointer to the block or NULL if the record is malformed
+ */
+block_t *hblk_block_decode(uint8_t const *record, size_t size)
+{
+	size_t off, len;
+	block_t *block;
+	tx_view_t view;
+	transaction_t *tx;
+	int32_t ntxs, i;
+
+	if (size < HBLK_BLOCK_SIZE(0))
+		return (NULL);
+	block = calloc(1, sizeof(*block));
+	if (!block)
+		return (NULL);
+	memcpy(&block->info, record, sizeof(block_info_t));
+	memcpy(&block->data.len, record + sizeof(block_info_t), 4);
+	if (block->data.len > BLOCKCHAIN_DATA_MAX ||
+		size < HBLK_BLOCK_SIZE(block->data.len))
+		goto fail;
+	off = sizeof(block_info_t) + 4;
+	memcpy(block->data.buffer, record + off, block->data.len);
+	off += block->data.len;
+	memcpy(block->hash, record + off, SHA256_DIGEST_LENGTH);
+	memcpy(&ntxs, record + off + SHA256_DIGEST_LENGTH, 4);
+	off = HBLK_BLOCK_SIZE(block->data.len);
+	if (ntxs == -1)
+		return (block);
+	block->transactions = llist_create(MT_SUPPORT_FALSE);
+	for (i = 0; block->transactions && i < ntxs; i++, off += len)
+	{
+		len = hblk_tx_view(record + off, size - off, &view);
+		tx = len ? hblk_tx_decode(&view) : NULL;
+		if (!tx || llist_add_node(block->transactions, tx, ADD_NODE_REAR))
+		{
+			transaction_destroy(tx);
+			goto fail;
+		}
+	}
+	if (block->transactions && ntxs >= 0)
+		return (block);
+fail:
+	block_destroy(block);
+	return (NULL);
+}
+
+/**
+ * block_index_crcs - reads the block CRCs of a block index sidecar
+ * @fd: block index sidecar, from block_index_open()
+ * @nblocks: number of blocks of the chain
+ * Return: array of @nblocks CRC-32C to free, or NULL if the sidecar has
+ * none, as one written before they were added
+ */
+uint32_t *block_index_crcs(int fd, uint32_t nblocks)
+{
+	uint32_t flags, *crcs;
+	size_t size = (size_t)nblocks * sizeof(*crcs);
+
+	if (!nblocks || pread(fd, &flags, 4, 12) != 4 ||
+		!(flags & HBLK_INDEX_CRC))
+		return (NULL);
+	crcs = malloc(size);
+	if (crcs && pread(fd, crcs, size, HBLK_INDEX_HEADER_SIZE +
+		((off_t)nblocks + 1) * 8 + (off_t)nblocks * HBLK_INDEX_ENTRY_SIZE) !=
+		(ssize_t)size)
+	{
+		free(crcs);
+		crcs = NULL;
+	}
+	return (crcs);
+}
@@ -1,7 +1,10 @@
 #include "blockchain.h"
 
 int is_genesis(block_t const *block);
-int valid_tx(transaction_t *tx, unsigned int iter, llist_t *unspent);
+int block_head_is_valid(block_t const *block, block_t const *prev_block);
+int block_txs_check(block_t const *block, utxo_set_t *all_unspent,
+	unsigned int nthreads);
+int valid_tx(transaction_t *tx, unsigned int iter, utxo_set_t *unspent);
 
 /**
  * block_is_valid - function to validate a block
@@ -9,14 +12,83 @@ int valid_tx(transaction_t *tx, unsigned int iter, llist_t *unspent);
  * @prev_block: block before block to validate
  * @all_unspent: list of unspent transactions
  * Return: 0 on Success, 1 on fail
+ *
+ * Description: The list is indexed once in a hashed set, so each input
+ * costs O(1) instead of a scan of @all_unspent. The set is only built
+ * once the header, hashes, difficulty and coinbase have passed, and only
+ * if a transaction other than the coinbase has inputs to look up.
  */
 int block_is_valid(
 	block_t const *block, block_t const *prev_block, llist_t *all_unspent)
+{
+	utxo_set_t *set = NULL;
+	int ret;
+
+	if (block_head_is_valid(block, prev_block))
+		return (1);
+	if (block->info.index == 0 || llist_size(block->transactions) < 2)
+		return (0);
+	if (all_unspent)
+	{
+		set = utxo_set_from_list(all_unspent);
+		if (!set)
+			return (1);
+	}
+	ret = block_txs_check(block, set, 1);
+	utxo_set_destroy(set, 0);
+	return (ret);
+}
+
+/**
+ * block_is_valid_set - function to validate a block against a hashed set
+ * of unspent transactions
+ * @block: block to validate
+ * @prev_block: block before block to validate
+ * @all_unspent: set of unspent transactions
+ * Return: 0 on Success, 1 on fail
+ */
+int block_is_valid_set(
+	block_t const *block, block_t const *prev_block, utxo_set_t *all_unspent)
+{
+	return (block_is_valid_set_parallel(block, prev_block, all_unspent, 1));
+}
+
+/**
+ * block_is_valid_set_parallel - function to validate a block against a
+ * hashed set of unspent transactions, verifying signatures on threads
+ * @block: block to validate
+ * @prev_block: block before block to validate
+ * @all_unspent: set of unspent transactions
+ * @nthreads: number of threads checking signatures, 1 to check each one
+ * in turn, 0 for one per online CPU
+ * Return: 0 on Success, 1 on fail
+ *
+ * Description: A block of a lazy chain whose transactions aren't loaded
+ * yet is refused, chain_lazy_txs() loads them.
+ */
+int block_is_valid_set_parallel(block_t const *block,
+	block_t const *prev_block, utxo_set_t *all_unspent, unsigned int nthreads)
+{
+	if (block_head_is_valid(block, prev_block))
+		return (1);
+	if (block->info.index == 0)
+		return (0);
+	return (block_txs_check(block, all_unspent, nthreads));
+}
+
+/**
+ * block_head_is_valid - runs the checks of a block that need no unspent
+ * transaction: index, hashes, data size, difficulty and coinbase
+ * @block: block to validate
+ * @prev_block: block before block to validate
+ * Return: 0 on Success, 1 on fail
+ */
+int block_head_is_valid(block_t const *block, block_t const *prev_block)
 {
 	uint8_t prev_hash[SHA256_DIGEST_LENGTH] = {0};
 	uint8_t current_hash[SHA256_DIGEST_LENGTH] = {0};
 
-	if (!block)
+	if (!block || block->lazy || (prev_block && prev_block->lazy))
 		return (1);
 	if (!prev_block && block->info.index != 0)
 		return (1);
@@ -47,6 +119,23 @@ int block_is_valid(
 		(transaction_t *)llist_get_head(block->transactions),
 		block->info.index))
 		return (1);
+	return (0);
+}
+
+/**
+ * block_txs_check - validates the transactions of a block after its
+ * coinbase
+ * @block: block whose header already passed block_head_is_valid()
+ * @all_unspent: set of unspent transactions
+ * @nthreads: number of threads checking signatures, as for
+ * block_is_valid_set_parallel()
+ * Return: 0 on Success, 1 on fail
+ */
+int block_txs_check(block_t const *block, utxo_set_t *all_unspent,
+	unsigned int nthreads)
+{
+	if (nthreads != 1)
+		return (block_txs_are_valid(block, all_unspent, nthreads));
 	if (llist_for_each(block->transactions, (node_func_t)&valid_tx, all_unspent))
 		return (1);
 	return (0);
@@ -62,7 +151,7 @@ int is_genesis(block_t const *block)
 	block_t genesis = {
 		{0, 0, 1537578000, 0, {0}},
 		{"Holberton School", 16}, 0,
-		HOLBERTON_HASH};
+		HOLBERTON_HASH, NULL};
 
 	return (memcmp(&genesis, block, 1116));
 }
@@ -71,12 +160,12 @@ int is_genesis(block_t const *block)
  * valid_tx - validates all transactions
  * @tx: transaction to verify
  * @iter: index of tx
- * @unspent: list of unspent tx
+ * @unspent: set of unspent tx
  * Return: 0 if valid, 1 if not
  */
-int valid_tx(transaction_t *tx, unsigned int iter, llist_t *unspent)
+int valid_tx(transaction_t *tx, unsigned int iter, utxo_set_t *unspent)
 {
-	if (iter && !transaction_is_valid(tx, unspent))
+	if (iter && !transaction_is_valid_set(tx, unspent))
 		return (1);
 	return (0);
 }
@@ -0,0 +1,76 @@
+#include "blockchain.h"
+
+int batch_tx(transaction_t *tx, unsigned int iter, tv_t *proto);
+
+/**
+ * block_is_valid_parallel - function to validate a block, verifying the
+ * signatures of its transactions on several threads
+ * @block: block to validate
+ * @prev_block: block before block to validate
+ * @all_unspent: list of unspent transactions
+ * @nthreads: number of threads checking signatures, 0 for one per online CPU
+ * Return: 0 on Success, 1 on fail, exactly as block_is_valid()
+ */
+int block_is_valid_parallel(block_t const *block, block_t const *prev_block,
+	llist_t *all_unspent, unsigned int nthreads)
+{
+	utxo_set_t *set = NULL;
+	int ret;
+
+	if (all_unspent)
+	{
+		set = utxo_set_from_list(all_unspent);
+		if (!set)
+			return (1);
+	}
+	ret = block_is_valid_set_parallel(block, prev_block, set, nthreads);
+	utxo_set_destroy(set, 0);
+	return (ret);
+}
+
+/**
+ * block_txs_are_valid - validates the non coinbase transactions of a block,
+ * checking every signature once all the rest is known to be valid
+ * @block: block holding the transactions
+ * @all_unspent: set of unspent tx
+ * @nthreads: number of threads checking signatures, 0 for one per online CPU
+ * Return: 0 if valid, 1 if not
+ *
+ * Description: The first pass does the cheap lookups and amount checks and
+ * queues each (public key, tx id, signature) triple; the signatures, which
+ * cost nearly all the time, are then verified across the threads.
+ */
+int block_txs_are_valid(block_t const *block, utxo_set_t *all_unspent,
+	unsigned int nthreads)
+{
+	sig_batch_t batch = {0};
+	tv_t proto = {0};
+	int ret = 1;
+
+	proto.set = all_unspent;
+	proto.batch = &batch;
+	if (!llist_for_each(block->transactions, (node_func_t)&batch_tx, &proto) &&
+		sig_batch_verify(&batch, nthreads))
+		ret = 0;
+	sig_batch_free(&batch);
+	return (ret);
+}
+
+/**
+ * batch_tx - validates a transaction, queuing its signatures
+ * @tx: transaction to verify
+ * @iter: index of tx
+ * @proto: context holding the set of unspent tx and the batch
+ * Return: 0 if valid, 1 if not
+ */
+int batch_tx(transaction_t *tx, unsigned int iter, tv_t *proto)
+{
+	tv_t context = *proto;
+
+	if (!iter)
+		return (0);
+	if (!tx || !context.set)
+		return (1);
+	memcpy(context.tx_id, tx->id, SHA256_DIGEST_LENGTH);
+	return (!tx_context_is_valid(tx, &context));
+}
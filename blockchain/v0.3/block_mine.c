@@ -3,20 +3,40 @@
 /**
  * block_mine - Changes the nonce until the hash matches the difficulty
  * @block: block to mine
+ *
+ * Description: Nonces are hashed in batches of one per kernel lane and
+ * each batch is checked in order, so the nonce found is the first one a
+ * one-at-a-time search would have settled on. A pending block of a lazy
+ * chain, which block_hash() refuses, is left as it is.
  */
 void block_mine(block_t *block)
 {
-	uint8_t *hash = NULL;
+	uint8_t digests[SHA256_MB_MAX_LANES][SHA256_DIGEST_LENGTH], *hash;
+	difficulty_mask_t mask;
+	mine_ctx_t ctx;
+	size_t i, n;
 
-	if (!block)
+	if (!block || block->lazy)
 		return;
-	if (hash_matches_difficulty(block->hash, block->info.difficulty))
-		return;
-	for (; ; block->info.nonce++)
+	if (mine_ctx_init(&ctx, block))
+	{
+		for (; ; block->info.nonce++)
+		{
+			hash = block_hash(block, block->hash);
+			if (hash_matches_difficulty(hash, block->info.difficulty))
+				return;
+		}
+	}
+	difficulty_mask_init(&mask, block->info.difficulty);
+	for (; ; )
 	{
-		hash = block_hash(block, block->hash);
-		if (hash_matches_difficulty(hash, block->info.difficulty))
-			break;
+		n = mine_ctx_batch(&ctx, block->info.nonce, digests);
+		for (i = 0; i < n; i++, block->info.nonce++)
+			if (hash_matches_mask(digests[i], &mask))
+			{
+				memcpy(block->hash, digests[i], SHA256_DIGEST_LENGTH);
+				mine_ctx_free(&ctx);
+				return;
+			}
 	}
-	memcpy(block->hash, hash, SHA256_DIGEST_LENGTH);
 }
@@ -0,0 +1,120 @@
+#include "blockchain.h"
+
+int mine_workers_run(mine_shared_t *shared);
+void *mine_worker(void *arg);
+void mine_best_update(mine_shared_t *shared, uint64_t offset);
+
+/**
+ * block_mine_parallel - Mines a block by splitting the nonce space
+ * across several worker threads
+ * @block: block to mine
+ * @nthreads: number of workers, 0 to use one per online CPU
+ *
+ * Description: The nonce space is cut in batches of one nonce per kernel
+ * lane. Worker @t tests the batches t, t + nthreads, ... and every worker
+ * stops once it passes the lowest winning nonce found so far, so the result
+ * is the exact nonce block_mine() would settle on.
+ */
+void block_mine_parallel(block_t *block, unsigned int nthreads)
+{
+	mine_shared_t shared;
+	mine_ctx_t ctx;
+
+	if (!block)
+		return;
+	if (!nthreads)
+		nthreads = (unsigned int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (nthreads < 2 || mine_ctx_init(&ctx, block))
+	{
+		block_mine(block);
+		return;
+	}
+
+	shared.block = block, shared.ctx = &ctx, shared.nthreads = nthreads;
+	shared.best = UINT64_MAX;
+	if (mine_workers_run(&shared) || shared.best == UINT64_MAX)
+	{
+		mine_ctx_free(&ctx);
+		block_mine(block);
+		return;
+	}
+	block->info.nonce += shared.best;
+	mine_ctx_hash(&ctx, block->info.nonce, block->hash);
+	mine_ctx_free(&ctx);
+}
+
+/**
+ * mine_workers_run - Starts the mining workers and waits for them
+ * @shared: state shared by the workers
+ * Return: 0 if every worker ran, 1 on fail
+ */
+int mine_workers_run(mine_shared_t *shared)
+{
+	mine_worker_t *workers;
+	uint64_t i, started = 0;
+
+	workers = calloc(shared->nthreads, sizeof(*workers));
+	if (!workers)
+		return (1);
+	for (i = 0; i < shared->nthreads; i++)
+	{
+		workers[i].shared = shared, workers[i].id = i;
+		if (pthread_create(&workers[i].thread, NULL, mine_worker, &workers[i]))
+			break;
+		started++;
+	}
+	/* A missing worker leaves a hole in the stride: stop everyone */
+	if (started < shared->nthreads)
+		__atomic_store_n(&shared->best, 0, __ATOMIC_RELAXED);
+	for (i = 0; i < started; i++)
+		pthread_join(workers[i].thread, NULL);
+	free(workers);
+	return (started < shared->nthreads);
+}
+
+/**
+ * mine_worker - Thread routine testing one stride of the nonce space
+ * @arg: pointer to the worker's mine_worker_t
+ * Return: NULL
+ */
+void *mine_worker(void *arg)
+{
+	mine_worker_t *worker = arg;
+	mine_shared_t *shared = worker->shared;
+	uint64_t start = shared->block->info.nonce, lanes = shared->ctx->lanes;
+	uint64_t offset = worker->id * lanes, stride = shared->nthreads * lanes;
+	uint8_t digests[SHA256_MB_MAX_LANES][SHA256_DIGEST_LENGTH];
+	difficulty_mask_t mask;
+	uint64_t i;
+
+	difficulty_mask_init(&mask, shared->block->info.difficulty);
+	while (offset < __atomic_load_n(&shared->best, __ATOMIC_RELAXED))
+	{
+		mine_ctx_batch(shared->ctx, start + offset, digests);
+		for (i = 0; i < lanes; i++)
+			if (hash_matches_mask(digests[i], &mask))
+			{
+				mine_best_update(shared, offset + i);
+				return (NULL);
+			}
+		if (offset > UINT64_MAX - stride)
+			break;
+		offset += stride;
+	}
+	return (NULL);
+}
+
+/**
+ * mine_best_update - Lowers the shared winning offset if @offset is smaller
+ * @shared: state shared by the workers
+ * @offset: winning nonce offset just found
+ */
+void mine_best_update(mine_shared_t *shared, uint64_t offset)
+{
+	uint64_t best = __atomic_load_n(&shared->best, __ATOMIC_RELAXED);
+
+	while (offset < best &&
+		!__atomic_compare_exchange_n(&shared->best, &best, offset, 0,
+			__ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		;
+}
@@ -5,10 +5,12 @@
 #include "transaction/transaction.h"
 #include <openssl/sha.h>
 #include <llist.h>
+#include <pthread.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 #include <time.h>
@@ -25,6 +27,43 @@
 #define VERS "\x30\x2e\x33"
 #define END ((_get_endianness() == 1) ? "\x01" : "\x02")
 #define FHEADER "\x48\x42\x4c\x4b\x30\x2e\x33"
+/* Compact format: varint counts, compressed keys, sized signatures */
+#define FHEADER_COMPACT "\x48\x42\x4c\x4b\x30\x2e\x34"
+/* Compact public key tags: raw 65 bytes, or X with the parity of Y */
+#define COMPACT_PUB_RAW 0x00
+#define COMPACT_PUB_EVEN 0x02
+#define COMPACT_PUB_ODD 0x03
+/* Set in a key tag or a block or transaction flag byte when the hash that */
+/* follows is stored, because it isn't the one computed from the rest */
+#define COMPACT_HASH_STORED 0x80
+/* Sizes of the records of a serialized blockchain */
+#define HBLK_HEADER_SIZE 16
+#define HBLK_BLOCK_SIZE(len) (96 + (len))
+#define HBLK_TX_SIZE 40
+#define HBLK_IN_SIZE 169
+#define HBLK_OUT_SIZE 101
+#define HBLK_UNSPENT_SIZE 165
+/* Block index sidecar: path of the chain file with this suffix; */
+/* header of magic, endianness, block count, flags, chain size, tip hash */
+#define HBLK_INDEX_EXT ".idx"
+#define HBLK_INDEX_MAGIC "\x48\x42\x49\x58\x30\x2e\x33"
+#define HBLK_INDEX_HEADER_SIZE 56
+#define HBLK_INDEX_ENTRY_SIZE 36
+/* Flag of a block index header: a CRC-32C of each block follows the hashes */
+#define HBLK_INDEX_CRC 0x1
+/* Transaction index sidecar: path of the chain file with this suffix; */
+/* header of magic, endianness, transaction count, block count, chain size */
+#define TX_INDEX_EXT ".txi"
+#define TX_INDEX_MAGIC "\x48\x54\x58\x49\x30\x2e\x33"
+#define TX_INDEX_HEADER_SIZE 24
+#define TX_INDEX_ENTRY_SIZE 40
+/* UTXO snapshot: magic, endianness, height, count, tip hash */
+#define UTXO_SNAPSHOT_MAGIC "\x48\x55\x54\x58\x30\x2e\x33"
+#define UTXO_SNAPSHOT_HEADER_SIZE 48
+/* Bytes staged by blockchain_serialize() between two write() calls */
+#define SERIAL_BUF_SIZE (1 << 20)
+/* Initial size of the chain_reader_open() decode buffer */
+#define CHAIN_READER_BUF_SIZE (1 << 16)
 
 #define BLOCK_GENERATION_INTERVAL 1
 #define DIFFICULTY_ADJUSTMENT_INTERVAL 5
@@ -33,19 +72,91 @@
 	((x->info.index - y->info.index) * BLOCK_GENERATION_INTERVAL)
 #define ACTUAL(x, y) (x->info.timestamp - y->info.timestamp)
 
+#define SHA_ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define SHA_CH(x, y, z) (((x) & (y)) ^ (~(x) & (z)))
+#define SHA_MAJ(x, y, z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define SHA_EP0(x) (SHA_ROTR(x, 2) ^ SHA_ROTR(x, 13) ^ SHA_ROTR(x, 22))
+#define SHA_EP1(x) (SHA_ROTR(x, 6) ^ SHA_ROTR(x, 11) ^ SHA_ROTR(x, 25))
+#define SHA_SIG0(x) (SHA_ROTR(x, 7) ^ SHA_ROTR(x, 18) ^ ((x) >> 3))
+#define SHA_SIG1(x) (SHA_ROTR(x, 17) ^ SHA_ROTR(x, 19) ^ ((x) >> 10))
+#define SHA_LOAD32(p) ((uint32_t)(p)[0] << 24 | (uint32_t)(p)[1] << 16 | \
+	(uint32_t)(p)[2] << 8 | (uint32_t)(p)[3])
+/* Big-endian word loaded as a native one, back to its value */
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define SHA_BE32(x) (x)
+#define SHA_BE64(x) (x)
+#else
+#define SHA_BE32(x) __builtin_bswap32(x)
+#define SHA_BE64(x) __builtin_bswap64(x)
+#endif
+
+/* Widest multi-buffer SHA-256 kernel (AVX-512, 16 x 32-bit lanes) */
+#define SHA256_MB_MAX_LANES 16
+
+/* First message word holding the nonce (byte offset 16 of block_info_t) */
+#define MINE_NONCE_WORD 4
+
 
 /* Structs */
 
+/**
+ * struct chain_tx_slot_s - Slot of the transaction table of a chain store
+ *
+ * @tx:     Transaction, NULL for an empty slot
+ * @height: Height of the block holding @tx
+ * @pos:    Position of @tx in the transactions of its block
+ */
+typedef struct chain_tx_slot_s
+{
+	transaction_t   *tx;
+	uint32_t    height;
+	uint32_t    pos;
+} chain_tx_slot_t;
+
+/**
+ * struct chain_store_s - Blocks of a chain in an array, by height
+ *
+ * @blocks:      Blocks, the genesis block first
+ * @count:       Number of blocks in @blocks
+ * @capacity:    Number of blocks @blocks has room for
+ * @slots:       Hash table of the blocks by hash, 2 * @capacity heights
+ *               plus one, 0 for an empty slot
+ * @txs:         Hash table of the transactions of the blocks by ID, NULL
+ *               until blockchain_index_txs() is called
+ * @tx_count:    Number of transactions in @txs
+ * @tx_capacity: Number of slots of @txs, a power of two
+ * @edits:       Edit count of the chain the store was last in step with
+ */
+typedef struct chain_store_s
+{
+	struct block_s  **blocks;
+	uint32_t    count;
+	uint32_t    capacity;
+	uint32_t    *slots;
+	chain_tx_slot_t *txs;
+	uint32_t    tx_count;
+	uint32_t    tx_capacity;
+	uint32_t    edits;
+} chain_store_t;
+
 /**
  * struct blockchain_s - Blockchain structure
  *
  * @chain:   Linked list of Blocks
  * @unspent: Linked list of unspent transaction outputs
+ * @store:   Same blocks as @chain by height, kept in step with it by
+ *           the functions adding blocks; after changing @chain
+ *           otherwise, chain_store_sync() fills it again
+ * @edits:   Number of changes made to @chain. Code changing @chain, or the
+ *           hash of a block in it, other than through blockchain_add_block()
+ *           increments it, and @store is not read until it is synced again
  */
 typedef struct blockchain_s
 {
 	llist_t     *chain;
 	llist_t     *unspent;
+	chain_store_t   store;
+	uint32_t    edits;
 } blockchain_t;
 
 /**
@@ -94,8 +205,13 @@ typedef struct block_info_s
  *
  * @info:         Block info
  * @data:         Block data
- * @transactions: List of transactions
+ * @transactions: List of transactions, NULL while @lazy is set: on a chain
+ *                from blockchain_load_headers() read it through
+ *                chain_lazy_txs(), never directly
  * @hash:         256-bit digest of the Block, to ensure authenticity
+ * @lazy:         Lazy chain to decode @transactions from, NULL once they
+ *                are loaded; block_hash() and the validators refuse a
+ *                block while it is set
  */
 typedef struct block_s
 {
@@ -103,8 +219,430 @@ typedef struct block_s
 	block_data_t    data; /* This must stay second */
 	llist_t     *transactions;
 	uint8_t     hash[SHA256_DIGEST_LENGTH];
+	struct chain_lazy_s *lazy;
 } block_t;
 
+/**
+ * struct difficulty_mask_s - Difficulty as the hash bits that must be zero
+ *
+ * @full: Number of leading big-endian 64-bit hash words that must be zero
+ * @mask: Bits of the next word that must be zero; when @full is 4 there
+ *        is no next word and a non-zero @mask means nothing can match
+ */
+typedef struct difficulty_mask_s
+{
+	uint32_t    full;
+	uint64_t    mask;
+} difficulty_mask_t;
+
+/**
+ * struct sha256_mb_kernel_s - Multi-buffer SHA-256 compression kernel
+ *
+ * @name:      Instruction set the kernel is built for
+ * @lanes:     Number of messages the kernel compresses at once
+ * @fast:      1 if hashing @lanes messages at once takes less time than
+ *             hashing them one by one with OpenSSL's SHA256(), so that
+ *             sha256_mb_kernel() may pick it; measured, not derived
+ * @supported: Returns 1 if the CPU can run the kernel
+ * @compress:  Compresses one chunk per lane, given as interleaved message
+ *             words (word t of lane l at words[t * lanes + l]); the state
+ *             of lane l is st[l], st[lanes + l], ..., st[7 * lanes + l]
+ * @compress_wk: Compresses one chunk whose W + K schedule is shared by
+ *             every lane
+ */
+typedef struct sha256_mb_kernel_s
+{
+	char const  *name;
+	size_t      lanes;
+	int     fast;
+	int     (*supported)(void);
+	void    (*compress)(uint32_t *st, uint32_t const *words);
+	void    (*compress_wk)(uint32_t *st, uint32_t const wk[64]);
+} sha256_mb_kernel_t;
+
+/**
+ * struct crc32c_kernel_s - CRC-32C kernel
+ *
+ * @name:      Instruction set the kernel is built for
+ * @supported: Returns 1 if the CPU can run the kernel
+ * @update:    Adds bytes to a CRC, starting from 0
+ */
+typedef struct crc32c_kernel_s
+{
+	char const  *name;
+	int     (*supported)(void);
+	uint32_t    (*update)(uint32_t crc, uint8_t const *buf, size_t len);
+} crc32c_kernel_t;
+
+/**
+ * struct sha256_mb_order_s - Message of a multi-buffer batch, for sorting
+ *
+ * @len: Length of the message
+ * @idx: Index of the message in the batch
+ */
+typedef struct sha256_mb_order_s
+{
+	size_t      len;
+	size_t      idx;
+} sha256_mb_order_t;
+
+/**
+ * struct mine_ctx_s - Nonce independent data of a block being mined, no
+ * SHA-256 midstate since the nonce sits in the first chunk
+ *
+ * @preimage: SHA-256 padded preimage of the block
+ * @len:      Length of the preimage without the padding
+ * @nchunks:  Number of 64-byte chunks in the padded preimage
+ * @kernel:   Multi-buffer kernel testing several nonces per call, NULL to
+ *            hash one nonce at a time with OpenSSL
+ * @lanes:    Number of nonces tested per mine_ctx_batch() call
+ * @w:        Message words of the first chunk for a zero nonce, only read
+ *            by multi-buffer kernels
+ * @wk:       W + K schedules of the chunks after the first one, only read
+ *            by multi-buffer kernels
+ */
+typedef struct mine_ctx_s
+{
+	uint8_t     *preimage;
+	size_t      len;
+	size_t      nchunks;
+	sha256_mb_kernel_t const    *kernel;
+	size_t      lanes;
+	uint32_t    w[16];
+	uint32_t    (*wk)[64];
+} mine_ctx_t;
+
+/**
+ * struct mine_shared_s - State shared by the block_mine_parallel() workers
+ *
+ * @block:    Block being mined, read only while the workers run
+ * @ctx:      Mining context of @block
+ * @nthreads: Number of workers, each one tests every @nthreads th batch
+ *            of @ctx->lanes nonces
+ * @best:     Lowest winning nonce offset found so far, UINT64_MAX if none
+ */
+typedef struct mine_shared_s
+{
+	block_t const   *block;
+	mine_ctx_t const    *ctx;
+	uint64_t    nthreads;
+	uint64_t    best;
+} mine_shared_t;
+
+/**
+ * struct mine_worker_s - Per thread block_mine_parallel() state
+ *
+ * @thread: Thread running the worker
+ * @id:     Worker index, also the index of its first nonce batch
+ * @shared: State shared by all the workers
+ */
+typedef struct mine_worker_s
+{
+	pthread_t   thread;
+	uint64_t    id;
+	mine_shared_t   *shared;
+} mine_worker_t;
+
+/**
+ * struct block_index_entry_s - Block of a block index, sorted by hash
+ *
+ * @hash:   Block hash
+ * @height: Index of the block in the chain
+ */
+typedef struct block_index_entry_s
+{
+	uint8_t     hash[SHA256_DIGEST_LENGTH];
+	uint32_t    height;
+} block_index_entry_t;
+
+/**
+ * struct tx_index_entry_s - Transaction of a transaction index sidecar,
+ * sorted by ID
+ *
+ * @id:     Transaction ID
+ * @height: Height of the block holding the transaction
+ * @pos:    Position of the transaction in its block
+ */
+typedef struct tx_index_entry_s
+{
+	uint8_t     id[SHA256_DIGEST_LENGTH];
+	uint32_t    height;
+	uint32_t    pos;
+} tx_index_entry_t;
+
+/**
+ * struct chain_tx_ctx_s - Block whose transactions go in a chain store
+ *
+ * @store:  Store
+ * @height: Height of the block
+ */
+typedef struct chain_tx_ctx_s
+{
+	chain_store_t   *store;
+	uint32_t    height;
+} chain_tx_ctx_t;
+
+/**
+ * struct chain_tx_find_s - Transaction looked for by a walk of a chain
+ *
+ * @id:     ID looked for
+ * @tx:     Transaction found, NULL until then
+ * @height: Height of the block being walked, then of the one holding @tx
+ * @pos:    Position of @tx in its block
+ */
+typedef struct chain_tx_find_s
+{
+	uint8_t const   *id;
+	transaction_t   *tx;
+	uint32_t    height;
+	uint32_t    pos;
+} chain_tx_find_t;
+
+/**
+ * struct block_index_s - Offsets of the blocks of a chain file
+ *
+ * @offsets:  File offset of each block, plus one past the last block
+ * @by_hash:  Hash and height of each block
+ * @crcs:     CRC-32C of each block record with its transactions
+ * @count:    Number of blocks
+ * @capacity: Number of blocks the arrays have room for
+ */
+typedef struct block_index_s
+{
+	uint64_t    *offsets;
+	block_index_entry_t *by_hash;
+	uint32_t    *crcs;
+	uint32_t    count;
+	uint32_t    capacity;
+} block_index_t;
+
+/**
+ * struct serial_buf_s - Staging buffer of blockchain_serialize()
+ *
+ * @fd:      File written to
+ * @buf:     Staged bytes, SERIAL_BUF_SIZE of them at most
+ * @len:     Number of staged bytes
+ * @error:   Set once a write failed, nothing more is staged after that
+ * @written: Number of bytes already written out
+ * @index:   When not NULL, the offset and CRC of each block written is
+ *           added to it
+ * @crc:     CRC-32C of the bytes of the current block already checksummed
+ * @crc_from: Offset in @buf of the first staged byte not checksummed yet
+ */
+typedef struct serial_buf_s
+{
+	int     fd;
+	uint8_t *buf;
+	size_t  len;
+	int     error;
+	size_t  written;
+	block_index_t   *index;
+	uint32_t    crc;
+	size_t  crc_from;
+} serial_buf_t;
+
+/**
+ * struct compact_writer_s - Writer of the compact chain format
+ *
+ * @sb:    Staging buffer
+ * @group: Curve of the public keys
+ * @point: Scratch point for the key compression
+ * @ctx:   Scratch big numbers
+ */
+typedef struct compact_writer_s
+{
+	serial_buf_t    sb;
+	EC_GROUP    *group;
+	EC_POINT    *point;
+	BN_CTX      *ctx;
+} compact_writer_t;
+
+/**
+ * struct compact_reader_s - Reader of the compact chain format
+ *
+ * @p:     Next byte to read
+ * @left:  Number of bytes left to read
+ * @error: Set once a read ran past the end or hit a bad value
+ * @group: Curve of the public keys
+ * @point: Scratch point for the key decompression
+ * @ctx:   Scratch big numbers
+ */
+typedef struct compact_reader_s
+{
+	uint8_t const   *p;
+	size_t      left;
+	int     error;
+	EC_GROUP    *group;
+	EC_POINT    *point;
+	BN_CTX      *ctx;
+} compact_reader_t;
+
+/**
+ * struct chain_reader_s - Reader going through a chain file block by block
+ *
+ * @fd:       Open chain file
+ * @buf:      Decode buffer, holding at least the current record
+ * @capacity: Size of @buf, grows to the largest block read
+ * @start:    Offset in @buf of the next record
+ * @end:      Offset in @buf past the last byte read
+ * @left:     Number of bytes of the file not read into @buf yet
+ * @nblocks:  Number of blocks in the file
+ * @nunspent: Number of unspent outputs in the file
+ * @read:     Number of blocks, then unspent outputs, already yielded
+ * @block:    Last block yielded, freed by the next call
+ * @unspent:  Last unspent output yielded
+ * @error:    Set once the file turned out truncated or unreadable
+ */
+typedef struct chain_reader_s
+{
+	int     fd;
+	uint8_t     *buf;
+	size_t      capacity;
+	size_t      start;
+	size_t      end;
+	size_t      left;
+	uint32_t    nblocks;
+	uint32_t    nunspent;
+	size_t      read;
+	block_t     *block;
+	uto_t       unspent;
+	int     error;
+} chain_reader_t;
+
+/**
+ * struct chain_log_s - Chain file blocks are appended to one at a time
+ *
+ * @sb:      Staging buffer, writing to the open file
+ * @nblocks: Number of blocks in the file
+ * @size:    Offset right past the last block, where the next one goes
+ */
+typedef struct chain_log_s
+{
+	serial_buf_t    sb;
+	uint32_t    nblocks;
+	size_t      size;
+} chain_log_t;
+
+/**
+ * struct chain_map_s - Serialized blockchain mapped in memory
+ *
+ * @base:     Start of the mapping
+ * @size:     Size of the mapping
+ * @nblocks:  Number of blocks
+ * @nunspent: Number of unspent outputs
+ * @blocks:   Offset of each block record
+ * @first_tx: Index in @txs of the first transaction of each block, with
+ *            one more entry holding @ntxs
+ * @txs:      Offset of each transaction record, across all the blocks
+ * @ntxs:     Number of transactions
+ * @txs_capacity: Number of offsets @txs has room for
+ * @unspent:  Offset of the first unspent output record
+ */
+typedef struct chain_map_s
+{
+	uint8_t const   *base;
+	size_t      size;
+	uint32_t    nblocks;
+	uint32_t    nunspent;
+	size_t      *blocks;
+	size_t      *first_tx;
+	size_t      *txs;
+	size_t      ntxs;
+	size_t      txs_capacity;
+	size_t      unspent;
+} chain_map_t;
+
+/**
+ * struct block_view_s - Read only view of a mapped block
+ *
+ * @info:     Block info, copied out since the record isn't aligned
+ * @data_len: Length of the block data
+ * @data:     Block data, in the mapping
+ * @hash:     Block hash, in the mapping
+ * @ntxs:     Number of transactions, -1 if the block has no list of them
+ * @first_tx: Index of the first transaction, for chain_map_tx_view()
+ */
+typedef struct block_view_s
+{
+	block_info_t    info;
+	uint32_t    data_len;
+	uint8_t const   *data;
+	uint8_t const   *hash;
+	int32_t     ntxs;
+	size_t      first_tx;
+} block_view_t;
+
+/**
+ * struct tx_view_s - Read only view of a mapped transaction
+ *
+ * @id:    Transaction ID, in the mapping
+ * @nins:  Number of inputs
+ * @nouts: Number of outputs
+ * @ins:   First of @nins input records of HBLK_IN_SIZE bytes
+ * @outs:  First of @nouts output records of HBLK_OUT_SIZE bytes
+ */
+typedef struct tx_view_s
+{
+	uint8_t const   *id;
+	uint32_t    nins;
+	uint32_t    nouts;
+	uint8_t const   *ins;
+	uint8_t const   *outs;
+} tx_view_t;
+
+/**
+ * struct chain_lazy_s - Chain loaded header first, its transactions
+ * decoded on first access
+ *
+ * @map:        Chain file, mapped for as long as the chain is loaded
+ * @blockchain: Chain, every block without its transactions at first
+ * @blocks:     Blocks of @blockchain, by height
+ */
+typedef struct chain_lazy_s
+{
+	chain_map_t *map;
+	blockchain_t    *blockchain;
+	block_t     **blocks;
+} chain_lazy_t;
+
+/**
+ * struct chain_verify_s - Background check of the block hashes of a chain
+ *
+ * @thread:     Thread running the check
+ * @blockchain: Chain checked, not to be changed until chain_verify_wait()
+ * @bad:        Height of the first block whose hash is wrong, -1 if none
+ * @failed:     Set if a hash was wrong, or if the check couldn't run
+ * @started:    Set if the thread was started
+ */
+typedef struct chain_verify_s
+{
+	pthread_t   thread;
+	blockchain_t const  *blockchain;
+	int64_t     bad;
+	int     failed;
+	int     started;
+} chain_verify_t;
+
+/**
+ * struct decode_worker_s - Per thread state of a parallel chain load
+ *
+ * @thread: Thread running the worker
+ * @map:    Mapped chain to decode
+ * @blocks: Decoded blocks, indexed by height, shared by all the workers
+ * @first:  First block the worker decodes
+ * @end:    Block right past the last one the worker decodes
+ * @error:  Set if a block of the range couldn't be decoded
+ */
+typedef struct decode_worker_s
+{
+	pthread_t   thread;
+	chain_map_t const   *map;
+	block_t     **blocks;
+	uint32_t    first;
+	uint32_t    end;
+	int     error;
+} decode_worker_t;
+
 /* Prototypes */
 
 blockchain_t *blockchain_create(void);
@@ -114,14 +652,204 @@ void block_destroy(block_t *block);
 void blockchain_destroy(blockchain_t *blockchain);
 uint8_t *block_hash(block_t const *block,
 					uint8_t hash_buf[SHA256_DIGEST_LENGTH]);
+int tx_id_cpy(llist_node_t tx, unsigned int iter, void *buffer);
+int tx_id_update(llist_node_t tx, unsigned int iter, void *ctx);
 int blockchain_serialize(blockchain_t const *blockchain, char const *path);
+int write_blocks(block_t *block, unsigned int index, serial_buf_t *sb);
+int write_unspent(uto_t *unspent, unsigned int index, serial_buf_t *sb);
+uint8_t *serial_reserve(serial_buf_t *sb, size_t len);
+int serial_flush(serial_buf_t *sb);
+chain_map_t *chain_map_open(char const *path);
+int chain_map_file(chain_map_t *map, char const *path);
+void chain_map_close(chain_map_t *map);
+int chain_map_index(chain_map_t *map);
+int chain_map_block_view(chain_map_t const *map, uint32_t i,
+	block_view_t *view);
+int chain_map_tx_view(chain_map_t const *map, size_t i, tx_view_t *view);
+block_t *chain_map_block(chain_map_t const *map, uint32_t i);
+block_t *chain_map_header(chain_map_t const *map, uint32_t i,
+	block_view_t *view);
+llist_t *chain_map_block_txs(chain_map_t const *map, block_view_t const *view);
+transaction_t *chain_map_tx(chain_map_t const *map, size_t i);
+transaction_t *hblk_tx_decode(tx_view_t const *view);
+size_t hblk_flat_tx_size(flat_tx_t const *flat);
+size_t hblk_flat_tx_encode(flat_tx_t const *flat, uint8_t *record);
+flat_tx_t *hblk_flat_tx_decode(tx_view_t const *view);
+size_t hblk_tx_view(uint8_t const *record, size_t size, tx_view_t *view);
+uto_t *chain_map_unspent(chain_map_t const *map, uint32_t i);
+blockchain_t *chain_map_blockchain(chain_map_t const *map);
+blockchain_t *chain_map_blockchain_parallel(chain_map_t const *map,
+	unsigned int nthreads);
+blockchain_t *blockchain_deserialize_parallel(char const *path,
+	unsigned int nthreads);
+int chain_store_sync(blockchain_t *blockchain);
+int chain_store_fresh(blockchain_t const *blockchain);
+int chain_store_push(chain_store_t *store, block_t *block);
+void chain_store_index(chain_store_t *store, uint32_t height);
+uint32_t chain_store_slot(chain_store_t const *store,
+	uint8_t const hash[SHA256_DIGEST_LENGTH]);
+block_t *blockchain_find_block(blockchain_t const *blockchain,
+	uint8_t const hash[SHA256_DIGEST_LENGTH]);
+int chain_block_has_hash(llist_node_t block, void *hash);
+int blockchain_index_txs(blockchain_t *blockchain);
+int chain_store_index_txs(chain_store_t *store, uint32_t height);
+int chain_tx_add(llist_node_t tx, unsigned int pos, void *ctx);
+int chain_tx_find_block(llist_node_t block, unsigned int height, void *find);
+int chain_tx_find_tx(llist_node_t tx, unsigned int pos, void *find);
+int chain_tx_grow(chain_store_t *store, uint32_t capacity);
+uint32_t chain_tx_slot(chain_store_t const *store,
+	uint8_t const id[SHA256_DIGEST_LENGTH]);
+transaction_t *blockchain_find_tx(blockchain_t const *blockchain,
+	uint8_t const id[SHA256_DIGEST_LENGTH], uint32_t *height,
+	uint32_t *pos);
+int tx_index_save(blockchain_t *blockchain, char const *path);
+int tx_index_rebuild(char const *path);
+block_t *blockchain_load_block_by_tx(char const *path,
+	uint8_t const id[SHA256_DIGEST_LENGTH], uint32_t *pos);
+int chain_store_for_each(blockchain_t const *blockchain, node_func_t action,
+	void *arg);
+block_t *blockchain_block_at(blockchain_t const *blockchain,
+	uint32_t height);
+block_t *blockchain_tip(blockchain_t const *blockchain);
+int blockchain_add_block(blockchain_t *blockchain, block_t *block);
+chain_lazy_t *blockchain_load_headers(char const *path);
+llist_t *chain_lazy_txs(chain_lazy_t *lazy, block_t *block);
+int chain_lazy_peek(block_t const *block, block_t *copy);
+int chain_lazy_height(chain_lazy_t const *lazy, block_t const *block);
+void chain_lazy_close(chain_lazy_t *lazy);
+int utxo_snapshot_save(utxo_set_t const *set, block_t const *tip,
+	uint32_t height, char const *path);
+utxo_set_t *utxo_snapshot_load(char const *path, uint32_t *height,
+	uint8_t tip[SHA256_DIGEST_LENGTH]);
+utxo_set_t *utxo_snapshot_sync(char const *path, blockchain_t *blockchain,
+	uint32_t *replayed);
+uint32_t crc32c(uint32_t crc, void const *buf, size_t len);
+crc32c_kernel_t const *crc32c_kernel(void);
+extern crc32c_kernel_t const crc32c_kernels[];
+int crc32c_sse42_supported(void);
+uint32_t crc32c_sse42(uint32_t crc, uint8_t const *buf, size_t len);
+int crc32c_armv8_supported(void);
+uint32_t crc32c_armv8(uint32_t crc, uint8_t const *buf, size_t len);
+void serial_crc_close(serial_buf_t *sb);
+uint32_t *block_index_crcs(int fd, uint32_t nblocks);
+blockchain_t *blockchain_load_trusted(char const *path,
+	chain_verify_t *verify);
+int chain_verify_wait(chain_verify_t *verify);
+void *chain_verify_worker(void *arg);
+int chain_verify_range(blockchain_t const *blockchain, int64_t *bad);
+int decode_workers_run(decode_worker_t *workers, unsigned int nthreads);
+void *decode_worker(void *arg);
+void hblk_in_decode(uint8_t const *record, ti_t *in);
+void hblk_out_decode(uint8_t const *record, to_t *out);
+chain_log_t *chain_log_open(char const *path);
+void chain_log_close(chain_log_t *log);
+int chain_log_append(chain_log_t *log, block_t const *block);
+int chain_log_sync(chain_log_t *log, blockchain_t const *blockchain);
+int unspent_save(llist_t *unspent, char const *path);
+blockchain_t *chain_log_load(char const *log_path, char const *unspent_path);
+int block_index_add(block_index_t *index, uint64_t offset,
+	uint8_t const hash[SHA256_DIGEST_LENGTH]);
+void block_index_free(block_index_t *index);
+int block_index_save(block_index_t const *index, char const *path,
+	uint64_t blocks_end, uint64_t chain_size, uint32_t flags);
+int block_index_open(char const *path, uint32_t *nblocks, int rebuild);
+int block_index_tip_ok(int chain, int fd, uint32_t nblocks,
+	uint8_t const tip[SHA256_DIGEST_LENGTH]);
+block_t *block_index_read(char const *path, int fd, uint32_t height);
+int block_index_rebuild(char const *path);
+int block_index_map_save(chain_map_t const *map, char const *path,
+	uint32_t flags);
+char *block_index_path(char const *path);
+block_t *blockchain_load_block(char const *path, uint32_t index);
+block_t *blockchain_load_block_by_hash(char const *path,
+	uint8_t const hash[SHA256_DIGEST_LENGTH]);
+block_t *hblk_block_decode(uint8_t const *record, size_t size);
+int blockchain_serialize_compact(blockchain_t const *blockchain,
+	char const *path);
+blockchain_t *blockchain_deserialize_compact(char const *path);
+int blockchain_convert(char const *from, char const *to, int compact);
+void compact_put_varint(serial_buf_t *sb, uint64_t value);
+void compact_put_pub(compact_writer_t *cw, uint8_t const pub[EC_PUB_LEN],
+	uint8_t flags);
+int compact_write_block(block_t *block, unsigned int index,
+	compact_writer_t *cw);
+int compact_write_unspent(uto_t *unspent, unsigned int index,
+	compact_writer_t *cw);
+uint64_t compact_get_varint(compact_reader_t *cr);
+void compact_get(compact_reader_t *cr, void *dst, size_t len);
+uint8_t compact_get_pub(compact_reader_t *cr, uint8_t pub[EC_PUB_LEN]);
+void compact_get_out(compact_reader_t *cr, to_t *out);
+block_t *compact_read_block(compact_reader_t *cr);
+transaction_t *compact_read_tx(compact_reader_t *cr);
+chain_reader_t *chain_reader_open(char const *path);
+void chain_reader_close(chain_reader_t *reader);
+int chain_reader_fill(chain_reader_t *reader, size_t len);
+block_t const *chain_reader_next_block(chain_reader_t *reader);
+uto_t const *chain_reader_next_unspent(chain_reader_t *reader);
+size_t chain_reader_block_size(chain_reader_t *reader);
 blockchain_t *blockchain_deserialize(char const *path);
 int block_is_valid(
 	block_t const *block, block_t const *prev_block, llist_t *all_unspent);
+int block_is_valid_set(
+	block_t const *block, block_t const *prev_block, utxo_set_t *all_unspent);
+int block_is_valid_set_parallel(block_t const *block,
+	block_t const *prev_block, utxo_set_t *all_unspent, unsigned int nthreads);
+int block_is_valid_parallel(block_t const *block, block_t const *prev_block,
+	llist_t *all_unspent, unsigned int nthreads);
+int block_txs_are_valid(block_t const *block, utxo_set_t *all_unspent,
+	unsigned int nthreads);
 
 int hash_matches_difficulty(uint8_t const hash[SHA256_DIGEST_LENGTH],
 							uint32_t difficulty);
+uint32_t hash_leading_zeros(uint8_t const hash[SHA256_DIGEST_LENGTH]);
+void difficulty_mask_init(difficulty_mask_t *mask, uint32_t difficulty);
+int hash_matches_mask(uint8_t const hash[SHA256_DIGEST_LENGTH],
+	difficulty_mask_t const *mask);
 void block_mine(block_t *block);
+void block_mine_parallel(block_t *block, unsigned int nthreads);
 uint32_t blockchain_difficulty(blockchain_t const *blockchain);
 
+extern uint32_t const sha256_k[64];
+extern uint32_t const sha256_iv[8];
+void sha256_expand(uint32_t w[64], int from);
+void sha256_add_k(uint32_t wk[64], uint32_t const w[64], int from);
+void sha256_rounds(uint32_t v[8], uint32_t const wk[64], int from, int to);
+void sha256_load_chunk(uint32_t w[64], uint8_t const *chunk);
+void sha256_store_digest(uint32_t const state[8],
+	uint8_t digest[SHA256_DIGEST_LENGTH]);
+
+extern sha256_mb_kernel_t const sha256_mb_kernels[];
+sha256_mb_kernel_t const *sha256_mb_kernel(void);
+void sha256_mb(uint8_t const *const msgs[], size_t const lens[], size_t n,
+	uint8_t (*digests)[SHA256_DIGEST_LENGTH]);
+void sha256_mb_with(sha256_mb_kernel_t const *kernel,
+	uint8_t const *const msgs[], size_t const lens[], size_t n,
+	uint8_t (*digests)[SHA256_DIGEST_LENGTH]);
+void sha256_mb_init(uint32_t *st, size_t lanes);
+void sha256_mb_load(uint32_t *words, uint8_t const *const *chunks,
+	size_t lanes);
+void sha256_mb_lane_copy(uint32_t *dst, uint32_t const *src, size_t lanes,
+	size_t lane);
+void sha256_mb_digest(uint32_t const *st, size_t lanes, size_t lane,
+	uint8_t digest[SHA256_DIGEST_LENGTH]);
+int sha256_mb2_ni_supported(void);
+void sha256_mb2_ni(uint32_t *st, uint32_t const *words);
+void sha256_mb2_ni_wk(uint32_t *st, uint32_t const wk[64]);
+int sha256_mb4_sse4_supported(void);
+void sha256_mb4_sse4(uint32_t *st, uint32_t const *words);
+void sha256_mb4_sse4_wk(uint32_t *st, uint32_t const wk[64]);
+int sha256_mb8_avx2_supported(void);
+void sha256_mb8_avx2(uint32_t *st, uint32_t const *words);
+void sha256_mb8_avx2_wk(uint32_t *st, uint32_t const wk[64]);
+int sha256_mb16_avx512_supported(void);
+void sha256_mb16_avx512(uint32_t *st, uint32_t const *words);
+void sha256_mb16_avx512_wk(uint32_t *st, uint32_t const wk[64]);
+
+int mine_ctx_init(mine_ctx_t *ctx, block_t const *block);
+uint8_t *mine_ctx_hash(mine_ctx_t const *ctx, uint64_t nonce,
+	uint8_t hash_buf[SHA256_DIGEST_LENGTH]);
+size_t mine_ctx_batch(mine_ctx_t const *ctx, uint64_t nonce,
+	uint8_t (*digests)[SHA256_DIGEST_LENGTH]);
+void mine_ctx_free(mine_ctx_t *ctx);
+
 #endif
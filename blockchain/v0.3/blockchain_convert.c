@@ -0,0 +1,26 @@
+#include "blockchain.h"
+
+/**
+ * blockchain_convert - rewrites a chain file in the other format
+ * @from: chain file, in either format
+ * @to: file to write
+ * @compact: 1 to write the compact format, 0 for the v0.3 one
+ * Return: 1 on success, 0 on fail
+ */
+int blockchain_convert(char const *from, char const *to, int compact)
+{
+	blockchain_t *blockchain = blockchain_deserialize(from);
+	int ret;
+
+	if (!blockchain || !to)
+	{
+		blockchain_destroy(blockchain);
+		return (0);
+	}
+	if (compact)
+		ret = blockchain_serialize_compact(blockchain, to);
+	else
+		ret = blockchain_serialize(blockchain, to);
+	blockchain_destroy(blockchain);
+	return (ret);
+}
@@ -26,5 +26,6 @@ blockchain_t *blockchain_create(void)
 
 	if (llist_add_node(new_chain->chain, new_block, ADD_NODE_REAR) == -1)
 		return (llist_destroy(new_chain->chain, 0, NULL), free(new_chain), NULL);
+	chain_store_sync(new_chain);
 	return (new_chain);
 }
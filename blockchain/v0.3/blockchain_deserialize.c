@@ -9,6 +9,10 @@ int read_unspent(FILE *fptr, blockchain_t *chain, uint32_t unspent_num);
  * blockchain_deserialize - Loads a blockchain from file
  * @path: file to read from
  * Return: Pointer to chain or NULL
+ *
+ * Description: Files in the compact format, see
+ * blockchain_serialize_compact(), are handed to
+ * blockchain_deserialize_compact().
  */
 blockchain_t *blockchain_deserialize(char const *path)
 {
@@ -26,7 +30,13 @@ blockchain_t *blockchain_deserialize(char const *path)
 		return (NULL);
 	fread(header_buf, 1, 7, fptr);
 	if (memcmp(header_buf, FHEADER, 7))
+	{
+		fclose(fptr);
+		free(blockchain);
+		if (!memcmp(header_buf, FHEADER_COMPACT, 7))
+			return (blockchain_deserialize_compact(path));
 		return (NULL);
+	}
 	fread(&end, 1, 1, fptr);
 	fread(&numblocks, 4, 1, fptr);
 	fread(&unspent_num, 4, 1, fptr);
@@ -49,6 +59,7 @@ blockchain_t *blockchain_deserialize(char const *path)
 	}
 	read_unspent(fptr, blockchain, unspent_num);
 	fclose(fptr);
+	chain_store_sync(blockchain);
 	return (blockchain);
 }
 
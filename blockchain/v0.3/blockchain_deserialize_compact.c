@@ -0,0 +1,224 @@
+#include "blockchain.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+
+int compact_read_chain(compact_reader_t *cr, blockchain_t *blockchain);
+uto_t *compact_read_unspent(compact_reader_t *cr);
+
+/**
+ * blockchain_deserialize_compact - loads a blockchain saved in the compact
+ * format
+ * @path: file to read from
+ * Return: pointer to chain or NULL
+ */
+blockchain_t *blockchain_deserialize_compact(char const *path)
+{
+	compact_reader_t cr = {NULL, 0, 0, NULL, NULL, NULL};
+	blockchain_t *blockchain = NULL;
+	struct stat st;
+	void *base = MAP_FAILED;
+	int fd;
+
+	fd = path ? open(path, O_RDONLY) : -1;
+	if (fd == -1)
+		return (NULL);
+	if (!fstat(fd, &st) && st.st_size >= 8)
+		base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED)
+		return (NULL);
+	cr.p = base;
+	cr.left = st.st_size;
+	cr.group = EC_GROUP_new_by_curve_name(EC_CURVE);
+	cr.point = cr.group ? EC_POINT_new(cr.group) : NULL;
+	cr.ctx = BN_CTX_new();
+	blockchain = calloc(1, sizeof(*blockchain));
+	if (blockchain && cr.point && cr.ctx &&
+		!memcmp(cr.p, FHEADER_COMPACT, 7) && cr.p[7] == (uint8_t)END[0])
+	{
+		cr.p += 8;
+		cr.left -= 8;
+		if (compact_read_chain(&cr, blockchain))
+		{
+			blockchain_destroy(blockchain);
+			blockchain = NULL;
+		}
+		else
+			chain_store_sync(blockchain);
+	}
+	else
+	{
+		free(blockchain);
+		blockchain = NULL;
+	}
+	munmap(base, st.st_size);
+	EC_POINT_free(cr.point);
+	EC_GROUP_free(cr.group);
+	BN_CTX_free(cr.ctx);
+	return (blockchain);
+}
+
+/**
+ * compact_read_chain - reads the blocks and unspent outputs of a chain
+ * @cr: compact reader, right past the header
+ * @blockchain: zeroed chain to fill in
+ * Return: 0 on success, 1 on fail
+ */
+int compact_read_chain(compact_reader_t *cr, blockchain_t *blockchain)
+{
+	uint64_t nblocks, nunspent, i;
+	void *node;
+
+	blockchain->chain = llist_create(MT_SUPPORT_FALSE);
+	blockchain->unspent = llist_create(MT_SUPPORT_FALSE);
+	nblocks = compact_get_varint(cr);
+	nunspent = compact_get_varint(cr);
+	if (!blockchain->chain || !blockchain->unspent)
+		return (1);
+	for (i = 0; !cr->error && i < nblocks; i++)
+	{
+		node = compact_read_block(cr);
+		if (!node || llist_add_node(blockchain->chain, node, ADD_NODE_REAR))
+		{
+			block_destroy(node);
+			return (1);
+		}
+	}
+	for (i = 0; !cr->error && i < nunspent; i++)
+	{
+		node = compact_read_unspent(cr);
+		if (!node || llist_add_node(blockchain->unspent, node, ADD_NODE_REAR))
+		{
+			free(node);
+			return (1);
+		}
+	}
+	return (cr->error);
+}
+
+/**
+ * compact_read_block - reads a block in the compact format
+ * @cr: compact reader
+ * Return: pointer to the block or NULL
+ */
+block_t *compact_read_block(compact_reader_t *cr)
+{
+	block_t *block = calloc(1, sizeof(*block));
+	transaction_t *tx;
+	uint64_t ntxs, i;
+	uint8_t flags = 0;
+
+	if (!block)
+		return (NULL);
+	compact_get(cr, &block->info, sizeof(block_info_t));
+	block->data.len = compact_get_varint(cr);
+	if (block->data.len > BLOCKCHAIN_DATA_MAX)
+		cr->error = 1;
+	compact_get(cr, block->data.buffer, block->data.len);
+	compact_get(cr, &flags, 1);
+	if (flags & COMPACT_HASH_STORED)
+		compact_get(cr, block->hash, SHA256_DIGEST_LENGTH);
+	ntxs = compact_get_varint(cr);
+	if (!cr->error && ntxs--)
+	{
+		block->transactions = llist_create(MT_SUPPORT_FALSE);
+		for (i = 0; block->transactions && !cr->error && i < ntxs; i++)
+		{
+			tx = compact_read_tx(cr);
+			if (!tx ||
+				llist_add_node(block->transactions, tx, ADD_NODE_REAR))
+			{
+				transaction_destroy(tx);
+				cr->error = 1;
+			}
+		}
+		if (!block->transactions)
+			cr->error = 1;
+	}
+	/* The hash covers the transaction IDs, it can only be computed now */
+	if (!cr->error && !(flags & COMPACT_HASH_STORED))
+		block_hash(block, block->hash);
+	if (!cr->error)
+		return (block);
+	block_destroy(block);
+	return (NULL);
+}
+
+/**
+ * compact_read_tx - reads a transaction in the compact format
+ * @cr: compact reader
+ * Return: pointer to the transaction or NULL
+ */
+transaction_t *compact_read_tx(compact_reader_t *cr)
+{
+	transaction_t *tx = calloc(1, sizeof(*tx));
+	uint64_t nins, nouts, i;
+	ti_t *in;
+	to_t *out;
+	uint8_t flags = 0;
+
+	if (!tx)
+		return (NULL);
+	compact_get(cr, &flags, 1);
+	if (flags & COMPACT_HASH_STORED)
+		compact_get(cr, tx->id, SHA256_DIGEST_LENGTH);
+	nins = compact_get_varint(cr);
+	nouts = compact_get_varint(cr);
+	tx->inputs = llist_create(MT_SUPPORT_FALSE);
+	tx->outputs = llist_create(MT_SUPPORT_FALSE);
+	if (!tx->inputs || !tx->outputs)
+		cr->error = 1;
+	for (i = 0; !cr->error && i < nins; i++)
+	{
+		in = calloc(1, sizeof(*in));
+		if (!in || llist_add_node(tx->inputs, in, ADD_NODE_REAR))
+		{
+			free(in);
+			cr->error = 1;
+			break;
+		}
+		compact_get(cr, in->block_hash, SHA256_DIGEST_LENGTH);
+		compact_get(cr, in->tx_id, SHA256_DIGEST_LENGTH);
+		compact_get(cr, in->tx_out_hash, SHA256_DIGEST_LENGTH);
+		in->sig.len = compact_get_varint(cr);
+		compact_get(cr, in->sig.sig,
+			in->sig.len < MAX_SIG_LEN ? in->sig.len : MAX_SIG_LEN);
+	}
+	for (i = 0; !cr->error && i < nouts; i++)
+	{
+		out = calloc(1, sizeof(*out));
+		if (!out || llist_add_node(tx->outputs, out, ADD_NODE_REAR))
+		{
+			free(out);
+			cr->error = 1;
+			break;
+		}
+		compact_get_out(cr, out);
+	}
+	if (!cr->error && !(flags & COMPACT_HASH_STORED))
+		transaction_hash(tx, tx->id);
+	if (!cr->error)
+		return (tx);
+	transaction_destroy(tx);
+	return (NULL);
+}
+
+/**
+ * compact_read_unspent - reads an unspent output in the compact format
+ * @cr: compact reader
+ * Return: pointer to the unspent output or NULL
+ */
+uto_t *compact_read_unspent(compact_reader_t *cr)
+{
+	uto_t *unspent = calloc(1, sizeof(*unspent));
+
+	if (!unspent)
+		return (NULL);
+	compact_get(cr, unspent->block_hash, SHA256_DIGEST_LENGTH);
+	compact_get(cr, unspent->tx_id, SHA256_DIGEST_LENGTH);
+	compact_get_out(cr, &unspent->out);
+	if (!cr->error)
+		return (unspent);
+	free(unspent);
+	return (NULL);
+}
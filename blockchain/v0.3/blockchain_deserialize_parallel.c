@@ -0,0 +1,171 @@
+#include "blockchain.h"
+
+int decode_stitch(chain_map_t const *map, block_t **blocks,
+	blockchain_t *blockchain);
+
+/**
+ * blockchain_deserialize_parallel - loads a serialized blockchain, decoding
+ * its blocks on several threads
+ * @path: file to read from
+ * @nthreads: number of threads, 0 for one per online CPU
+ * Return: pointer to chain or NULL, as blockchain_deserialize()
+ */
+blockchain_t *blockchain_deserialize_parallel(char const *path,
+	unsigned int nthreads)
+{
+	chain_map_t *map = chain_map_open(path);
+	blockchain_t *blockchain;
+
+	if (!map)
+		return (NULL);
+	blockchain = chain_map_blockchain_parallel(map, nthreads);
+	chain_map_close(map);
+	return (blockchain);
+}
+
+/**
+ * chain_map_blockchain_parallel - copies a mapped blockchain in memory,
+ * decoding its blocks on several threads
+ * @map: mapped blockchain
+ * @nthreads: number of threads, 0 for one per online CPU
+ * Return: pointer to chain or NULL, as chain_map_blockchain()
+ *
+ * Description: chain_map_open() already found where each block starts, so
+ * the chain is cut in ranges of about the same number of bytes, one per
+ * worker. The blocks land in an array by height, and are only linked into
+ * the chain in order once every worker is done.
+ */
+blockchain_t *chain_map_blockchain_parallel(chain_map_t const *map,
+	unsigned int nthreads)
+{
+	decode_worker_t *workers;
+	blockchain_t *blockchain = NULL;
+	block_t **blocks;
+	size_t bytes, done;
+	unsigned int t;
+	uint32_t i = 0;
+
+	if (!map)
+		return (NULL);
+	if (!nthreads)
+		nthreads = (unsigned int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (nthreads > map->nblocks)
+		nthreads = map->nblocks;
+	if (nthreads < 2)
+		return (chain_map_blockchain(map));
+	workers = calloc(nthreads, sizeof(*workers));
+	blocks = calloc(map->nblocks, sizeof(*blocks));
+	if (!workers || !blocks)
+		goto out;
+	bytes = map->unspent - map->blocks[0];
+	for (t = 0; t < nthreads; t++)
+	{
+		workers[t].map = map, workers[t].blocks = blocks;
+		workers[t].first = i;
+		done = bytes / nthreads * (t + 1);
+		while (i < map->nblocks &&
+			(t == nthreads - 1 || map->blocks[i] - map->blocks[0] < done))
+			i++;
+		workers[t].end = i;
+	}
+	if (!decode_workers_run(workers, nthreads))
+	{
+		blockchain = calloc(1, sizeof(*blockchain));
+		if (blockchain && decode_stitch(map, blocks, blockchain))
+		{
+			blockchain_destroy(blockchain);
+			blockchain = NULL;
+		}
+		else if (blockchain)
+			chain_store_sync(blockchain);
+	}
+	for (i = 0; !blockchain && i < map->nblocks; i++)
+		block_destroy(blocks[i]);
+out:
+	free(workers);
+	free(blocks);
+	return (blockchain);
+}
+
+/**
+ * decode_stitch - links decoded blocks into a chain, with the unspent outputs
+ * @map: mapped blockchain
+ * @blocks: decoded blocks, by height, taken over by the chain
+ * @blockchain: zeroed chain to fill in
+ * Return: 0 on success, 1 on fail, the blocks not linked are then NULL
+ */
+int decode_stitch(chain_map_t const *map, block_t **blocks,
+	blockchain_t *blockchain)
+{
+	uto_t *unspent;
+	uint32_t i;
+
+	blockchain->chain = llist_create(MT_SUPPORT_FALSE);
+	blockchain->unspent = llist_create(MT_SUPPORT_FALSE);
+	if (!blockchain->chain || !blockchain->unspent)
+		return (1);
+	for (i = 0; i < map->nblocks; i++)
+	{
+		if (llist_add_node(blockchain->chain, blocks[i], ADD_NODE_REAR))
+			return (1);
+		blocks[i] = NULL;
+	}
+	for (i = 0; i < map->nunspent; i++)
+	{
+		unspent = chain_map_unspent(map, i);
+		if (!unspent ||
+			llist_add_node(blockchain->unspent, unspent, ADD_NODE_REAR))
+		{
+			free(unspent);
+			return (1);
+		}
+	}
+	return (0);
+}
+
+/**
+ * decode_workers_run - starts the decoding workers and waits for them
+ * @workers: workers, with their ranges set
+ * @nthreads: number of workers
+ * Return: 0 if every block was decoded, 1 on fail
+ *
+ * Description: The calling thread decodes the first range itself.
+ */
+int decode_workers_run(decode_worker_t *workers, unsigned int nthreads)
+{
+	unsigned int t, started;
+	int error = 0;
+
+	for (started = 1; started < nthreads; started++)
+		if (pthread_create(&workers[started].thread, NULL, decode_worker,
+			&workers[started]))
+			break;
+	/* Whatever range didn't get a thread is decoded here */
+	for (t = started; t < nthreads; t++)
+		decode_worker(&workers[t]);
+	decode_worker(&workers[0]);
+	for (t = 1; t < started; t++)
+		pthread_join(workers[t].thread, NULL);
+	for (t = 0; t < nthreads; t++)
+		error |= workers[t].error;
+	return (error);
+}
+
+/**
+ * decode_worker - thread routine decoding one range of blocks
+ * @arg: pointer to the worker's decode_worker_t
+ * Return: NULL
+ */
+void *decode_worker(void *arg)
+{
+	decode_worker_t *worker = arg;
+	uint32_t i;
+
+	for (i = worker->first; !worker->error && i < worker->end; i++)
+	{
+		worker->blocks[i] = chain_map_block(worker->map, i);
+		if (!worker->blocks[i])
+			worker->error = 1;
+	}
+	return (NULL);
+}
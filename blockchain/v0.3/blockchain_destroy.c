@@ -10,5 +10,8 @@ void blockchain_destroy(blockchain_t *blockchain)
 		return;
 	llist_destroy(blockchain->unspent, 1, NULL);
 	llist_destroy(blockchain->chain, 1, (node_dtor_t)&block_destroy);
+	free(blockchain->store.blocks);
+	free(blockchain->store.slots);
+	free(blockchain->store.txs);
 	free(blockchain);
 }
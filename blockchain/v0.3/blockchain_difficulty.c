@@ -14,12 +14,16 @@ uint32_t blockchain_difficulty(blockchain_t const *blockchain)
 
 	if (!blockchain)
 		return (0);
-	block = llist_get_tail(blockchain->chain);
+	block = blockchain_tip(blockchain);
+	if (!block)
+		return (0);
 	if ((block->info.index % DIFFICULTY_ADJUSTMENT_INTERVAL == 0) &&
 		block->info.index != 0)
 	{
 		idx = (llist_size(blockchain->chain) - DIFFICULTY_ADJUSTMENT_INTERVAL);
-		adj_block = llist_get_node_at(blockchain->chain, idx);
+		adj_block = blockchain_block_at(blockchain, idx);
+		if (!adj_block)
+			return (0);
 		exp_time = EXPECTED(block, adj_block);
 		act_time = ACTUAL(block, adj_block);
 		if (act_time > exp_time << 1)
@@ -0,0 +1,141 @@
+#include "blockchain.h"
+
+int chain_verify_block(llist_node_t block, unsigned int height, void *bad);
+
+/**
+ * blockchain_load_trusted - loads a chain file checking only the CRC-32C
+ * of each block, and checks the block hashes in the background
+ * @path: chain file
+ * @verify: filled in with the background check, to pass to
+ * chain_verify_wait() before the chain is changed or freed
+ * Return: pointer to chain or NULL if a block failed its CRC
+ *
+ * Description: The CRCs come from the block index sidecar, written along
+ * with the file by blockchain_serialize(). If the sidecar is missing, stale
+ * or without CRCs, the hashes are checked before returning instead, and
+ * the sidecar is then written with the CRCs of the checked blocks for the
+ * next load. A sidecar is stale once the file size or the hash of its last
+ * block changed, see block_index_open(). Only blocks are checked: the
+ * unspent outputs after them are covered by neither the CRCs nor the
+ * hashes, and are loaded as they are.
+ */
+blockchain_t *blockchain_load_trusted(char const *path,
+	chain_verify_t *verify)
+{
+	chain_map_t *map;
+	blockchain_t *blockchain = NULL;
+	uint32_t nblocks, *crcs = NULL, i;
+	size_t end;
+	int fd;
+
+	if (!verify)
+		return (NULL);
+	memset(verify, 0, sizeof(*verify));
+	verify->bad = -1;
+	map = chain_map_open(path);
+	if (!map)
+		return (NULL);
+	fd = block_index_open(path, &nblocks, -1);
+	if (fd != -1 && nblocks == map->nblocks)
+		crcs = block_index_crcs(fd, nblocks);
+	if (fd != -1)
+		close(fd);
+	for (i = 0; crcs && i < map->nblocks; i++)
+	{
+		end = i + 1 < map->nblocks ? map->blocks[i + 1] : map->unspent;
+		if (crc32c(0, map->base + map->blocks[i], end - map->blocks[i]) !=
+			crcs[i])
+		{
+			verify->bad = i, verify->failed = 1;
+			goto out;
+		}
+	}
+	blockchain = chain_map_blockchain_parallel(map, 0);
+	if (!blockchain)
+		goto out;
+	verify->blockchain = blockchain;
+	if (!crcs)
+	{
+		verify->failed = chain_verify_range(blockchain, &verify->bad);
+		if (verify->failed)
+		{
+			blockchain_destroy(blockchain);
+			blockchain = NULL;
+		}
+		else
+			block_index_map_save(map, path, HBLK_INDEX_CRC);
+	}
+	else if (!pthread_create(&verify->thread, NULL, chain_verify_worker,
+		verify))
+		verify->started = 1;
+	else
+		chain_verify_worker(verify);
+out:
+	free(crcs);
+	chain_map_close(map);
+	return (blockchain);
+}
+
+/**
+ * chain_verify_wait - waits for the background check of a loaded chain
+ * @verify: check started by blockchain_load_trusted()
+ * Return: 0 if every block hash matched, 1 otherwise, see @verify->bad
+ */
+int chain_verify_wait(chain_verify_t *verify)
+{
+	if (!verify)
+		return (1);
+	if (verify->started)
+		pthread_join(verify->thread, NULL);
+	verify->started = 0;
+	return (verify->failed);
+}
+
+/**
+ * chain_verify_worker - thread routine checking the hashes of a chain
+ * @arg: pointer to the chain_verify_t
+ * Return: NULL
+ */
+void *chain_verify_worker(void *arg)
+{
+	chain_verify_t *verify = arg;
+
+	verify->failed = chain_verify_range(verify->blockchain, &verify->bad);
+	return (NULL);
+}
+
+/**
+ * chain_verify_range - computes the hash of every block of a chain again
+ * and compares it with the stored one
+ * @blockchain: chain to check
+ * @bad: set to the height of the first block whose hash is wrong
+ * Return: 0 if every hash matched, 1 otherwise or if it couldn't tell
+ *
+ * Description: Blocks are hashed one at a time with block_hash(): batching
+ * them through the multi-buffer kernels measured no faster.
+ */
+int chain_verify_range(blockchain_t const *blockchain, int64_t *bad)
+{
+	return (llist_for_each(blockchain->chain, chain_verify_block, bad) != 0);
+}
+
+/**
+ * chain_verify_block - llist_for_each() action checking the hash of a block
+ * @block: block
+ * @height: height of the block
+ * @bad: set to @height if the hash is wrong
+ * Return: 0 if the hash matched, 1 otherwise or if it couldn't tell
+ */
+int chain_verify_block(llist_node_t block, unsigned int height, void *bad)
+{
+	uint8_t hash[SHA256_DIGEST_LENGTH];
+
+	if (!block_hash(block, hash))
+		return (1);
+	if (memcmp(hash, ((block_t *)block)->hash, SHA256_DIGEST_LENGTH))
+	{
+		*(int64_t *)bad = height;
+		return (1);
+	}
+	return (0);
+}
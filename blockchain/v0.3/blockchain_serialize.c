@@ -1,10 +1,10 @@
 #include "blockchain.h"
+#include <fcntl.h>
+#include <errno.h>
 
-int write_blocks(block_t *block, unsigned int index, FILE *fptr);
-int write_tx(transaction_t *tx, unsigned int index, FILE *fptr);
-int write_ins(ti_t *in, unsigned int index, FILE *fptr);
-int write_outs(to_t *out, unsigned int index, FILE *fptr);
-int write_unspent(uto_t *unspent, unsigned int index, FILE *fptr);
+int write_tx(transaction_t *tx, unsigned int index, serial_buf_t *sb);
+int write_ins(ti_t *in, unsigned int index, serial_buf_t *sb);
+int write_outs(to_t *out, unsigned int index, serial_buf_t *sb);
 
 
 /**
@@ -12,57 +12,103 @@ int write_unspent(uto_t *unspent, unsigned int index, FILE *fptr);
  * @blockchain: chain to serialize
  * @path: file path to serialize to
  * Return: 1 on succerss, 0 on fail
+ *
+ * Description: Records are laid out in a staging buffer of SERIAL_BUF_SIZE
+ * bytes, written out with one write() each time it fills up, instead of
+ * one stdio call per block, transaction, input and output. The offset and
+ * CRC-32C of each block go to the block index sidecar, see
+ * blockchain_load_block() and blockchain_load_trusted().
  */
 int blockchain_serialize(blockchain_t const *blockchain, char const *path)
 {
-	FILE *fptr = NULL;
+	serial_buf_t sb = {-1, NULL, 0, 0, 0, NULL, 0, 0};
+	block_index_t index = {NULL, NULL, NULL, 0, 0};
 	int blocknums = 0, unspent_nums = 0;
-	char header[16] = {FHEADER};
+	uint64_t blocks_end;
+	uint8_t *header;
 
 	if (!blockchain || !path)
 		return (0);
+	sb.buf = malloc(SERIAL_BUF_SIZE);
+	if (!sb.buf)
+		return (0);
+	sb.fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (sb.fd == -1)
+	{
+		free(sb.buf);
+		return (0);
+	}
 	blocknums = llist_size(blockchain->chain);
 	unspent_nums = llist_size(blockchain->unspent);
+	header = serial_reserve(&sb, 16);
+	memcpy(&header[0], FHEADER, 7);
 	memcpy(&header[7], END, 1);
 	memcpy(&header[8], &blocknums, 4);
 	memcpy(&header[12], &unspent_nums, 4);
-	fptr = fopen(path, "w");
-	fwrite(header, 1, 16, fptr);
-	llist_for_each(blockchain->chain, (node_func_t)&write_blocks, fptr);
-	llist_for_each(blockchain->unspent, (node_func_t)&write_unspent, fptr);
-	fclose(fptr);
-	return (1);
+	sb.index = &index;
+	llist_for_each(blockchain->chain, (node_func_t)&write_blocks, &sb);
+	serial_crc_close(&sb);
+	blocks_end = sb.written + sb.len;
+	llist_for_each(blockchain->unspent, (node_func_t)&write_unspent, &sb);
+	serial_flush(&sb);
+	if (close(sb.fd))
+		sb.error = 1;
+	free(sb.buf);
+	/* The index is only a cache: without it, it gets rebuilt on demand */
+	block_index_save(sb.error || !index.count ? NULL : sb.index, path,
+		blocks_end, sb.written, HBLK_INDEX_CRC);
+	block_index_free(&index);
+	return (!sb.error);
 }
 
 /**
  * write_blocks - function to write blocks to file
  * @block: node to perform function on
  * @index: unused
- * @fptr: filestream pointer
- * Return: 0
+ * @sb: staging buffer
+ * Return: 0, 1 once writing failed
+ *
+ * Description: The transactions of a pending block of a lazy chain are
+ * decoded for the write and freed, the block is left pending.
  */
-int write_blocks(block_t *block, unsigned int index, FILE *fptr)
+int write_blocks(block_t *block, unsigned int index, serial_buf_t *sb)
 {
 	(void)index;
-	char block_buf[1120];
+	uint8_t *block_buf;
 	uint32_t len = 0;
 	int tx_size = 0;
+	block_t loaded;
 
-
+	if (block->lazy)
+	{
+		if (chain_lazy_peek(block, &loaded))
+		{
+			sb->error = 1;
+			return (1);
+		}
+		write_blocks(&loaded, index, sb);
+		llist_destroy(loaded.transactions, 1,
+			(node_dtor_t)&transaction_destroy);
+		return (sb->error);
+	}
 	tx_size = llist_size(block->transactions);
-	if (!strcmp(END, "\x02"))
-		SWAPENDIAN(block);
-
 	len = block->data.len;
+	serial_crc_close(sb);
+	block_buf = serial_reserve(sb, 96 + len);
+	if (!block_buf)
+		return (1);
+	if (sb->index && block_index_add(sb->index,
+		sb->written + (block_buf - sb->buf), block->hash))
+		sb->index = NULL;
 
 	memcpy(&block_buf[0], block, sizeof(block_info_t));
 	memcpy(&block_buf[56], &block->data.len, 4);
 	memcpy(&block_buf[60], block->data.buffer, len);
 	memcpy(&block_buf[60 + len], block->hash, 32);
 	memcpy(&block_buf[92 + len], &tx_size, 4);
-	fwrite(block_buf, 1, 96 + len, fptr);
 	if (tx_size > 0)
-		llist_for_each(block->transactions, (node_func_t)*write_tx, fptr);
+		return (llist_for_each(block->transactions,
+			(node_func_t)&write_tx, sb));
 	return (0);
 }
 
@@ -70,45 +116,48 @@ int write_blocks(block_t *block, unsigned int index, FILE *fptr)
  * write_tx - writes a tx node to file
  * @tx: transaction to write
  * @index: unused
- * @fptr: file pointer
- * Return: 0
+ * @sb: staging buffer
+ * Return: 0, 1 once writing failed
  */
-int write_tx(transaction_t *tx, unsigned int index, FILE *fptr)
+int write_tx(transaction_t *tx, unsigned int index, serial_buf_t *sb)
 {
 	(void)index;
-	char tx_buff[40];
+	uint8_t *tx_buff;
 	int ins = 0, outs = 0;
 
 	ins = llist_size(tx->inputs);
 	outs = llist_size(tx->outputs);
+	tx_buff = serial_reserve(sb, 40);
+	if (!tx_buff)
+		return (1);
 
 	memcpy(&tx_buff[0], tx->id, 32);
 	memcpy(&tx_buff[32], &ins, 4);
 	memcpy(&tx_buff[36], &outs, 4);
-	fwrite(&tx_buff, 1, 40, fptr);
-	llist_for_each(tx->inputs, (node_func_t)&write_ins, fptr);
-	llist_for_each(tx->outputs, (node_func_t)&write_outs, fptr);
-	return (0);
+	if (llist_for_each(tx->inputs, (node_func_t)&write_ins, sb))
+		return (1);
+	return (llist_for_each(tx->outputs, (node_func_t)&write_outs, sb));
 }
 
 /**
  * write_ins - writes tx inputs to file
  * @in: input to write
  * @index: unused
- * @fptr: file pointer
- * Return: 0
+ * @sb: staging buffer
+ * Return: 0, 1 once writing failed
  */
-int write_ins(ti_t *in, unsigned int index, FILE *fptr)
+int write_ins(ti_t *in, unsigned int index, serial_buf_t *sb)
 {
 	(void)index;
-	char in_buff[169];
+	uint8_t *in_buff = serial_reserve(sb, 169);
 
+	if (!in_buff)
+		return (1);
 	memcpy(&in_buff[0], in->block_hash, 32);
 	memcpy(&in_buff[32], in->tx_id, 32);
 	memcpy(&in_buff[64], in->tx_out_hash, 32);
 	memcpy(&in_buff[96], in->sig.sig, 72);
 	memcpy(&in_buff[168], &in->sig.len, 1);
-	fwrite(&in_buff, 1, 169, fptr);
 	return (0);
 }
 
@@ -116,18 +165,19 @@ int write_ins(ti_t *in, unsigned int index, FILE *fptr)
  * write_outs - writes tx outputs to file
  * @out: output to write
  * @index: unused
- * @fptr: File pointer
- * Return: 0
+ * @sb: staging buffer
+ * Return: 0, 1 once writing failed
  */
-int write_outs(to_t *out, unsigned int index, FILE *fptr)
+int write_outs(to_t *out, unsigned int index, serial_buf_t *sb)
 {
 	(void)index;
-	char out_buff[101];
+	uint8_t *out_buff = serial_reserve(sb, 101);
 
+	if (!out_buff)
+		return (1);
 	memcpy(&out_buff[0], &out->amount, 4);
 	memcpy(&out_buff[4], out->pub, 65);
 	memcpy(&out_buff[69], out->hash, 32);
-	fwrite(&out_buff, 1, 101, fptr);
 	return (0);
 }
 
@@ -135,19 +185,87 @@ int write_outs(to_t *out, unsigned int index, FILE *fptr)
  * write_unspent - writes unspent outputs to file
  * @unspent: unspent to write
  * @index: unsused
- * @fptr: file pointer
- * Return: 0
+ * @sb: staging buffer
+ * Return: 0, 1 once writing failed
  */
-int write_unspent(uto_t *unspent, unsigned int index, FILE *fptr)
+int write_unspent(uto_t *unspent, unsigned int index, serial_buf_t *sb)
 {
 	(void)index;
-	char unspent_buff[165];
+	uint8_t *unspent_buff = serial_reserve(sb, 165);
 
+	if (!unspent_buff)
+		return (1);
 	memcpy(&unspent_buff[0], unspent->block_hash, 32);
 	memcpy(&unspent_buff[32], unspent->tx_id, 32);
 	memcpy(&unspent_buff[64], &unspent->out.amount, 4);
 	memcpy(&unspent_buff[68], unspent->out.pub, 65);
 	memcpy(&unspent_buff[133], unspent->out.hash, 32);
-	fwrite(&unspent_buff, 1, 165, fptr);
 	return (0);
 }
+
+/**
+ * serial_reserve - makes room for a record in the staging buffer
+ * @sb: staging buffer
+ * @len: size of the record, at most SERIAL_BUF_SIZE
+ * Return: where to lay the record out, or NULL once writing failed
+ */
+uint8_t *serial_reserve(serial_buf_t *sb, size_t len)
+{
+	uint8_t *record;
+
+	if (sb->len + len > SERIAL_BUF_SIZE && serial_flush(sb))
+		return (NULL);
+	if (sb->error)
+		return (NULL);
+	record = sb->buf + sb->len;
+	sb->len += len;
+	return (record);
+}
+
+/**
+ * serial_flush - writes the staged bytes out
+ * @sb: staging buffer
+ * Return: 0 on success, 1 on fail
+ */
+int serial_flush(serial_buf_t *sb)
+{
+	size_t done = 0;
+	ssize_t n;
+
+	if (sb->index)
+		sb->crc = crc32c(sb->crc, sb->buf + sb->crc_from,
+			sb->len - sb->crc_from);
+	sb->crc_from = 0;
+	while (!sb->error && done < sb->len)
+	{
+		n = write(sb->fd, sb->buf + done, sb->len - done);
+		if (n == -1 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			sb->error = 1;
+		else
+			done += n;
+	}
+	sb->written += done;
+	sb->len = 0;
+	return (sb->error);
+}
+
+/**
+ * serial_crc_close - ends the CRC-32C of the block staged last, if any,
+ * and starts the next one
+ * @sb: staging buffer, the next block not staged yet
+ *
+ * Description: A block can span several flushes, so its CRC is carried
+ * along in @sb and only stored in the index once the next one starts.
+ */
+void serial_crc_close(serial_buf_t *sb)
+{
+	if (!sb->index)
+		return;
+	if (sb->index->count)
+		sb->index->crcs[sb->index->count - 1] = crc32c(sb->crc,
+			sb->buf + sb->crc_from, sb->len - sb->crc_from);
+	sb->crc = 0;
+	sb->crc_from = sb->len;
+}
@@ -0,0 +1,237 @@
+#include "blockchain.h"
+#include <fcntl.h>
+
+int compact_write_tx(transaction_t *tx, unsigned int index,
+	compact_writer_t *cw);
+int compact_write_in(ti_t *in, unsigned int index, compact_writer_t *cw);
+int compact_write_out(to_t *out, unsigned int index, compact_writer_t *cw);
+int compact_put_hash(compact_writer_t *cw,
+	uint8_t const hash[SHA256_DIGEST_LENGTH],
+	uint8_t const computed[SHA256_DIGEST_LENGTH]);
+
+/**
+ * blockchain_serialize_compact - serializes a blockchain to file in the
+ * compact format
+ * @blockchain: chain to serialize
+ * @path: file path to serialize to
+ * Return: 1 on success, 0 on fail, as blockchain_serialize()
+ *
+ * Description: Same records as blockchain_serialize(), except counts,
+ * lengths and amounts are varints, public keys are compressed to 33 bytes
+ * and signatures take their own length instead of 72 bytes. Block hashes,
+ * transaction IDs and output hashes are left out whenever they are the
+ * ones computed from the rest of the record, which they are on a valid
+ * chain; the reader computes them back.
+ */
+int blockchain_serialize_compact(blockchain_t const *blockchain,
+	char const *path)
+{
+	compact_writer_t cw = {{-1, NULL, 0, 0, 0, NULL, 0, 0}, NULL, NULL, NULL};
+	uint8_t *header;
+
+	if (!blockchain || !path)
+		return (0);
+	cw.sb.buf = malloc(SERIAL_BUF_SIZE);
+	cw.group = EC_GROUP_new_by_curve_name(EC_CURVE);
+	cw.point = cw.group ? EC_POINT_new(cw.group) : NULL;
+	cw.ctx = BN_CTX_new();
+	if (cw.sb.buf && cw.point && cw.ctx)
+		cw.sb.fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (cw.sb.fd != -1)
+	{
+		header = serial_reserve(&cw.sb, 8);
+		memcpy(&header[0], FHEADER_COMPACT, 7);
+		memcpy(&header[7], END, 1);
+		compact_put_varint(&cw.sb, llist_size(blockchain->chain));
+		compact_put_varint(&cw.sb, llist_size(blockchain->unspent));
+		llist_for_each(blockchain->chain,
+			(node_func_t)&compact_write_block, &cw);
+		llist_for_each(blockchain->unspent,
+			(node_func_t)&compact_write_unspent, &cw);
+		serial_flush(&cw.sb);
+		if (close(cw.sb.fd))
+			cw.sb.error = 1;
+	}
+	free(cw.sb.buf);
+	EC_POINT_free(cw.point);
+	EC_GROUP_free(cw.group);
+	BN_CTX_free(cw.ctx);
+	return (cw.sb.fd != -1 && !cw.sb.error);
+}
+
+/**
+ * compact_write_block - writes a block in the compact format
+ * @block: block to write
+ * @index: unused
+ * @cw: compact writer
+ * Return: 0, 1 once writing failed
+ *
+ * Description: The transaction count is stored plus one, so that 0 stands
+ * for a block without a list of transactions. The transactions of a
+ * pending block of a lazy chain are decoded for the write and freed.
+ */
+int compact_write_block(block_t *block, unsigned int index,
+	compact_writer_t *cw)
+{
+	uint8_t *p, computed[SHA256_DIGEST_LENGTH];
+	block_t loaded;
+
+	(void)index;
+	if (block->lazy)
+	{
+		if (chain_lazy_peek(block, &loaded))
+		{
+			cw->sb.error = 1;
+			return (1);
+		}
+		compact_write_block(&loaded, index, cw);
+		llist_destroy(loaded.transactions, 1,
+			(node_dtor_t)&transaction_destroy);
+		return (cw->sb.error);
+	}
+	p = serial_reserve(&cw->sb, sizeof(block_info_t));
+	if (!p)
+		return (1);
+	memcpy(p, &block->info, sizeof(block_info_t));
+	compact_put_varint(&cw->sb, block->data.len);
+	p = serial_reserve(&cw->sb, block->data.len);
+	if (!p)
+		return (1);
+	memcpy(p, block->data.buffer, block->data.len);
+	if (compact_put_hash(cw, block->hash, block_hash(block, computed)))
+		return (1);
+	compact_put_varint(&cw->sb, llist_size(block->transactions) + 1);
+	if (block->transactions)
+		llist_for_each(block->transactions,
+			(node_func_t)&compact_write_tx, cw);
+	return (cw->sb.error);
+}
+
+/**
+ * compact_write_tx - writes a transaction in the compact format
+ * @tx: transaction to write
+ * @index: unused
+ * @cw: compact writer
+ * Return: 0, 1 once writing failed
+ */
+int compact_write_tx(transaction_t *tx, unsigned int index,
+	compact_writer_t *cw)
+{
+	uint8_t computed[SHA256_DIGEST_LENGTH];
+
+	(void)index;
+	if (compact_put_hash(cw, tx->id, transaction_hash(tx, computed)))
+		return (1);
+	compact_put_varint(&cw->sb, llist_size(tx->inputs));
+	compact_put_varint(&cw->sb, llist_size(tx->outputs));
+	llist_for_each(tx->inputs, (node_func_t)&compact_write_in, cw);
+	llist_for_each(tx->outputs, (node_func_t)&compact_write_out, cw);
+	return (cw->sb.error);
+}
+
+/**
+ * compact_write_in - writes a transaction input in the compact format
+ * @in: input to write
+ * @index: unused
+ * @cw: compact writer
+ * Return: 0, 1 once writing failed
+ *
+ * Description: As in the v0.3 format, only the low byte of the signature
+ * length is kept.
+ */
+int compact_write_in(ti_t *in, unsigned int index, compact_writer_t *cw)
+{
+	size_t len = in->sig.len & 0xff;
+	uint8_t *p;
+
+	(void)index;
+	p = serial_reserve(&cw->sb, 3 * SHA256_DIGEST_LENGTH);
+	if (!p)
+		return (1);
+	memcpy(p, in->block_hash, SHA256_DIGEST_LENGTH);
+	memcpy(p + 32, in->tx_id, SHA256_DIGEST_LENGTH);
+	memcpy(p + 64, in->tx_out_hash, SHA256_DIGEST_LENGTH);
+	compact_put_varint(&cw->sb, len);
+	if (len > MAX_SIG_LEN)
+		len = MAX_SIG_LEN;
+	p = serial_reserve(&cw->sb, len);
+	if (!p)
+		return (1);
+	memcpy(p, in->sig.sig, len);
+	return (0);
+}
+
+/**
+ * compact_write_out - writes a transaction output in the compact format
+ * @out: output to write
+ * @index: unused
+ * @cw: compact writer
+ * Return: 0, 1 once writing failed
+ */
+int compact_write_out(to_t *out, unsigned int index, compact_writer_t *cw)
+{
+	uint8_t *p, computed[SHA256_DIGEST_LENGTH];
+
+	(void)index;
+	compact_put_varint(&cw->sb, out->amount);
+	SHA256((uint8_t *)out, sizeof(out->amount) + EC_PUB_LEN, computed);
+	if (!memcmp(out->hash, computed, SHA256_DIGEST_LENGTH))
+	{
+		compact_put_pub(cw, out->pub, 0);
+		return (cw->sb.error);
+	}
+	compact_put_pub(cw, out->pub, COMPACT_HASH_STORED);
+	p = serial_reserve(&cw->sb, SHA256_DIGEST_LENGTH);
+	if (!p)
+		return (1);
+	memcpy(p, out->hash, SHA256_DIGEST_LENGTH);
+	return (0);
+}
+
+/**
+ * compact_write_unspent - writes an unspent output in the compact format
+ * @unspent: unspent output to write
+ * @index: unused
+ * @cw: compact writer
+ * Return: 0, 1 once writing failed
+ */
+int compact_write_unspent(uto_t *unspent, unsigned int index,
+	compact_writer_t *cw)
+{
+	uint8_t *p = serial_reserve(&cw->sb, 2 * SHA256_DIGEST_LENGTH);
+
+	if (!p)
+		return (1);
+	memcpy(p, unspent->block_hash, SHA256_DIGEST_LENGTH);
+	memcpy(p + 32, unspent->tx_id, SHA256_DIGEST_LENGTH);
+	return (compact_write_out(&unspent->out, index, cw));
+}
+
+/**
+ * compact_put_hash - writes a flag byte, then the hash unless computed
+ * @cw: compact writer
+ * @hash: hash of the record
+ * @computed: hash computed from the record, may be NULL
+ * Return: 0, 1 once writing failed
+ */
+int compact_put_hash(compact_writer_t *cw,
+	uint8_t const hash[SHA256_DIGEST_LENGTH],
+	uint8_t const computed[SHA256_DIGEST_LENGTH])
+{
+	uint8_t *p;
+
+	if (computed && !memcmp(hash, computed, SHA256_DIGEST_LENGTH))
+	{
+		p = serial_reserve(&cw->sb, 1);
+		if (!p)
+			return (1);
+		*p = 0;
+		return (0);
+	}
+	p = serial_reserve(&cw->sb, 1 + SHA256_DIGEST_LENGTH);
+	if (!p)
+		return (1);
+	*p = COMPACT_HASH_STORED;
+	memcpy(p + 1, hash, SHA256_DIGEST_LENGTH);
+	return (0);
+}
@@ -0,0 +1,150 @@
+#include "blockchain.h"
+
+/**
+ * blockchain_load_headers - loads a chain file header first
+ * @path: chain file
+ * Return: pointer to the lazy chain or NULL
+ *
+ * Description: Only the info, data and hash of each block are copied, and
+ * the unspent outputs. The transactions of a block are decoded from the
+ * mapped file the first time chain_lazy_txs() asks for them; until then
+ * the block's transactions are NULL and its lazy member points to @lazy,
+ * telling it apart from a block without transactions. Code that only
+ * looks at headers, as blockchain_difficulty(), can use lazy->blockchain
+ * as it is. The serializers write the pending transactions from the file,
+ * the validators refuse pending blocks.
+ */
+chain_lazy_t *blockchain_load_headers(char const *path)
+{
+	chain_lazy_t *lazy = calloc(1, sizeof(*lazy));
+	block_view_t view;
+	uto_t *unspent;
+	uint32_t i;
+
+	if (!lazy)
+		return (NULL);
+	lazy->map = chain_map_open(path);
+	lazy->blockchain = calloc(1, sizeof(*lazy->blockchain));
+	if (!lazy->map || !lazy->blockchain)
+		goto fail;
+	lazy->blocks = malloc((lazy->map->nblocks + 1) * sizeof(*lazy->blocks));
+	lazy->blockchain->chain = llist_create(MT_SUPPORT_FALSE);
+	lazy->blockchain->unspent = llist_create(MT_SUPPORT_FALSE);
+	if (!lazy->blocks || !lazy->blockchain->chain ||
+		!lazy->blockchain->unspent)
+		goto fail;
+	for (i = 0; i < lazy->map->nblocks; i++)
+	{
+		lazy->blocks[i] = chain_map_header(lazy->map, i, &view);
+		if (!lazy->blocks[i] || llist_add_node(lazy->blockchain->chain,
+			lazy->blocks[i], ADD_NODE_REAR))
+		{
+			block_destroy(lazy->blocks[i]);
+			goto fail;
+		}
+		if (view.ntxs != -1)
+			lazy->blocks[i]->lazy = lazy;
+	}
+	for (i = 0; i < lazy->map->nunspent; i++)
+	{
+		unspent = chain_map_unspent(lazy->map, i);
+		if (!unspent || llist_add_node(lazy->blockchain->unspent, unspent,
+			ADD_NODE_REAR))
+		{
+			free(unspent);
+			goto fail;
+		}
+	}
+	chain_store_sync(lazy->blockchain);
+	return (lazy);
+fail:
+	chain_lazy_close(lazy);
+	return (NULL);
+}
+
+/**
+ * chain_lazy_txs - gets the transactions of a block of a lazy chain,
+ * decoding them on first access
+ * @lazy: lazy chain
+ * @block: block of @lazy->blockchain
+ * Return: the block's transactions, NULL for a block without any list of
+ * them or on fail
+ *
+ * Description: The list is stored in @block, which is then no longer
+ * pending: later calls and plain block->transactions reads get it as is.
+ * Not thread safe.
+ */
+llist_t *chain_lazy_txs(chain_lazy_t *lazy, block_t *block)
+{
+	block_t loaded;
+
+	if (!lazy || !block || block->lazy != lazy)
+		return (block ? block->transactions : NULL);
+	if (chain_lazy_peek(block, &loaded))
+		return (NULL);
+	block->transactions = loaded.transactions;
+	block->lazy = NULL;
+	return (block->transactions);
+}
+
+/**
+ * chain_lazy_peek - decodes the transactions of a pending block of a lazy
+ * chain, leaving the block as it is
+ * @block: block whose transactions aren't loaded yet
+ * @copy: filled in with @block and a list of its transactions of its own,
+ * to destroy with transaction_destroy() on each node
+ * Return: 0 on success, 1 on fail
+ */
+int chain_lazy_peek(block_t const *block, block_t *copy)
+{
+	block_view_t view;
+	int height;
+
+	if (!block->lazy)
+		return (1);
+	height = chain_lazy_height(block->lazy, block);
+	if (height == -1 || chain_map_block_view(block->lazy->map, height,
+		&view) || view.ntxs == -1)
+		return (1);
+	*copy = *block;
+	copy->lazy = NULL;
+	copy->transactions = chain_map_block_txs(block->lazy->map, &view);
+	return (!copy->transactions);
+}
+
+/**
+ * chain_lazy_height - finds the height of a block of a lazy chain
+ * @lazy: lazy chain
+ * @block: block of @lazy->blockchain
+ * Return: height of @block, -1 if it isn't one of the chain's
+ *
+ * Description: Costs nothing when the block index matches its height, as
+ * in any valid chain, and a scan otherwise.
+ */
+int chain_lazy_height(chain_lazy_t const *lazy, block_t const *block)
+{
+	uint32_t i;
+
+	if (block->info.index < lazy->map->nblocks &&
+		lazy->blocks[block->info.index] == block)
+		return (block->info.index);
+	for (i = 0; i < lazy->map->nblocks; i++)
+		if (lazy->blocks[i] == block)
+			return (i);
+	return (-1);
+}
+
+/**
+ * chain_lazy_close - frees a lazy chain, with its blockchain, and unmaps
+ * its file
+ * @lazy: lazy chain
+ */
+void chain_lazy_close(chain_lazy_t *lazy)
+{
+	if (!lazy)
+		return;
+	blockchain_destroy(lazy->blockchain);
+	chain_map_close(lazy->map);
+	free(lazy->blocks);
+	free(lazy);
+}
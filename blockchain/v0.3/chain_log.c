@@ -0,0 +1,178 @@
+#include "blockchain.h"
+#include <fcntl.h>
+
+int chain_log_recover(chain_log_t *log, char const *path);
+int chain_log_append_node(llist_node_t block, unsigned int height, void *log);
+int chain_log_undo(chain_log_t *log);
+
+/**
+ * chain_log_open - opens a chain file to append blocks to, creating it
+ * @path: file to open
+ * Return: pointer to the log or NULL
+ *
+ * Description: The file is a serialized blockchain without unspent
+ * outputs, readable by blockchain_deserialize() and chain_map_open().
+ * Bytes left past the last counted block by an interrupted append are cut.
+ */
+chain_log_t *chain_log_open(char const *path)
+{
+	chain_log_t *log;
+	struct stat st;
+	uint8_t *header;
+	uint32_t zero = 0;
+
+	if (!path)
+		return (NULL);
+	log = calloc(1, sizeof(*log));
+	if (!log)
+		return (NULL);
+	log->sb.buf = malloc(SERIAL_BUF_SIZE);
+	log->sb.fd = open(path, O_RDWR | O_CREAT, 0666);
+	if (!log->sb.buf || log->sb.fd == -1 || fstat(log->sb.fd, &st))
+		goto fail;
+	if (st.st_size)
+	{
+		if (chain_log_recover(log, path))
+			goto fail;
+		return (log);
+	}
+
+	/* New log: just the header, with no block and no unspent output */
+	header = serial_reserve(&log->sb, HBLK_HEADER_SIZE);
+	memcpy(&header[0], FHEADER, 7);
+	memcpy(&header[7], END, 1);
+	memcpy(&header[8], &zero, 4);
+	memcpy(&header[12], &zero, 4);
+	if (serial_flush(&log->sb))
+		goto fail;
+	log->size = HBLK_HEADER_SIZE;
+	return (log);
+fail:
+	chain_log_close(log);
+	return (NULL);
+}
+
+/**
+ * chain_log_recover - finds the end of the blocks of an existing log
+ * @log: log being opened
+ * @path: file of the log
+ * Return: 0 on success, 1 if the file isn't a chain log
+ */
+int chain_log_recover(chain_log_t *log, char const *path)
+{
+	chain_map_t *map = chain_map_open(path);
+	int ret = 1;
+
+	if (!map)
+		return (1);
+	if (!map->nunspent)
+	{
+		log->nblocks = map->nblocks;
+		log->size = map->unspent;
+		ret = ftruncate(log->sb.fd, log->size) != 0;
+	}
+	chain_map_close(map);
+	return (ret);
+}
+
+/**
+ * chain_log_close - closes a chain log
+ * @log: log to close
+ */
+void chain_log_close(chain_log_t *log)
+{
+	if (!log)
+		return;
+	if (log->sb.fd != -1)
+		close(log->sb.fd);
+	free(log->sb.buf);
+	free(log);
+}
+
+/**
+ * chain_log_append - appends one block to a chain log
+ * @log: log to append to
+ * @block: block to append
+ * Return: 0 on success, 1 on fail
+ *
+ * Description: Writes the block past the last one, then the new block
+ * count in place, so an interrupted append leaves the file as it was.
+ * A failed append is cut back to the last counted block, and later
+ * appends go on from there.
+ */
+int chain_log_append(chain_log_t *log, block_t const *block)
+{
+	uint32_t nblocks;
+	off_t end;
+
+	if (!log || !block || log->sb.error)
+		return (1);
+	if (lseek(log->sb.fd, log->size, SEEK_SET) == -1)
+		return (1);
+	write_blocks((block_t *)block, 0, &log->sb);
+	if (serial_flush(&log->sb))
+		return (chain_log_undo(log));
+	end = lseek(log->sb.fd, 0, SEEK_CUR);
+	nblocks = log->nblocks + 1;
+	if (end == -1 || pwrite(log->sb.fd, &nblocks, 4, 8) != 4)
+		return (chain_log_undo(log));
+	log->nblocks = nblocks;
+	log->size = end;
+	return (0);
+}
+
+/**
+ * chain_log_undo - cuts a failed append back to the last counted block
+ * @log: log an append to failed
+ * Return: 1, the result of the failed append
+ *
+ * Description: The log is usable again once the bytes past the last
+ * counted block are gone. If they can't be cut, it stays in error and
+ * refuses appends until it is reopened.
+ */
+int chain_log_undo(chain_log_t *log)
+{
+	uint32_t nblocks = log->nblocks;
+
+	log->sb.len = 0;
+	log->sb.crc_from = 0;
+	if (!ftruncate(log->sb.fd, log->size) &&
+		pwrite(log->sb.fd, &nblocks, 4, 8) == 4)
+		log->sb.error = 0;
+	else
+		log->sb.error = 1;
+	return (1);
+}
+
+/**
+ * chain_log_sync - appends the blocks of a chain a log doesn't hold yet
+ * @log: log to append to
+ * @blockchain: chain the log was saved from
+ * Return: 0 on success, 1 on fail
+ */
+int chain_log_sync(chain_log_t *log, blockchain_t const *blockchain)
+{
+	int size;
+
+	if (!log || !blockchain)
+		return (1);
+	size = llist_size(blockchain->chain);
+	if (size < 0 || (uint32_t)size < log->nblocks)
+		return (1);
+	return (chain_store_for_each(blockchain, chain_log_append_node, log) != 0);
+}
+
+/**
+ * chain_log_append_node - chain_store_for_each() action appending the
+ * blocks a log doesn't hold yet
+ * @block: block
+ * @height: height of @block
+ * @log: log, as a chain_log_t
+ * Return: 0 on success, 1 on fail
+ */
+int chain_log_append_node(llist_node_t block, unsigned int height, void *log)
+{
+	if (height < ((chain_log_t *)log)->nblocks)
+		return (0);
+	return (chain_log_append(log, block));
+}
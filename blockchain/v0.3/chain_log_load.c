@@ -0,0 +1,75 @@
+#include "blockchain.h"
+
+/**
+ * unspent_save - saves unspent outputs on their own
+ * @unspent: list of unspent outputs
+ * @path: file to write
+ * Return: 0 on success, 1 on fail
+ *
+ * Description: The file is a serialized blockchain with no block, written
+ * aside then renamed over @path so a crash never leaves half of it. Each
+ * call rewrites the whole set, so it takes time in the number of unspent
+ * outputs rather than in what changed since the last call: save them at
+ * checkpoints, not after each block appended to the log.
+ */
+int unspent_save(llist_t *unspent, char const *path)
+{
+	blockchain_t outputs = {0};
+	char *tmp;
+	int ret = 1;
+
+	if (!unspent || !path)
+		return (1);
+	tmp = malloc(strlen(path) + 5);
+	outputs.chain = llist_create(MT_SUPPORT_FALSE);
+	outputs.unspent = unspent;
+	if (tmp && outputs.chain)
+	{
+		sprintf(tmp, "%s.tmp", path);
+		if (blockchain_serialize(&outputs, tmp) && !rename(tmp, path))
+			ret = 0;
+		else
+			remove(tmp);
+	}
+	llist_destroy(outputs.chain, 0, NULL);
+	free(tmp);
+	return (ret);
+}
+
+/**
+ * chain_log_load - loads a chain saved with a chain log and unspent_save()
+ * @log_path: file of the chain log
+ * @unspent_path: file of the unspent outputs, added to any the log file
+ * holds, or NULL
+ * Return: pointer to the blockchain or NULL
+ */
+blockchain_t *chain_log_load(char const *log_path, char const *unspent_path)
+{
+	chain_map_t *map = chain_map_open(log_path), *outputs = NULL;
+	blockchain_t *blockchain = chain_map_blockchain(map);
+	uto_t *unspent;
+	uint32_t i;
+
+	chain_map_close(map);
+	if (!blockchain || !unspent_path)
+		return (blockchain);
+	outputs = chain_map_open(unspent_path);
+	if (!outputs)
+		goto fail;
+	for (i = 0; i < outputs->nunspent; i++)
+	{
+		unspent = chain_map_unspent(outputs, i);
+		if (!unspent ||
+			llist_add_node(blockchain->unspent, unspent, ADD_NODE_REAR))
+		{
+			free(unspent);
+			goto fail;
+		}
+	}
+	chain_map_close(outputs);
+	return (blockchain);
+fail:
+	chain_map_close(outputs);
+	blockchain_destroy(blockchain);
+	return (NULL);
+}
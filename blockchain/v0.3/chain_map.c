@@ -0,0 +1,171 @@
+#include "blockchain.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+
+int chain_map_txs(chain_map_t *map, size_t *off, int32_t ntxs);
+int chain_map_push_tx(chain_map_t *map, size_t off);
+
+/**
+ * chain_map_open - maps a serialized blockchain and indexes it
+ * @path: file to map
+ * Return: pointer to the map or NULL
+ *
+ * Description: Only the offsets of the blocks and transactions are
+ * allocated; everything else is read in place through the views. The file
+ * must have been written on a host of the same endianness.
+ */
+chain_map_t *chain_map_open(char const *path)
+{
+	chain_map_t *map = calloc(1, sizeof(*map));
+
+	if (!map)
+		return (NULL);
+	if (chain_map_file(map, path))
+	{
+		free(map);
+		return (NULL);
+	}
+	if (map->size < HBLK_HEADER_SIZE || chain_map_index(map))
+	{
+		chain_map_close(map);
+		return (NULL);
+	}
+	return (map);
+}
+
+/**
+ * chain_map_file - maps a whole file read only
+ * @map: zeroed map, its base and size are set
+ * @path: file to map
+ * Return: 0 on success, 1 on fail
+ */
+int chain_map_file(chain_map_t *map, char const *path)
+{
+	struct stat st;
+	void *base;
+	int fd;
+
+	fd = path ? open(path, O_RDONLY) : -1;
+	if (fd == -1)
+		return (1);
+	if (fstat(fd, &st) || !st.st_size)
+	{
+		close(fd);
+		return (1);
+	}
+	base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (base == MAP_FAILED)
+		return (1);
+	map->base = base;
+	map->size = st.st_size;
+	return (0);
+}
+
+/**
+ * chain_map_close - unmaps a blockchain and frees its index
+ * @map: map to close
+ */
+void chain_map_close(chain_map_t *map)
+{
+	if (!map)
+		return;
+	munmap((void *)map->base, map->size);
+	free(map->blocks);
+	free(map->first_tx);
+	free(map->txs);
+	free(map);
+}
+
+/**
+ * chain_map_index - records the offset of every block and transaction
+ * @map: map holding the file
+ * Return: 0 on success, 1 if the file is malformed or truncated
+ */
+int chain_map_index(chain_map_t *map)
+{
+	uint8_t const *p = map->base;
+	size_t off = HBLK_HEADER_SIZE;
+	uint32_t i, len;
+	int32_t ntxs;
+
+	if (memcmp(p, FHEADER, 7) || p[7] != (uint8_t)END[0])
+		return (1);
+	memcpy(&map->nblocks, p + 8, 4);
+	memcpy(&map->nunspent, p + 12, 4);
+	/* Each block takes at least HBLK_BLOCK_SIZE(0) bytes */
+	if (map->nblocks > map->size / HBLK_BLOCK_SIZE(0))
+		return (1);
+	map->blocks = malloc((map->nblocks + 1) * sizeof(*map->blocks));
+	map->first_tx = malloc((map->nblocks + 1) * sizeof(*map->first_tx));
+	if (!map->blocks || !map->first_tx)
+		return (1);
+
+	for (i = 0; i < map->nblocks; i++)
+	{
+		map->blocks[i] = off;
+		map->first_tx[i] = map->ntxs;
+		if (map->size - off < HBLK_BLOCK_SIZE(0))
+			return (1);
+		memcpy(&len, p + off + sizeof(block_info_t), 4);
+		if (len > BLOCKCHAIN_DATA_MAX ||
+			map->size - off < HBLK_BLOCK_SIZE(len))
+			return (1);
+		memcpy(&ntxs, p + off + HBLK_BLOCK_SIZE(len) - 4, 4);
+		off += HBLK_BLOCK_SIZE(len);
+		if (ntxs < -1 || chain_map_txs(map, &off, ntxs))
+			return (1);
+	}
+	map->first_tx[i] = map->ntxs;
+	map->unspent = off;
+	if ((map->size - off) / HBLK_UNSPENT_SIZE < map->nunspent)
+		return (1);
+	return (0);
+}
+
+/**
+ * chain_map_txs - records the offsets of the transactions of a block
+ * @map: map holding the file
+ * @off: offset of the first transaction, moved past the last one
+ * @ntxs: number of transactions, -1 for none
+ * Return: 0 on success, 1 if the file is malformed or truncated
+ */
+int chain_map_txs(chain_map_t *map, size_t *off, int32_t ntxs)
+{
+	tx_view_t view;
+	size_t len;
+	int32_t i;
+
+	for (i = 0; i < ntxs; i++)
+	{
+		len = hblk_tx_view(map->base + *off, map->size - *off, &view);
+		if (!len || chain_map_push_tx(map, *off))
+			return (1);
+		*off += len;
+	}
+	return (0);
+}
+
+/**
+ * chain_map_push_tx - appends a transaction offset to the index
+ * @map: map being indexed
+ * @off: offset of the transaction record
+ * Return: 0 on success, 1 on fail
+ */
+int chain_map_push_tx(chain_map_t *map, size_t off)
+{
+	size_t capacity;
+	size_t *txs;
+
+	if (map->ntxs == map->txs_capacity)
+	{
+		capacity = map->txs_capacity ? map->txs_capacity * 2 : 64;
+		txs = realloc(map->txs, capacity * sizeof(*txs));
+		if (!txs)
+			return (1);
+		map->txs = txs;
+		map->txs_capacity = capacity;
+	}
+	map->txs[map->ntxs++] = off;
+	return (0);
+}
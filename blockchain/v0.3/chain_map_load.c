@@ -0,0 +1,206 @@
+#include "blockchain.h"
+
+/**
+ * chain_map_block - makes a mutable copy of a mapped block
+ * @map: mapped blockchain
+ * @i: index of the block
+ * Return: pointer to the block, with its transactions, or NULL
+ */
+block_t *chain_map_block(chain_map_t const *map, uint32_t i)
+{
+	block_view_t view;
+	block_t *block;
+
+	block = chain_map_header(map, i, &view);
+	if (!block || view.ntxs == -1)
+		return (block);
+	block->transactions = chain_map_block_txs(map, &view);
+	if (!block->transactions)
+	{
+		block_destroy(block);
+		return (NULL);
+	}
+	return (block);
+}
+
+/**
+ * chain_map_header - makes a mutable copy of a mapped block, without its
+ * transactions
+ * @map: mapped blockchain
+ * @i: index of the block
+ * @view: filled in with the view of the block
+ * Return: pointer to the block, its transactions NULL, or NULL
+ */
+block_t *chain_map_header(chain_map_t const *map, uint32_t i,
+	block_view_t *view)
+{
+	block_t *block;
+
+	if (chain_map_block_view(map, i, view))
+		return (NULL);
+	block = calloc(1, sizeof(*block));
+	if (!block)
+		return (NULL);
+	block->info = view->info;
+	block->data.len = view->data_len;
+	memcpy(block->data.buffer, view->data, view->data_len);
+	memcpy(block->hash, view->hash, SHA256_DIGEST_LENGTH);
+	return (block);
+}
+
+/**
+ * chain_map_block_txs - makes mutable copies of the transactions of a
+ * mapped block
+ * @map: mapped blockchain
+ * @view: view of the block
+ * Return: list of the transactions or NULL
+ */
+llist_t *chain_map_block_txs(chain_map_t const *map, block_view_t const *view)
+{
+	llist_t *txs = llist_create(MT_SUPPORT_FALSE);
+	transaction_t *tx;
+	int32_t j;
+
+	for (j = 0; txs && j < view->ntxs; j++)
+	{
+		tx = chain_map_tx(map, view->first_tx + j);
+		if (!tx || llist_add_node(txs, tx, ADD_NODE_REAR))
+		{
+			transaction_destroy(tx);
+			llist_destroy(txs, llist_size(txs) > 0,
+				(node_dtor_t)&transaction_destroy);
+			return (NULL);
+		}
+	}
+	return (txs);
+}
+
+/**
+ * chain_map_tx - makes a mutable copy of a mapped transaction
+ * @map: mapped blockchain
+ * @i: index of the transaction, counted across all the blocks
+ * Return: pointer to the transaction or NULL
+ */
+transaction_t *chain_map_tx(chain_map_t const *map, size_t i)
+{
+	tx_view_t view;
+
+	if (chain_map_tx_view(map, i, &view))
+		return (NULL);
+	return (hblk_tx_decode(&view));
+}
+
+/**
+ * hblk_tx_decode - makes a mutable copy of a viewed transaction
+ * @view: transaction records
+ * Return: pointer to the transaction or NULL
+ */
+transaction_t *hblk_tx_decode(tx_view_t const *view)
+{
+	transaction_t *tx;
+	ti_t *in;
+	to_t *out;
+	uint32_t j;
+
+	tx = calloc(1, sizeof(*tx));
+	if (!tx)
+		return (NULL);
+	memcpy(tx->id, view->id, SHA256_DIGEST_LENGTH);
+	tx->inputs = llist_create(MT_SUPPORT_FALSE);
+	tx->outputs = llist_create(MT_SUPPORT_FALSE);
+	if (!tx->inputs || !tx->outputs)
+		goto fail;
+	for (j = 0; j < view->nins; j++)
+	{
+		in = calloc(1, sizeof(*in));
+		if (!in || llist_add_node(tx->inputs, in, ADD_NODE_REAR))
+		{
+			free(in);
+			goto fail;
+		}
+		hblk_in_decode(view->ins + (size_t)j * HBLK_IN_SIZE, in);
+	}
+	for (j = 0; j < view->nouts; j++)
+	{
+		out = calloc(1, sizeof(*out));
+		if (!out || llist_add_node(tx->outputs, out, ADD_NODE_REAR))
+		{
+			free(out);
+			goto fail;
+		}
+		hblk_out_decode(view->outs + (size_t)j * HBLK_OUT_SIZE, out);
+	}
+	return (tx);
+fail:
+	transaction_destroy(tx);
+	return (NULL);
+}
+
+/**
+ * chain_map_unspent - makes a mutable copy of a mapped unspent output
+ * @map: mapped blockchain
+ * @i: index of the unspent output
+ * Return: pointer to the unspent output or NULL
+ */
+uto_t *chain_map_unspent(chain_map_t const *map, uint32_t i)
+{
+	uint8_t const *p;
+	uto_t *unspent;
+
+	if (!map || i >= map->nunspent)
+		return (NULL);
+	unspent = calloc(1, sizeof(*unspent));
+	if (!unspent)
+		return (NULL);
+	p = map->base + map->unspent + (size_t)i * HBLK_UNSPENT_SIZE;
+	memcpy(unspent->block_hash, &p[0], 32);
+	memcpy(unspent->tx_id, &p[32], 32);
+	hblk_out_decode(&p[64], &unspent->out);
+	return (unspent);
+}
+
+/**
+ * chain_map_blockchain - makes a mutable copy of a whole mapped blockchain
+ * @map: mapped blockchain
+ * Return: pointer to the blockchain, as blockchain_deserialize() loads it,
+ * or NULL
+ */
+blockchain_t *chain_map_blockchain(chain_map_t const *map)
+{
+	blockchain_t *blockchain;
+	void *node;
+	uint32_t i;
+
+	if (!map)
+		return (NULL);
+	blockchain = calloc(1, sizeof(*blockchain));
+	if (!blockchain)
+		return (NULL);
+	blockchain->chain = llist_create(MT_SUPPORT_FALSE);
+	blockchain->unspent = llist_create(MT_SUPPORT_FALSE);
+	if (!blockchain->chain || !blockchain->unspent)
+		goto fail;
+	for (i = 0; i < map->nblocks; i++)
+	{
+		node = chain_map_block(map, i);
+		if (!node || llist_add_node(blockchain->chain, node, ADD_NODE_REAR))
+		{
+			block_destroy(node);
+			goto fail;
+		}
+	}
+	for (i = 0; i < map->nunspent; i++)
+	{
+		node = chain_map_unspent(map, i);
+		if (!node || llist_add_node(blockchain->unspent, node, ADD_NODE_REAR))
+		{
+			free(node);
+			goto fail;
+		}
+	}
+	chain_store_sync(blockchain);
+	return (blockchain);
+fail:
+	blockchain_destroy(blockchain);
+	return (NULL);
+}
@@ -0,0 +1,100 @@
+#include "blockchain.h"
+
+/**
+ * chain_map_block_view - views a mapped block in place
+ * @map: mapped blockchain
+ * @i: index of the block
+ * @view: filled in with the block
+ * Return: 0 on success, 1 if there is no such block
+ */
+int chain_map_block_view(chain_map_t const *map, uint32_t i,
+	block_view_t *view)
+{
+	uint8_t const *p;
+
+	if (!map || !view || i >= map->nblocks)
+		return (1);
+	p = map->base + map->blocks[i];
+	memcpy(&view->info, p, sizeof(block_info_t));
+	memcpy(&view->data_len, p + sizeof(block_info_t), 4);
+	view->data = p + sizeof(block_info_t) + 4;
+	view->hash = view->data + view->data_len;
+	memcpy(&view->ntxs, view->hash + SHA256_DIGEST_LENGTH, 4);
+	view->first_tx = map->first_tx[i];
+	return (0);
+}
+
+/**
+ * chain_map_tx_view - views a mapped transaction in place
+ * @map: mapped blockchain
+ * @i: index of the transaction, counted across all the blocks
+ * @view: filled in with the transaction
+ * Return: 0 on success, 1 if there is no such transaction
+ */
+int chain_map_tx_view(chain_map_t const *map, size_t i, tx_view_t *view)
+{
+	uint8_t const *p;
+
+	if (!map || !view || i >= map->ntxs)
+		return (1);
+	p = map->base + map->txs[i];
+	view->id = p;
+	memcpy(&view->nins, p + 32, 4);
+	memcpy(&view->nouts, p + 36, 4);
+	view->ins = p + HBLK_TX_SIZE;
+	view->outs = view->ins + (size_t)view->nins * HBLK_IN_SIZE;
+	return (0);
+}
+
+/**
+ * hblk_tx_view - views a transaction record, checking it is all there
+ * @record: transaction record
+ * @size: number of bytes from @record to the end of the file
+ * @view: filled in with the transaction
+ * Return: size of the record with its inputs and outputs, 0 if truncated
+ */
+size_t hblk_tx_view(uint8_t const *record, size_t size, tx_view_t *view)
+{
+	size_t len = HBLK_TX_SIZE;
+
+	if (size < HBLK_TX_SIZE)
+		return (0);
+	view->id = record;
+	memcpy(&view->nins, record + 32, 4);
+	memcpy(&view->nouts, record + 36, 4);
+	/* Divide rather than multiply so huge counts can't overflow */
+	if ((size - len) / HBLK_IN_SIZE < view->nins)
+		return (0);
+	view->ins = record + len;
+	len += (size_t)view->nins * HBLK_IN_SIZE;
+	if ((size - len) / HBLK_OUT_SIZE < view->nouts)
+		return (0);
+	view->outs = record + len;
+	return (len + (size_t)view->nouts * HBLK_OUT_SIZE);
+}
+
+/**
+ * hblk_in_decode - copies an input record out of a serialized blockchain
+ * @record: input record, HBLK_IN_SIZE bytes
+ * @in: zeroed input to fill in
+ */
+void hblk_in_decode(uint8_t const *record, ti_t *in)
+{
+	memcpy(in->block_hash, &record[0], 32);
+	memcpy(in->tx_id, &record[32], 32);
+	memcpy(in->tx_out_hash, &record[64], 32);
+	memcpy(in->sig.sig, &record[96], 72);
+	memcpy(&in->sig.len, &record[168], 1);
+}
+
+/**
+ * hblk_out_decode - copies an output record out of a serialized blockchain
+ * @record: output record, HBLK_OUT_SIZE bytes
+ * @out: output to fill in
+ */
+void hblk_out_decode(uint8_t const *record, to_t *out)
+{
+	memcpy(&out->amount, &record[0], 4);
+	memcpy(out->pub, &record[4], 65);
+	memcpy(out->hash, &record[69], 32);
+}
@@ -0,0 +1,103 @@
+#include "blockchain.h"
+#include <errno.h>
+#include <fcntl.h>
+
+/**
+ * chain_reader_open - opens a serialized blockchain to read block by block
+ * @path: file to read
+ * Return: pointer to the reader or NULL
+ *
+ * Description: Unlike blockchain_deserialize(), only one block is held in
+ * memory at a time, so the memory used doesn't grow with the chain.
+ */
+chain_reader_t *chain_reader_open(char const *path)
+{
+	chain_reader_t *reader;
+	struct stat st;
+
+	if (!path)
+		return (NULL);
+	reader = calloc(1, sizeof(*reader));
+	if (!reader)
+		return (NULL);
+	reader->fd = open(path, O_RDONLY);
+	if (reader->fd == -1)
+	{
+		free(reader);
+		return (NULL);
+	}
+	reader->capacity = CHAIN_READER_BUF_SIZE;
+	reader->buf = malloc(reader->capacity);
+	if (!reader->buf || fstat(reader->fd, &st))
+		goto fail;
+	reader->left = st.st_size;
+	if (chain_reader_fill(reader, HBLK_HEADER_SIZE) ||
+		memcmp(reader->buf, FHEADER, 7) || reader->buf[7] != (uint8_t)END[0])
+		goto fail;
+	memcpy(&reader->nblocks, reader->buf + 8, 4);
+	memcpy(&reader->nunspent, reader->buf + 12, 4);
+	reader->start = HBLK_HEADER_SIZE;
+	return (reader);
+fail:
+	chain_reader_close(reader);
+	return (NULL);
+}
+
+/**
+ * chain_reader_close - closes a reader, and frees the last block it yielded
+ * @reader: reader to close
+ */
+void chain_reader_close(chain_reader_t *reader)
+{
+	if (!reader)
+		return;
+	block_destroy(reader->block);
+	close(reader->fd);
+	free(reader->buf);
+	free(reader);
+}
+
+/**
+ * chain_reader_fill - makes sure the decode buffer holds the next bytes
+ * @reader: reader
+ * @len: number of bytes needed from the next record on
+ * Return: 0 on success, 1 if the file is too short or can't be read
+ *
+ * Description: The bytes already used are dropped from the front of the
+ * buffer first, it only grows when a single record doesn't fit.
+ */
+int chain_reader_fill(chain_reader_t *reader, size_t len)
+{
+	uint8_t *buf;
+	ssize_t n;
+
+	if (reader->end - reader->start >= len)
+		return (0);
+	/* Checked first so a bogus count can't make the buffer grow */
+	if (len - (reader->end - reader->start) > reader->left)
+		return (1);
+	memmove(reader->buf, reader->buf + reader->start,
+		reader->end - reader->start);
+	reader->end -= reader->start;
+	reader->start = 0;
+	if (len > reader->capacity)
+	{
+		buf = realloc(reader->buf, len);
+		if (!buf)
+			return (1);
+		reader->buf = buf;
+		reader->capacity = len;
+	}
+	while (reader->end < len)
+	{
+		n = read(reader->fd, reader->buf + reader->end,
+			reader->capacity - reader->end);
+		if (n == -1 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return (1);
+		reader->end += n;
+		reader->left -= (size_t)n < reader->left ? (size_t)n : reader->left;
+	}
+	return (0);
+}
@@ -0,0 +1,95 @@
+#include "blockchain.h"
+
+/**
+ * chain_reader_next_block - reads the next block of a chain file
+ * @reader: reader
+ * Return: pointer to the block, owned by the reader and valid until the
+ * next call, or NULL once all the blocks were read or on fail
+ */
+block_t const *chain_reader_next_block(chain_reader_t *reader)
+{
+	size_t size;
+
+	if (!reader)
+		return (NULL);
+	block_destroy(reader->block);
+	reader->block = NULL;
+	if (reader->error || reader->read >= reader->nblocks)
+		return (NULL);
+	size = chain_reader_block_size(reader);
+	if (size)
+		reader->block = hblk_block_decode(reader->buf + reader->start, size);
+	if (!reader->block)
+	{
+		reader->error = 1;
+		return (NULL);
+	}
+	reader->start += size;
+	reader->read++;
+	return (reader->block);
+}
+
+/**
+ * chain_reader_block_size - brings the next block record in the buffer
+ * @reader: reader
+ * Return: size of the record with its transactions, 0 on fail
+ */
+size_t chain_reader_block_size(chain_reader_t *reader)
+{
+	size_t size;
+	uint32_t len, nins, nouts;
+	int32_t ntxs, i;
+	uint8_t const *p;
+
+	if (chain_reader_fill(reader, HBLK_BLOCK_SIZE(0)))
+		return (0);
+	memcpy(&len, reader->buf + reader->start + sizeof(block_info_t), 4);
+	if (len > BLOCKCHAIN_DATA_MAX ||
+		chain_reader_fill(reader, HBLK_BLOCK_SIZE(len)))
+		return (0);
+	size = HBLK_BLOCK_SIZE(len);
+	memcpy(&ntxs, reader->buf + reader->start + size - 4, 4);
+	if (ntxs < -1)
+		return (0);
+	/* Each transaction record gives the counts its length depends on */
+	for (i = 0; i < ntxs; i++)
+	{
+		if (chain_reader_fill(reader, size + HBLK_TX_SIZE))
+			return (0);
+		p = reader->buf + reader->start + size;
+		memcpy(&nins, p + 32, 4);
+		memcpy(&nouts, p + 36, 4);
+		size += HBLK_TX_SIZE + (size_t)nins * HBLK_IN_SIZE +
+			(size_t)nouts * HBLK_OUT_SIZE;
+		if (chain_reader_fill(reader, size))
+			return (0);
+	}
+	return (size);
+}
+
+/**
+ * chain_reader_next_unspent - reads the next unspent output of a chain file
+ * @reader: reader, done with the blocks
+ * Return: pointer to the unspent output, owned by the reader and valid
+ * until the next call, or NULL once all of them were read or on fail
+ */
+uto_t const *chain_reader_next_unspent(chain_reader_t *reader)
+{
+	uint8_t const *p;
+
+	if (!reader || reader->error || reader->read < reader->nblocks ||
+		reader->read - reader->nblocks >= reader->nunspent)
+		return (NULL);
+	if (chain_reader_fill(reader, HBLK_UNSPENT_SIZE))
+	{
+		reader->error = 1;
+		return (NULL);
+	}
+	p = reader->buf + reader->start;
+	memcpy(reader->unspent.block_hash, p, SHA256_DIGEST_LENGTH);
+	memcpy(reader->unspent.tx_id, p + 32, SHA256_DIGEST_LENGTH);
+	hblk_out_decode(p + 64, &reader->unspent.out);
+	reader->start += HBLK_UNSPENT_SIZE;
+	reader->read++;
+	return (&reader->unspent);
+}
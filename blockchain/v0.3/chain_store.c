@@ -0,0 +1,197 @@
+#include "blockchain.h"
+
+int chain_store_add(llist_node_t block, unsigned int iter, void *store);
+
+/**
+ * blockchain_block_at - gets the block of a chain at a given height
+ * @blockchain: chain
+ * @height: height of the block, 0 for the genesis block
+ * Return: pointer to the block, or NULL if the chain is shorter
+ *
+ * Description: Constant time while the store is in step with the chain,
+ * a walk of the list otherwise. The chain is only read.
+ */
+block_t *blockchain_block_at(blockchain_t const *blockchain,
+	uint32_t height)
+{
+	if (!blockchain)
+		return (NULL);
+	if (!chain_store_fresh(blockchain))
+		return (llist_get_node_at(blockchain->chain, height));
+	if (height >= blockchain->store.count)
+		return (NULL);
+	return (blockchain->store.blocks[height]);
+}
+
+/**
+ * blockchain_tip - gets the last block of a chain
+ * @blockchain: chain
+ * Return: pointer to the block, or NULL if the chain is empty
+ */
+block_t *blockchain_tip(blockchain_t const *blockchain)
+{
+	if (!blockchain)
+		return (NULL);
+	if (!chain_store_fresh(blockchain))
+		return (llist_get_tail(blockchain->chain));
+	return (blockchain->store.blocks[blockchain->store.count - 1]);
+}
+
+/**
+ * blockchain_add_block - appends a block to a chain
+ * @blockchain: chain
+ * @block: block to append, owned by the chain on success
+ * Return: 0 on success, 1 on fail
+ *
+ * Description: The block is filed in the store under the hash it has
+ * now, it has to be mined before it is appended.
+ */
+int blockchain_add_block(blockchain_t *blockchain, block_t *block)
+{
+	int fresh;
+
+	if (!blockchain || !block)
+		return (1);
+	fresh = chain_store_fresh(blockchain);
+	if (llist_add_node(blockchain->chain, block, ADD_NODE_REAR))
+		return (1);
+	blockchain->edits++;
+	/* Failing here only leaves the store stale, reads then walk the list */
+	if (fresh && !chain_store_push(&blockchain->store, block))
+		blockchain->store.edits = blockchain->edits;
+	else if (!fresh)
+		chain_store_sync(blockchain);
+	return (0);
+}
+
+/**
+ * chain_store_for_each - calls a function on each block of a chain, as
+ * llist_for_each() on the chain would, walking the store instead
+ * @blockchain: chain
+ * @action: function called with each block, its height and @arg
+ * @arg: passed to @action
+ * Return: 0 on success, -1 on fail or if @action returned non zero
+ */
+int chain_store_for_each(blockchain_t const *blockchain, node_func_t action,
+	void *arg)
+{
+	uint32_t i;
+
+	if (!blockchain || !action)
+		return (-1);
+	if (!chain_store_fresh(blockchain))
+		return (llist_for_each(blockchain->chain, action, arg));
+	for (i = 0; i < blockchain->store.count; i++)
+		if (action(blockchain->store.blocks[i], i, arg))
+			return (-1);
+	return (0);
+}
+
+/**
+ * chain_store_fresh - tells if the store of a chain is in step with its list
+ * @blockchain: chain
+ * Return: 1 if the store holds the blocks of the list, 0 otherwise
+ *
+ * Description: The store is in step while the chain's edit count is the
+ * one it was filled at. The size and both ends of the list are compared
+ * too, so a block appended to or taken out of an end without counting
+ * the edit is seen. A block replaced in the middle, or hashed again,
+ * without counting the edit isn't: reads would return the old block.
+ */
+int chain_store_fresh(blockchain_t const *blockchain)
+{
+	chain_store_t const *store = &blockchain->store;
+	int size = llist_size(blockchain->chain);
+
+	return (store->edits == blockchain->edits &&
+		size > 0 && (uint32_t)size == store->count &&
+		store->blocks[0] == llist_get_head(blockchain->chain) &&
+		store->blocks[size - 1] == llist_get_tail(blockchain->chain));
+}
+
+/**
+ * chain_store_sync - fills the store of a chain again from its list
+ * @blockchain: chain
+ * Return: 0 on success, 1 on fail, the store is then left empty
+ *
+ * Description: Blocks appended with blockchain_add_block(), and chains
+ * made by blockchain_create() or loaded from a file, are kept in the
+ * store already. Code changing the list otherwise, or the hash of a block
+ * already in it, increments the chain's edit count: reads then walk the
+ * list until this is called. Not thread safe: no other thread may read
+ * the chain meanwhile.
+ */
+int chain_store_sync(blockchain_t *blockchain)
+{
+	chain_store_t *store = &blockchain->store;
+
+	store->edits = blockchain->edits;
+	store->count = 0;
+	if (store->slots)
+		memset(store->slots, 0, 2 * store->capacity * sizeof(*store->slots));
+	if (store->txs)
+		memset(store->txs, 0, store->tx_capacity * sizeof(*store->txs));
+	store->tx_count = 0;
+	if (llist_for_each(blockchain->chain, chain_store_add, store))
+	{
+		store->count = 0;
+		return (1);
+	}
+	return (0);
+}
+
+/**
+ * chain_store_push - appends a block to a store, doubling it when full
+ * @store: store
+ * @block: block
+ * Return: 0 on success, 1 on fail
+ *
+ * Description: The hash table is sized along with the array and filled
+ * again when it grows, so it stays at most half full.
+ */
+int chain_store_push(chain_store_t *store, block_t *block)
+{
+	block_t **blocks;
+	uint32_t capacity, *slots, i;
+
+	if (store->count == store->capacity)
+	{
+		capacity = store->capacity ? store->capacity * 2 : 64;
+		blocks = realloc(store->blocks, capacity * sizeof(*blocks));
+		if (blocks)
+			store->blocks = blocks;
+		slots = blocks ? calloc(2 * capacity, sizeof(*slots)) : NULL;
+		if (!slots)
+		{
+			store->count = 0;
+			return (1);
+		}
+		free(store->slots);
+		store->slots = slots;
+		store->capacity = capacity;
+		for (i = 0; i < store->count; i++)
+			chain_store_index(store, i);
+	}
+	store->blocks[store->count] = block;
+	chain_store_index(store, store->count);
+	if (store->txs && chain_store_index_txs(store, store->count))
+	{
+		store->count = 0;
+		return (1);
+	}
+	store->count++;
+	return (0);
+}
+
+/**
+ * chain_store_add - llist_for_each() action appending a block to a store
+ * @block: block
+ * @iter: height of the block (unused)
+ * @store: store
+ * Return: 0 on success, 1 on fail
+ */
+int chain_store_add(llist_node_t block, unsigned int iter, void *store)
+{
+	(void)iter;
+	return (chain_store_push(store, block));
+}
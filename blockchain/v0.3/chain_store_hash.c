@@ -0,0 +1,80 @@
+#include "blockchain.h"
+
+/**
+ * blockchain_find_block - looks a block of a chain up by its hash
+ * @blockchain: chain
+ * @hash: hash of the block
+ * Return: pointer to the block, or NULL if the chain holds no such block
+ *
+ * Description: Constant time while the store is in step with the chain,
+ * a walk of the list otherwise. The chain is only read. Blocks are filed
+ * by hash when they are appended or loaded, so code hashing a block again
+ * once in the chain counts the edit, as for any other change.
+ * When several blocks share a hash, the lowest one is found.
+ */
+block_t *blockchain_find_block(blockchain_t const *blockchain,
+	uint8_t const hash[SHA256_DIGEST_LENGTH])
+{
+	chain_store_t const *store;
+	uint32_t height;
+
+	if (!blockchain || !hash)
+		return (NULL);
+	if (!chain_store_fresh(blockchain))
+		return (llist_find_node(blockchain->chain, chain_block_has_hash,
+			(void *)hash));
+	store = &blockchain->store;
+	height = store->slots[chain_store_slot(store, hash)];
+	return (height ? store->blocks[height - 1] : NULL);
+}
+
+/**
+ * chain_block_has_hash - llist_find_node() identifier matching a block hash
+ * @block: block
+ * @hash: hash looked for, only read
+ * Return: 1 if @block has @hash, 0 otherwise
+ */
+int chain_block_has_hash(llist_node_t block, void *hash)
+{
+	return (!memcmp(((block_t *)block)->hash, hash, SHA256_DIGEST_LENGTH));
+}
+
+/**
+ * chain_store_index - files a block of a store in its hash table
+ * @store: store, with room for the block in its table
+ * @height: height of the block
+ *
+ * Description: A block whose hash is already filed is left out, the
+ * table keeps the lowest one.
+ */
+void chain_store_index(chain_store_t *store, uint32_t height)
+{
+	uint32_t i = chain_store_slot(store, store->blocks[height]->hash);
+
+	if (!store->slots[i])
+		store->slots[i] = height + 1;
+}
+
+/**
+ * chain_store_slot - finds the slot of a block hash, or where it would go
+ * @store: store
+ * @hash: hash of the block
+ * Return: index of the matching slot, or of the empty slot ending the probe
+ *
+ * Description: The hash is already a SHA-256 digest, its first eight
+ * bytes are uniform enough. Linear probing; the table is at most half
+ * full, so an empty slot exists.
+ */
+uint32_t chain_store_slot(chain_store_t const *store,
+	uint8_t const hash[SHA256_DIGEST_LENGTH])
+{
+	uint32_t mask = 2 * store->capacity - 1, i;
+	uint64_t key;
+
+	memcpy(&key, hash, sizeof(key));
+	for (i = key & mask; store->slots[i]; i = (i + 1) & mask)
+		if (!memcmp(store->blocks[store->slots[i] - 1]->hash, hash,
+			SHA256_DIGEST_LENGTH))
+			return (i);
+	return (i);
+}
@@ -0,0 +1,198 @@
+#include "blockchain.h"
+
+/**
+ * blockchain_index_txs - starts keeping the transactions of a chain in a
+ * table by ID
+ * @blockchain: chain
+ * Return: 0 on success, 1 on fail
+ *
+ * Description: The table is filled with one walk of the chain, then kept
+ * up to date as blocks are appended. Transactions added to a block
+ * already in the chain aren't seen: a block has to be complete before it
+ * is appended.
+ */
+int blockchain_index_txs(blockchain_t *blockchain)
+{
+	chain_store_t *store;
+
+	if (!blockchain)
+		return (1);
+	store = &blockchain->store;
+	if (store->txs)
+		return (0);
+	store->txs = calloc(UTXO_SET_MIN, sizeof(*store->txs));
+	if (!store->txs)
+		return (1);
+	store->tx_capacity = UTXO_SET_MIN;
+	return (chain_store_sync(blockchain));
+}
+
+/**
+ * blockchain_find_tx - looks a transaction of a chain up by its ID
+ * @blockchain: chain, with its transactions indexed
+ * @id: ID of the transaction
+ * @height: set to the height of the block holding it, may be NULL
+ * @pos: set to its position in the block, may be NULL
+ * Return: pointer to the transaction, or NULL if the chain holds no such
+ * transaction or its transactions aren't indexed
+ *
+ * Description: Constant time while the store is in step with the chain,
+ * a walk of every transaction otherwise. The chain is only read.
+ */
+transaction_t *blockchain_find_tx(blockchain_t const *blockchain,
+	uint8_t const id[SHA256_DIGEST_LENGTH], uint32_t *height,
+	uint32_t *pos)
+{
+	chain_tx_find_t find = {NULL, NULL, 0, 0};
+	chain_tx_slot_t const *slot;
+
+	if (!blockchain || !id || !blockchain->store.txs)
+		return (NULL);
+	if (chain_store_fresh(blockchain))
+	{
+		slot = &blockchain->store.txs[chain_tx_slot(&blockchain->store, id)];
+		find.tx = slot->tx, find.height = slot->height, find.pos = slot->pos;
+	}
+	else
+	{
+		find.id = id;
+		llist_for_each(blockchain->chain, chain_tx_find_block, &find);
+	}
+	if (find.tx && height)
+		*height = find.height;
+	if (find.tx && pos)
+		*pos = find.pos;
+	return (find.tx);
+}
+
+/**
+ * chain_tx_find_block - llist_for_each() action looking a transaction up
+ * in a block
+ * @block: block
+ * @height: height of @block
+ * @find: search, as a chain_tx_find_t
+ * Return: 1 once the transaction is found, to stop the walk, 0 otherwise
+ */
+int chain_tx_find_block(llist_node_t block, unsigned int height, void *find)
+{
+	((chain_tx_find_t *)find)->height = height;
+	if (((block_t *)block)->transactions)
+		llist_for_each(((block_t *)block)->transactions, chain_tx_find_tx,
+			find);
+	return (((chain_tx_find_t *)find)->tx != NULL);
+}
+
+/**
+ * chain_tx_find_tx - llist_for_each() action matching a transaction ID
+ * @tx: transaction
+ * @pos: position of @tx in its block
+ * @find: search, as a chain_tx_find_t
+ * Return: 1 if @tx is the one looked for, to stop the walk, 0 otherwise
+ */
+int chain_tx_find_tx(llist_node_t tx, unsigned int pos, void *find)
+{
+	chain_tx_find_t *f = find;
+
+	if (memcmp(((transaction_t *)tx)->id, f->id, SHA256_DIGEST_LENGTH))
+		return (0);
+	f->tx = tx;
+	f->pos = pos;
+	return (1);
+}
+
+/**
+ * chain_store_index_txs - files the transactions of a block of a store
+ * @store: store, with a transaction table
+ * @height: height of the block, loaded first if it is pending
+ * Return: 0 on success, 1 on fail
+ */
+int chain_store_index_txs(chain_store_t *store, uint32_t height)
+{
+	chain_tx_ctx_t ctx;
+
+	ctx.store = store;
+	ctx.height = height;
+	/* A pending block of a lazy chain gets its transactions loaded */
+	if (store->blocks[height]->lazy && !chain_lazy_txs(
+		store->blocks[height]->lazy, store->blocks[height]))
+		return (1);
+	if (!store->blocks[height]->transactions)
+		return (0);
+	return (llist_for_each(store->blocks[height]->transactions,
+		chain_tx_add, &ctx) != 0);
+}
+
+/**
+ * chain_tx_add - llist_for_each() action filing a transaction of a block
+ * @tx: transaction
+ * @pos: position of @tx in its block
+ * @ctx: block, as a chain_tx_ctx_t
+ * Return: 0 on success, 1 on fail
+ *
+ * Description: A transaction whose ID is already filed is left out, the
+ * table keeps the lowest one.
+ */
+int chain_tx_add(llist_node_t tx, unsigned int pos, void *ctx)
+{
+	chain_store_t *store = ((chain_tx_ctx_t *)ctx)->store;
+	chain_tx_slot_t *slot;
+
+	/* Same load bound as a utxo_set_t */
+	if ((store->tx_count + 1) * UTXO_SET_LOAD_DEN >
+		store->tx_capacity * UTXO_SET_LOAD_NUM &&
+		chain_tx_grow(store, store->tx_capacity * 2))
+		return (1);
+	slot = &store->txs[chain_tx_slot(store, ((transaction_t *)tx)->id)];
+	if (slot->tx)
+		return (0);
+	slot->tx = tx;
+	slot->height = ((chain_tx_ctx_t *)ctx)->height;
+	slot->pos = pos;
+	store->tx_count++;
+	return (0);
+}
+
+/**
+ * chain_tx_grow - moves every transaction of a store to a bigger table
+ * @store: store
+ * @capacity: new number of slots, a power of two
+ * Return: 0 on success, 1 on fail, the table is then left untouched
+ */
+int chain_tx_grow(chain_store_t *store, uint32_t capacity)
+{
+	chain_tx_slot_t *txs = calloc(capacity, sizeof(*txs)), *old = store->txs;
+	uint32_t i, old_capacity = store->tx_capacity;
+
+	if (!txs)
+		return (1);
+	store->txs = txs;
+	store->tx_capacity = capacity;
+	for (i = 0; i < old_capacity; i++)
+		if (old[i].tx)
+			txs[chain_tx_slot(store, old[i].tx->id)] = old[i];
+	free(old);
+	return (0);
+}
+
+/**
+ * chain_tx_slot - finds the slot of a transaction ID, or where it would go
+ * @store: store, with a transaction table
+ * @id: transaction ID
+ * Return: index of the matching slot, or of the empty slot ending the probe
+ *
+ * Description: The ID is already a SHA-256 digest, its first eight bytes
+ * are uniform enough. Linear probing; the load factor guarantees an empty
+ * slot exists.
+ */
+uint32_t chain_tx_slot(chain_store_t const *store,
+	uint8_t const id[SHA256_DIGEST_LENGTH])
+{
+	uint32_t mask = store->tx_capacity - 1, i;
+	uint64_t key;
+
+	memcpy(&key, id, sizeof(key));
+	for (i = key & mask; store->txs[i].tx; i = (i + 1) & mask)
+		if (!memcmp(store->txs[i].tx->id, id, SHA256_DIGEST_LENGTH))
+			return (i);
+	return (i);
+}
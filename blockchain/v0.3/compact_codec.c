@@ -0,0 +1,138 @@
+#include "blockchain.h"
+
+/**
+ * compact_put_varint - writes an unsigned LEB128 varint
+ * @sb: staging buffer
+ * @value: value to write, 7 bits per byte, low bits first
+ */
+void compact_put_varint(serial_buf_t *sb, uint64_t value)
+{
+	uint8_t *p = serial_reserve(sb, 10);
+	size_t len = 0;
+
+	if (!p)
+		return;
+	while (value >= 0x80)
+	{
+		p[len++] = (value & 0x7f) | 0x80;
+		value >>= 7;
+	}
+	p[len++] = value;
+	/* Give back what the varint didn't use */
+	sb->len -= 10 - len;
+}
+
+/**
+ * compact_put_pub - writes a public key, compressed if it is a point
+ * @cw: compact writer
+ * @pub: public key
+ * @flags: bits to set in the key tag
+ *
+ * Description: A key that isn't an uncompressed point of the curve can't
+ * be compressed without loss, it is kept whole behind COMPACT_PUB_RAW.
+ */
+void compact_put_pub(compact_writer_t *cw, uint8_t const pub[EC_PUB_LEN],
+	uint8_t flags)
+{
+	uint8_t *p = serial_reserve(&cw->sb, EC_PUB_LEN + 1);
+
+	if (!p)
+		return;
+	if (pub[0] == POINT_CONVERSION_UNCOMPRESSED &&
+		EC_POINT_oct2point(cw->group, cw->point, pub, EC_PUB_LEN, cw->ctx) &&
+		EC_POINT_point2oct(cw->group, cw->point,
+			POINT_CONVERSION_COMPRESSED, p, 33, cw->ctx) == 33)
+	{
+		cw->sb.len -= EC_PUB_LEN + 1 - 33;
+		p[0] |= flags;
+		return;
+	}
+	p[0] = COMPACT_PUB_RAW | flags;
+	memcpy(p + 1, pub, EC_PUB_LEN);
+}
+
+/**
+ * compact_get_varint - reads an unsigned LEB128 varint
+ * @cr: compact reader
+ * Return: the value, 0 once reading failed
+ */
+uint64_t compact_get_varint(compact_reader_t *cr)
+{
+	uint64_t value = 0;
+	unsigned int shift;
+	uint8_t byte;
+
+	for (shift = 0; shift < 64 && cr->left; shift += 7)
+	{
+		byte = *cr->p++;
+		cr->left--;
+		value |= (uint64_t)(byte & 0x7f) << shift;
+		if (!(byte & 0x80))
+			return (value);
+	}
+	cr->error = 1;
+	return (0);
+}
+
+/**
+ * compact_get - reads raw bytes
+ * @cr: compact reader
+ * @dst: where to copy the bytes, left alone once reading failed
+ * @len: number of bytes
+ */
+void compact_get(compact_reader_t *cr, void *dst, size_t len)
+{
+	if (cr->error || cr->left < len)
+	{
+		cr->error = 1;
+		return;
+	}
+	memcpy(dst, cr->p, len);
+	cr->p += len;
+	cr->left -= len;
+}
+
+/**
+ * compact_get_pub - reads a public key, decompressing it if needed
+ * @cr: compact reader
+ * @pub: filled in with the 65 byte key
+ * Return: flags of the key tag
+ */
+uint8_t compact_get_pub(compact_reader_t *cr, uint8_t pub[EC_PUB_LEN])
+{
+	uint8_t tag = COMPACT_PUB_RAW, x[33];
+
+	compact_get(cr, &tag, 1);
+	if ((tag & ~COMPACT_HASH_STORED) == COMPACT_PUB_RAW)
+	{
+		compact_get(cr, pub, EC_PUB_LEN);
+		return (tag & COMPACT_HASH_STORED);
+	}
+	x[0] = tag & ~COMPACT_HASH_STORED;
+	compact_get(cr, x + 1, 32);
+	if (cr->error || (x[0] != COMPACT_PUB_EVEN && x[0] != COMPACT_PUB_ODD) ||
+		!EC_POINT_oct2point(cr->group, cr->point, x, 33, cr->ctx) ||
+		EC_POINT_point2oct(cr->group, cr->point,
+			POINT_CONVERSION_UNCOMPRESSED, pub, EC_PUB_LEN, cr->ctx) !=
+		EC_PUB_LEN)
+		cr->error = 1;
+	return (tag & COMPACT_HASH_STORED);
+}
+
+/**
+ * compact_get_out - reads a transaction output
+ * @cr: compact reader
+ * @out: output to fill in
+ *
+ * Description: Unless it was stored, the hash is computed back the way
+ * tx_out_create() does.
+ */
+void compact_get_out(compact_reader_t *cr, to_t *out)
+{
+	out->amount = compact_get_varint(cr);
+	if (compact_get_pub(cr, out->pub))
+		compact_get(cr, out->hash, SHA256_DIGEST_LENGTH);
+	else
+		SHA256((uint8_t const *)out, sizeof(out->amount) + EC_PUB_LEN,
+			out->hash);
+}
@@ -0,0 +1,105 @@
+#include "blockchain.h"
+
+/* Castagnoli polynomial, reflected */
+#define CRC32C_POLY 0x82f63b78
+
+int crc32c_sw_supported(void);
+uint32_t crc32c_sw(uint32_t crc, uint8_t const *buf, size_t len);
+void crc32c_pick(void);
+
+/* Every kernel, fastest first */
+crc32c_kernel_t const crc32c_kernels[] = {
+	{"sse4.2", crc32c_sse42_supported, crc32c_sse42},
+	{"armv8", crc32c_armv8_supported, crc32c_armv8},
+	{"slice8", crc32c_sw_supported, crc32c_sw},
+	{NULL, NULL, NULL}
+};
+
+crc32c_kernel_t const *crc32c_best;
+uint32_t crc32c_table[8][256];
+pthread_once_t crc32c_once = PTHREAD_ONCE_INIT;
+
+/**
+ * crc32c - Updates a CRC-32C with the fastest kernel the CPU can run
+ * @crc: CRC of the bytes before @buf, 0 to start
+ * @buf: bytes to add
+ * @len: number of bytes
+ * Return: CRC of the bytes before @buf followed by @buf
+ */
+uint32_t crc32c(uint32_t crc, void const *buf, size_t len)
+{
+	pthread_once(&crc32c_once, crc32c_pick);
+	return (crc32c_best->update(crc, buf, len));
+}
+
+/**
+ * crc32c_kernel - Gets the fastest CRC-32C kernel the CPU can run
+ * Return: pointer to the kernel, the table driven one at worst
+ */
+crc32c_kernel_t const *crc32c_kernel(void)
+{
+	pthread_once(&crc32c_once, crc32c_pick);
+	return (crc32c_best);
+}
+
+/**
+ * crc32c_pick - Fills the software tables and selects the fastest
+ * supported kernel, run once
+ */
+void crc32c_pick(void)
+{
+	crc32c_kernel_t const *kernel = crc32c_kernels;
+	uint32_t i, j, crc;
+
+	for (i = 0; i < 256; i++)
+	{
+		for (crc = i, j = 0; j < 8; j++)
+			crc = crc >> 1 ^ (crc & 1 ? CRC32C_POLY : 0);
+		crc32c_table[0][i] = crc;
+	}
+	/* Table k gives the CRC of a byte followed by k zero bytes */
+	for (i = 0; i < 256; i++)
+		for (j = 1; j < 8; j++)
+			crc32c_table[j][i] = crc32c_table[j - 1][i] >> 8 ^
+				crc32c_table[0][crc32c_table[j - 1][i] & 0xff];
+	while (!kernel->supported())
+		kernel++;
+	crc32c_best = kernel;
+}
+
+/**
+ * crc32c_sw_supported - The table driven kernel runs everywhere
+ * Return: Always 1
+ */
+int crc32c_sw_supported(void)
+{
+	return (1);
+}
+
+/**
+ * crc32c_sw - Updates a CRC-32C eight bytes at a time with lookup tables
+ * @crc: CRC of the bytes before @buf
+ * @buf: bytes to add
+ * @len: number of bytes
+ * Return: updated CRC
+ */
+uint32_t crc32c_sw(uint32_t crc, uint8_t const *buf, size_t len)
+{
+	uint32_t lo, hi;
+
+	crc = ~crc;
+	for (; len >= 8; len -= 8, buf += 8)
+	{
+		lo = crc ^ ((uint32_t)buf[0] | (uint32_t)buf[1] << 8 |
+			(uint32_t)buf[2] << 16 | (uint32_t)buf[3] << 24);
+		hi = (uint32_t)buf[4] | (uint32_t)buf[5] << 8 |
+			(uint32_t)buf[6] << 16 | (uint32_t)buf[7] << 24;
+		crc = crc32c_table[7][lo & 0xff] ^ crc32c_table[6][lo >> 8 & 0xff] ^
+			crc32c_table[5][lo >> 16 & 0xff] ^ crc32c_table[4][lo >> 24] ^
+			crc32c_table[3][hi & 0xff] ^ crc32c_table[2][hi >> 8 & 0xff] ^
+			crc32c_table[1][hi >> 16 & 0xff] ^ crc32c_table[0][hi >> 24];
+	}
+	while (len--)
+		crc = crc >> 8 ^ crc32c_table[0][(crc ^ *buf++) & 0xff];
+	return (~crc);
+}
@@ -0,0 +1,128 @@
+#include "blockchain.h"
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+
+/**
+ * crc32c_sse42_supported - Checks for the SSE4.2 CRC32 instruction
+ * Return: 1 if the CPU has it, 0 otherwise
+ */
+int crc32c_sse42_supported(void)
+{
+	__builtin_cpu_init();
+	return (__builtin_cpu_supports("sse4.2"));
+}
+
+/**
+ * crc32c_sse42 - Updates a CRC-32C with the SSE4.2 CRC32 instruction
+ * @crc: CRC of the bytes before @buf
+ * @buf: bytes to add
+ * @len: number of bytes
+ * Return: updated CRC
+ */
+__attribute__((target("sse4.2")))
+uint32_t crc32c_sse42(uint32_t crc, uint8_t const *buf, size_t len)
+{
+	uint64_t c = ~crc, word;
+
+	for (; len >= 8; len -= 8, buf += 8)
+	{
+		memcpy(&word, buf, 8);
+		c = _mm_crc32_u64(c, word);
+	}
+	while (len--)
+		c = _mm_crc32_u8((uint32_t)c, *buf++);
+	return (~(uint32_t)c);
+}
+
+#else
+
+/**
+ * crc32c_sse42_supported - Checks for the SSE4.2 CRC32 instruction
+ * Return: Always 0 outside of x86-64
+ */
+int crc32c_sse42_supported(void)
+{
+	return (0);
+}
+
+/**
+ * crc32c_sse42 - Stand-in for the SSE4.2 kernel outside of x86-64
+ * @crc: CRC of the bytes before @buf
+ * @buf: bytes to add
+ * @len: number of bytes
+ * Return: @crc
+ */
+uint32_t crc32c_sse42(uint32_t crc, uint8_t const *buf, size_t len)
+{
+	(void)buf, (void)len;
+	return (crc);
+}
+
+#endif
+
+#if defined(__aarch64__)
+#include <arm_acle.h>
+#include <sys/auxv.h>
+
+#ifndef HWCAP_CRC32
+#define HWCAP_CRC32 (1 << 7)
+#endif
+
+/**
+ * crc32c_armv8_supported - Checks for the ARMv8 CRC32 instructions
+ * Return: 1 if the CPU has them, 0 otherwise
+ */
+int crc32c_armv8_supported(void)
+{
+	return ((getauxval(AT_HWCAP) & HWCAP_CRC32) != 0);
+}
+
+/**
+ * crc32c_armv8 - Updates a CRC-32C with the ARMv8 CRC32 instructions
+ * @crc: CRC of the bytes before @buf
+ * @buf: bytes to add
+ * @len: number of bytes
+ * Return: updated CRC
+ */
+__attribute__((target("+crc")))
+uint32_t crc32c_armv8(uint32_t crc, uint8_t const *buf, size_t len)
+{
+	uint64_t word;
+
+	crc = ~crc;
+	for (; len >= 8; len -= 8, buf += 8)
+	{
+		memcpy(&word, buf, 8);
+		crc = __crc32cd(crc, word);
+	}
+	while (len--)
+		crc = __crc32cb(crc, *buf++);
+	return (~crc);
+}
+
+#else
+
+/**
+ * crc32c_armv8_supported - Checks for the ARMv8 CRC32 instructions
+ * Return: Always 0 outside of AArch64
+ */
+int crc32c_armv8_supported(void)
+{
+	return (0);
+}
+
+/**
+ * crc32c_armv8 - Stand-in for the ARMv8 kernel outside of AArch64
+ * @crc: CRC of the bytes before @buf
+ * @buf: bytes to add
+ * @len: number of bytes
+ * Return: @crc
+ */
+uint32_t crc32c_armv8(uint32_t crc, uint8_t const *buf, size_t len)
+{
+	(void)buf, (void)len;
+	return (crc);
+}
+
+#endif
@@ -0,0 +1,73 @@
+#include "blockchain.h"
+
+/**
+ * hblk_flat_tx_size - tells the size of the record of a flat transaction
+ * @flat: flat transaction
+ * Return: number of bytes of the transaction record with its inputs and
+ * outputs
+ */
+size_t hblk_flat_tx_size(flat_tx_t const *flat)
+{
+	return (HBLK_TX_SIZE + (size_t)flat->nins * HBLK_IN_SIZE +
+		(size_t)flat->nouts * HBLK_OUT_SIZE);
+}
+
+/**
+ * hblk_flat_tx_encode - writes the record of a flat transaction, as
+ * blockchain_serialize() does for a transaction_t
+ * @flat: flat transaction
+ * @record: buffer of hblk_flat_tx_size() bytes
+ * Return: number of bytes written
+ */
+size_t hblk_flat_tx_encode(flat_tx_t const *flat, uint8_t *record)
+{
+	uint8_t *p = record;
+	uint32_t i;
+
+	memcpy(&p[0], flat->id, 32);
+	memcpy(&p[32], &flat->nins, 4);
+	memcpy(&p[36], &flat->nouts, 4);
+	p += HBLK_TX_SIZE;
+	for (i = 0; i < flat->nins; i++, p += HBLK_IN_SIZE)
+	{
+		memcpy(&p[0], flat->in_refs[i], 96);
+		memcpy(&p[96], flat->in_sigs[i].sig, 72);
+		memcpy(&p[168], &flat->in_sigs[i].len, 1);
+	}
+	for (i = 0; i < flat->nouts; i++, p += HBLK_OUT_SIZE)
+	{
+		memcpy(&p[0], &flat->amounts[i], 4);
+		memcpy(&p[4], flat->pubs[i], 65);
+		memcpy(&p[69], flat->out_hashes[i], 32);
+	}
+	return (p - record);
+}
+
+/**
+ * hblk_flat_tx_decode - makes a flat copy of a viewed transaction
+ * @view: transaction records
+ * Return: pointer to the flat transaction, to free(), or NULL
+ */
+flat_tx_t *hblk_flat_tx_decode(tx_view_t const *view)
+{
+	flat_tx_t *flat = flat_tx_create(view->nins, view->nouts);
+	uint8_t const *p;
+	uint32_t i;
+
+	if (!flat)
+		return (NULL);
+	memcpy(flat->id, view->id, SHA256_DIGEST_LENGTH);
+	for (i = 0, p = view->ins; i < view->nins; i++, p += HBLK_IN_SIZE)
+	{
+		memcpy(flat->in_refs[i], &p[0], 96);
+		memcpy(flat->in_sigs[i].sig, &p[96], 72);
+		memcpy(&flat->in_sigs[i].len, &p[168], 1);
+	}
+	for (i = 0, p = view->outs; i < view->nouts; i++, p += HBLK_OUT_SIZE)
+	{
+		memcpy(&flat->amounts[i], &p[0], 4);
+		memcpy(flat->pubs[i], &p[4], 65);
+		memcpy(flat->out_hashes[i], &p[69], 32);
+	}
+	return (flat);
+}
@@ -1,5 +1,7 @@
 #include "blockchain.h"
 
+uint64_t hash_word(uint8_t const hash[SHA256_DIGEST_LENGTH], uint32_t i);
+
 /**
  * hash_matches_difficulty - Checks if a provided hash matches a difficulty
  * @hash: hash to check
@@ -9,24 +11,81 @@
 int hash_matches_difficulty(uint8_t const hash[SHA256_DIGEST_LENGTH],
 							uint32_t difficulty)
 {
-	uint8_t i = 0, count = 0, msb = 128;
-	size_t j = 0;
-
 	if (!hash)
 		return (0);
+	return (hash_leading_zeros(hash) >= difficulty);
+}
 
-	for (; i < SHA256_DIGEST_LENGTH; i++)
-	{
-		if (hash[i] == '\000')
-			count += 8;
-		else
-			break;
-	}
-	for (; j < (sizeof(uint8_t) * 8); j++)
+/**
+ * hash_leading_zeros - Counts the leading zero bits of a hash
+ * @hash: hash to count the leading zero bits of
+ * Return: number of leading zero bits, 256 for an all zero hash
+ */
+uint32_t hash_leading_zeros(uint8_t const hash[SHA256_DIGEST_LENGTH])
+{
+	uint64_t word;
+	uint32_t i;
+
+	for (i = 0; i < SHA256_DIGEST_LENGTH / sizeof(word); i++)
 	{
-		if ((hash[i] << j) & msb)
-			break;
-		count++;
+		word = hash_word(hash, i);
+		if (word)
+			return (i * 64 + __builtin_clzll(word));
 	}
-	return (count >= difficulty);
+	return (SHA256_DIGEST_LENGTH * 8);
+}
+
+/**
+ * difficulty_mask_init - Precomputes the bits a hash needs to be zero to
+ * match a difficulty
+ * @mask: mask to initialize
+ * @difficulty: difficulty to match
+ */
+void difficulty_mask_init(difficulty_mask_t *mask, uint32_t difficulty)
+{
+	uint32_t words = SHA256_DIGEST_LENGTH / sizeof(mask->mask);
+
+	mask->full = difficulty / 64 < words ? difficulty / 64 : words;
+	if (mask->full == words)
+		mask->mask = difficulty > words * 64;
+	else if (difficulty % 64)
+		mask->mask = UINT64_MAX << (64 - difficulty % 64);
+	else
+		mask->mask = 0;
+}
+
+/**
+ * hash_matches_mask - Checks a hash against a precomputed difficulty mask
+ * @hash: hash to check
+ * @mask: mask from difficulty_mask_init()
+ * Return: 1 on match, 0 on fail
+ *
+ * Description: Any difficulty below 64 costs a single load and compare,
+ * below 128 two of them.
+ */
+int hash_matches_mask(uint8_t const hash[SHA256_DIGEST_LENGTH],
+	difficulty_mask_t const *mask)
+{
+	uint32_t i;
+
+	for (i = 0; i < mask->full; i++)
+		if (hash_word(hash, i))
+			return (0);
+	if (i == SHA256_DIGEST_LENGTH / sizeof(mask->mask))
+		return (!mask->mask);
+	return (!(hash_word(hash, i) & mask->mask));
+}
+
+/**
+ * hash_word - Loads one big-endian 64-bit word of a hash
+ * @hash: hash to load from
+ * @i: index of the word, 0 to 3
+ * Return: the word
+ */
+uint64_t hash_word(uint8_t const hash[SHA256_DIGEST_LENGTH], uint32_t i)
+{
+	uint64_t word;
+
+	memcpy(&word, hash + i * sizeof(word), sizeof(word));
+	return (SHA_BE64(word));
 }
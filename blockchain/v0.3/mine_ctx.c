@@ -0,0 +1,192 @@
+#include "blockchain.h"
+
+uint8_t *mine_preimage(block_t const *block, size_t *len, size_t *nchunks);
+int mine_ctx_schedule(mine_ctx_t *ctx);
+void mine_ctx_hash_lanes(mine_ctx_t const *ctx, uint64_t nonce,
+	uint8_t (*digests)[SHA256_DIGEST_LENGTH]);
+
+/**
+ * mine_ctx_init - Precomputes the nonce independent part of a block hash
+ * @ctx: context to initialize
+ * @block: block to be mined, its transactions must not change afterwards,
+ * not a pending block of a lazy chain
+ *
+ * Description: The nonce sits at offset 16 of the preimage, inside the
+ * first chunk, so no compression round can be done ahead of it: nothing
+ * here is a SHA-256 midstate. What is cached is the padded preimage, the
+ * first chunk's message words, and the W + K schedule of every later
+ * chunk (data, transaction ids and padding never change). The words and
+ * schedules only pay off with a multi-lane kernel, whose lanes all share
+ * them; one is used only if sha256_mb_kernel() picks it, i.e. it was
+ * measured faster than OpenSSL. Otherwise mine_ctx_hash() saves just the
+ * preimage rebuild and hashes the whole of it with SHA256() per nonce.
+ * Return: 0 on success, 1 on fail
+ */
+int mine_ctx_init(mine_ctx_t *ctx, block_t const *block)
+{
+	if (!ctx || !block || block->lazy)
+		return (1);
+	ctx->wk = NULL;
+	ctx->preimage = mine_preimage(block, &ctx->len, &ctx->nchunks);
+	if (!ctx->preimage)
+		return (1);
+	ctx->kernel = sha256_mb_kernel();
+	if (ctx->kernel->lanes < 2)
+		ctx->kernel = NULL;
+	ctx->lanes = ctx->kernel ? ctx->kernel->lanes : 1;
+	if (mine_ctx_schedule(ctx))
+		return (mine_ctx_free(ctx), 1);
+	return (0);
+}
+
+/**
+ * mine_preimage - Builds the SHA-256 padded preimage of a block
+ * @block: block to build the preimage of
+ * @len: set to the length of the unpadded preimage
+ * @nchunks: set to the number of 64-byte chunks in the padded preimage
+ * Return: the preimage, to be freed by the caller, or NULL
+ */
+uint8_t *mine_preimage(block_t const *block, size_t *len, size_t *nchunks)
+{
+	size_t num_tx = 0, block_sz, i;
+	uint64_t bits;
+	uint8_t *buffer;
+
+	if (block->transactions)
+		num_tx = llist_size(block->transactions);
+	block_sz = sizeof(block->info) + block->data.len;
+	*len = block_sz + num_tx * SHA256_DIGEST_LENGTH;
+	*nchunks = (*len + 9 + 63) / 64;
+	buffer = calloc(*nchunks, 64);
+	if (!buffer)
+		return (NULL);
+
+	memcpy(buffer, block, block_sz);
+	llist_for_each(block->transactions, tx_id_cpy, buffer + block_sz);
+	buffer[*len] = 0x80;
+	bits = (uint64_t)*len * 8;
+	for (i = 0; i < 8; i++)
+		buffer[*nchunks * 64 - 1 - i] = (uint8_t)(bits >> (i * 8));
+	return (buffer);
+}
+
+/**
+ * mine_ctx_schedule - Precomputes the schedules that don't depend on the
+ * nonce
+ * @ctx: context holding the padded preimage
+ * Return: 0 on success, 1 on fail
+ */
+int mine_ctx_schedule(mine_ctx_t *ctx)
+{
+	uint32_t w[64];
+	size_t i;
+
+	if (ctx->nchunks > 1)
+	{
+		ctx->wk = malloc((ctx->nchunks - 1) * sizeof(*ctx->wk));
+		if (!ctx->wk)
+			return (1);
+	}
+	sha256_load_chunk(w, ctx->preimage);
+	memcpy(ctx->w, w, sizeof(ctx->w));
+	for (i = 1; i < ctx->nchunks; i++)
+	{
+		sha256_load_chunk(w, ctx->preimage + i * 64);
+		sha256_expand(w, 16);
+		sha256_add_k(ctx->wk[i - 1], w, 0);
+	}
+	return (0);
+}
+
+/**
+ * mine_ctx_hash - Hashes the block of a mining context under a nonce
+ * @ctx: initialized mining context
+ * @nonce: nonce to hash the block with
+ * @hash_buf: buffer to store the computed hash
+ * Return: hash_buf
+ *
+ * Description: Only the first chunk is copied to patch the nonce in, so
+ * the preimage can be shared by concurrent miners.
+ */
+uint8_t *mine_ctx_hash(mine_ctx_t const *ctx, uint64_t nonce,
+	uint8_t hash_buf[SHA256_DIGEST_LENGTH])
+{
+	uint8_t first[64];
+	size_t first_len = ctx->len < 64 ? ctx->len : 64;
+	SHA256_CTX sha;
+
+	memcpy(first, ctx->preimage, first_len);
+	memcpy(first + offsetof(block_info_t, nonce), &nonce, sizeof(nonce));
+	SHA256_Init(&sha);
+	SHA256_Update(&sha, first, first_len);
+	SHA256_Update(&sha, ctx->preimage + first_len, ctx->len - first_len);
+	SHA256_Final(hash_buf, &sha);
+	return (hash_buf);
+}
+
+/**
+ * mine_ctx_batch - Hashes the block of a mining context under the next
+ * @ctx->lanes nonces
+ * @ctx: initialized mining context
+ * @nonce: first nonce to hash the block with, hash i uses @nonce + i
+ * @digests: buffers to store the hashes to, at least @ctx->lanes of them
+ * Return: number of hashes computed, always @ctx->lanes
+ */
+size_t mine_ctx_batch(mine_ctx_t const *ctx, uint64_t nonce,
+	uint8_t (*digests)[SHA256_DIGEST_LENGTH])
+{
+	if (!ctx->kernel)
+		mine_ctx_hash(ctx, nonce, digests[0]);
+	else
+		mine_ctx_hash_lanes(ctx, nonce, digests);
+	return (ctx->lanes);
+}
+
+/**
+ * mine_ctx_hash_lanes - Hashes the block of a mining context under one
+ * nonce per kernel lane
+ * @ctx: initialized mining context, with a multi-buffer kernel
+ * @nonce: nonce of the first lane, lane l uses @nonce + l
+ * @digests: buffers to store the digest of each lane to
+ *
+ * Description: Only the first chunk differs between lanes; every later
+ * chunk runs from the W + K schedule precomputed once for all lanes.
+ */
+void mine_ctx_hash_lanes(mine_ctx_t const *ctx, uint64_t nonce,
+	uint8_t (*digests)[SHA256_DIGEST_LENGTH])
+{
+	sha256_mb_kernel_t const *kernel = ctx->kernel;
+	uint32_t words[16 * SHA256_MB_MAX_LANES], st[8 * SHA256_MB_MAX_LANES];
+	uint8_t bytes[sizeof(nonce)];
+	size_t c, l, t, lanes = kernel->lanes;
+
+	for (t = 0; t < 16; t++)
+		for (l = 0; l < lanes; l++)
+			words[t * lanes + l] = ctx->w[t];
+	for (l = 0; l < lanes; l++, nonce++)
+	{
+		memcpy(bytes, &nonce, sizeof(nonce));
+		words[MINE_NONCE_WORD * lanes + l] = SHA_LOAD32(bytes);
+		words[(MINE_NONCE_WORD + 1) * lanes + l] = SHA_LOAD32(bytes + 4);
+	}
+	sha256_mb_init(st, lanes);
+	kernel->compress(st, words);
+	for (c = 1; c < ctx->nchunks; c++)
+		kernel->compress_wk(st, ctx->wk[c - 1]);
+	for (l = 0; l < lanes; l++)
+		sha256_mb_digest(st, lanes, l, digests[l]);
+}
+
+/**
+ * mine_ctx_free - Releases the memory held by a mining context
+ * @ctx: context to release
+ */
+void mine_ctx_free(mine_ctx_t *ctx)
+{
+	if (!ctx)
+		return;
+	free(ctx->wk);
+	free(ctx->preimage);
+	ctx->wk = NULL;
+	ctx->preimage = NULL;
+}
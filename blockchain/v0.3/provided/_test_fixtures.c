@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "test_fixtures.h"
+
+/**
+ * _fill - Fills a buffer with pseudo-random bytes
+ *
+ * @buf: Buffer to fill
+ * @len: Number of bytes to fill
+ */
+void _fill(void *buf, size_t len)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++)
+		((uint8_t *)buf)[i] = rand() & 0xff;
+}
+
+/**
+ * _random_tx - Creates a transaction with random contents
+ *
+ * @n: Number of inputs and of outputs
+ *
+ * Return: Pointer to the transaction
+ */
+transaction_t *_random_tx(int n)
+{
+	transaction_t *tx = calloc(1, sizeof(*tx));
+	tx_in_t *in;
+	tx_out_t *out;
+	int i;
+
+	_fill(tx->id, sizeof(tx->id));
+	tx->inputs = llist_create(MT_SUPPORT_FALSE);
+	tx->outputs = llist_create(MT_SUPPORT_FALSE);
+	for (i = 0; i < n; i++)
+	{
+		in = calloc(1, sizeof(*in));
+		_fill(in, sizeof(*in));
+		in->sig.len &= 0xff;
+		llist_add_node(tx->inputs, in, ADD_NODE_REAR);
+		out = calloc(1, sizeof(*out));
+		_fill(out, sizeof(*out));
+		llist_add_node(tx->outputs, out, ADD_NODE_REAR);
+	}
+	return (tx);
+}
+
+/**
+ * _random_blocks - Appends blocks of random transactions to a chain
+ *
+ * @blockchain: Chain to append to, through blockchain_add_block()
+ * @nblocks:    Number of blocks
+ * @ntxs:       Number of transactions per block, of 1 to 3 inputs and
+ *              outputs each
+ *
+ * Return: 0 on success, 1 on failure
+ */
+int _random_blocks(blockchain_t *blockchain, int nblocks, int ntxs)
+{
+	block_t *block = blockchain_tip(blockchain);
+	int i, j;
+
+	for (i = 0; block && i < nblocks; i++)
+	{
+		block = block_create(block, (int8_t *)"Holberton", 9);
+		if (!block)
+			return (1);
+		for (j = 0; j < ntxs; j++)
+			llist_add_node(block->transactions, _random_tx(1 + j % 3),
+				ADD_NODE_REAR);
+		block->data.len = rand() % BLOCKCHAIN_DATA_MAX;
+		_fill(block->data.buffer, block->data.len);
+		block_hash(block, block->hash);
+		if (blockchain_add_block(blockchain, block))
+		{
+			block_destroy(block);
+			return (1);
+		}
+	}
+	return (!block);
+}
+
+/**
+ * _random_unspent - Adds unspent outputs with random contents to a chain
+ *
+ * @blockchain: Chain
+ * @nunspent:   Number of unspent outputs
+ *
+ * Return: 0 on success, 1 on failure
+ */
+int _random_unspent(blockchain_t *blockchain, int nunspent)
+{
+	uto_t *unspent;
+	int i;
+
+	for (i = 0; i < nunspent; i++)
+	{
+		unspent = calloc(1, sizeof(*unspent));
+		if (!unspent)
+			return (1);
+		_fill(unspent, sizeof(*unspent));
+		llist_add_node(blockchain->unspent, unspent, ADD_NODE_REAR);
+	}
+	return (0);
+}
+
+/**
+ * _random_chain - Creates a chain of random blocks and unspent outputs
+ *
+ * @nblocks:  Number of blocks after the genesis block
+ * @ntxs:     Number of transactions per block
+ * @nunspent: Number of unspent outputs
+ *
+ * Return: Pointer to the chain, NULL on failure
+ */
+blockchain_t *_random_chain(int nblocks, int ntxs, int nunspent)
+{
+	blockchain_t *blockchain = blockchain_create();
+
+	if (blockchain && (_random_blocks(blockchain, nblocks, ntxs) ||
+		_random_unspent(blockchain, nunspent)))
+	{
+		blockchain_destroy(blockchain);
+		return (NULL);
+	}
+	return (blockchain);
+}
+
+/**
+ * _same_files - Compares two files byte by byte
+ *
+ * @a: First path
+ * @b: Second path
+ *
+ * Return: 1 if both files exist and are identical, 0 otherwise
+ */
+int _same_files(char const *a, char const *b)
+{
+	FILE *fa = fopen(a, "rb"), *fb = fopen(b, "rb");
+	int ca, cb, same = 0;
+
+	if (fa && fb)
+	{
+		do {
+			ca = fgetc(fa);
+			cb = fgetc(fb);
+		} while (ca == cb && ca != EOF);
+		same = ca == cb;
+	}
+	if (fa)
+		fclose(fa);
+	if (fb)
+		fclose(fb);
+	return (same);
+}
+
+/**
+ * _elapsed_ms - Milliseconds between two times
+ *
+ * @start: Start time
+ * @end:   End time
+ *
+ * Return: Elapsed milliseconds
+ */
+double _elapsed_ms(struct timespec const *start, struct timespec const *end)
+{
+	return ((end->tv_sec - start->tv_sec) * 1e3 +
+		(end->tv_nsec - start->tv_nsec) / 1e6);
+}
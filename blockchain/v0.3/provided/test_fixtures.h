@@ -0,0 +1,17 @@
+#ifndef _TEST_FIXTURES_H_
+# define _TEST_FIXTURES_H_
+
+# include <stddef.h>
+# include <time.h>
+
+# include "../blockchain.h"
+
+void _fill(void *buf, size_t len);
+transaction_t *_random_tx(int n);
+int _random_blocks(blockchain_t *blockchain, int nblocks, int ntxs);
+int _random_unspent(blockchain_t *blockchain, int nunspent);
+blockchain_t *_random_chain(int nblocks, int ntxs, int nunspent);
+int _same_files(char const *a, char const *b);
+double _elapsed_ms(struct timespec const *start, struct timespec const *end);
+
+#endif /* ! _TEST_FIXTURES_H_ */
@@ -0,0 +1,333 @@
+#include "blockchain.h"
+
+/* Messages sorted by length at once, so that each group has even lengths */
+#define SHA256_MB_WINDOW 256
+
+int sha256_mb1_scalar_supported(void);
+void sha256_mb1_scalar(uint32_t *st, uint32_t const *words);
+void sha256_mb1_scalar_wk(uint32_t *st, uint32_t const wk[64]);
+void sha256_mb_pick(void);
+int sha256_mb_order_cmp(void const *a, void const *b);
+void sha256_mb_gather(sha256_mb_kernel_t const *kernel,
+	uint8_t const *const msgs[], sha256_mb_order_t const *order,
+	size_t count, uint8_t (*digests)[SHA256_DIGEST_LENGTH]);
+size_t sha256_mb_pad(uint8_t const *msg, size_t len, uint8_t tail[128]);
+void sha256_mb_group(sha256_mb_kernel_t const *kernel,
+	uint8_t const *const msgs[], size_t const lens[], size_t count,
+	uint8_t (*digests)[SHA256_DIGEST_LENGTH]);
+
+/*
+ * Every kernel, fastest first. Per nonce of a block with 16 and 1024 bytes
+ * of data, against 158 and 1023 ns for block_hash(): avx512 160 and 350 ns,
+ * sha-ni 197 and 1011 ns, avx2 185 and 905 ns, sse4 485 and 2073 ns. Only
+ * avx512 is never slower than OpenSSL, the others stay for the tests.
+ */
+sha256_mb_kernel_t const sha256_mb_kernels[] = {
+	{"avx512", 16, 1, sha256_mb16_avx512_supported, sha256_mb16_avx512,
+		sha256_mb16_avx512_wk},
+	{"sha-ni", 2, 0, sha256_mb2_ni_supported, sha256_mb2_ni,
+		sha256_mb2_ni_wk},
+	{"avx2", 8, 0, sha256_mb8_avx2_supported, sha256_mb8_avx2,
+		sha256_mb8_avx2_wk},
+	{"sse4", 4, 0, sha256_mb4_sse4_supported, sha256_mb4_sse4,
+		sha256_mb4_sse4_wk},
+	{"scalar", 1, 0, sha256_mb1_scalar_supported, sha256_mb1_scalar,
+		sha256_mb1_scalar_wk},
+	{NULL, 0, 0, NULL, NULL, NULL}
+};
+
+sha256_mb_kernel_t const *sha256_mb_best;
+pthread_once_t sha256_mb_once = PTHREAD_ONCE_INIT;
+
+/**
+ * sha256_mb_kernel - Gets the fastest kernel the CPU can run
+ * Return: pointer to the kernel, the scalar one when no kernel the CPU
+ * runs beats OpenSSL
+ */
+sha256_mb_kernel_t const *sha256_mb_kernel(void)
+{
+	pthread_once(&sha256_mb_once, sha256_mb_pick);
+	return (sha256_mb_best);
+}
+
+/**
+ * sha256_mb_pick - Selects the fastest supported kernel that beats
+ * OpenSSL, run once
+ */
+void sha256_mb_pick(void)
+{
+	sha256_mb_kernel_t const *kernel = sha256_mb_kernels;
+
+	while (kernel->lanes > 1 && !(kernel->fast && kernel->supported()))
+		kernel++;
+	sha256_mb_best = kernel;
+}
+
+/**
+ * sha256_mb - Hashes several independent messages with the fastest kernel
+ * @msgs: messages to hash
+ * @lens: length of each message
+ * @n: number of messages
+ * @digests: buffers to store each message digest to
+ *
+ * Description: Without a multi-lane kernel faster than OpenSSL, each
+ * message is hashed with SHA256().
+ */
+void sha256_mb(uint8_t const *const msgs[], size_t const lens[], size_t n,
+	uint8_t (*digests)[SHA256_DIGEST_LENGTH])
+{
+	sha256_mb_kernel_t const *kernel = sha256_mb_kernel();
+	size_t i;
+
+	if (kernel->lanes > 1)
+	{
+		sha256_mb_with(kernel, msgs, lens, n, digests);
+		return;
+	}
+	for (i = 0; i < n; i++)
+		SHA256(msgs[i], lens[i], digests[i]);
+}
+
+/**
+ * sha256_mb_with - Hashes several independent messages with a given kernel
+ * @kernel: kernel to use, must be supported by the CPU
+ * @msgs: messages to hash
+ * @lens: length of each message
+ * @n: number of messages
+ * @digests: buffers to store each message digest to
+ *
+ * Description: A group runs for as many chunks as its longest message, so
+ * the messages are grouped by length rather than in the given order.
+ */
+void sha256_mb_with(sha256_mb_kernel_t const *kernel,
+	uint8_t const *const msgs[], size_t const lens[], size_t n,
+	uint8_t (*digests)[SHA256_DIGEST_LENGTH])
+{
+	sha256_mb_order_t order[SHA256_MB_WINDOW];
+	size_t w, i, count, lanes;
+
+	for (w = 0; w < n; w += count)
+	{
+		count = n - w < SHA256_MB_WINDOW ? n - w : SHA256_MB_WINDOW;
+		for (i = 0; i < count; i++)
+			order[i].len = lens[w + i], order[i].idx = w + i;
+		qsort(order, count, sizeof(*order), sha256_mb_order_cmp);
+		for (i = 0; i < count; i += lanes)
+		{
+			lanes = count - i < kernel->lanes ? count - i : kernel->lanes;
+			sha256_mb_gather(kernel, msgs, order + i, lanes, digests);
+		}
+	}
+}
+
+/**
+ * sha256_mb_order_cmp - Orders two messages by length
+ * @a: first sha256_mb_order_t
+ * @b: second sha256_mb_order_t
+ * Return: negative, zero or positive as @a is shorter, as long or longer
+ */
+int sha256_mb_order_cmp(void const *a, void const *b)
+{
+	size_t len_a = ((sha256_mb_order_t const *)a)->len;
+	size_t len_b = ((sha256_mb_order_t const *)b)->len;
+
+	return ((len_a > len_b) - (len_a < len_b));
+}
+
+/**
+ * sha256_mb_gather - Hashes one group of messages picked out of order
+ * @kernel: kernel to use
+ * @msgs: all the messages
+ * @order: length and index of the messages of the group
+ * @count: number of messages in the group, at most @kernel->lanes
+ * @digests: buffers to store each message digest to, by index
+ */
+void sha256_mb_gather(sha256_mb_kernel_t const *kernel,
+	uint8_t const *const msgs[], sha256_mb_order_t const *order,
+	size_t count, uint8_t (*digests)[SHA256_DIGEST_LENGTH])
+{
+	uint8_t out[SHA256_MB_MAX_LANES][SHA256_DIGEST_LENGTH];
+	uint8_t const *group[SHA256_MB_MAX_LANES] = {NULL};
+	size_t lens[SHA256_MB_MAX_LANES] = {0}, l;
+
+	for (l = 0; l < count; l++)
+		group[l] = msgs[order[l].idx], lens[l] = order[l].len;
+	sha256_mb_group(kernel, group, lens, count, out);
+	for (l = 0; l < count; l++)
+		memcpy(digests[order[l].idx], out[l], SHA256_DIGEST_LENGTH);
+}
+
+/**
+ * sha256_mb_group - Hashes up to one message per kernel lane
+ * @kernel: kernel to use
+ * @msgs: messages to hash
+ * @lens: length of each message
+ * @count: number of messages, at most @kernel->lanes
+ * @digests: buffers to store each message digest to
+ *
+ * Description: Lanes whose message is shorter than the longest one, and
+ * unused lanes, keep compressing a dummy chunk; their state is saved
+ * before and put back after each such chunk.
+ */
+void sha256_mb_group(sha256_mb_kernel_t const *kernel,
+	uint8_t const *const msgs[], size_t const lens[], size_t count,
+	uint8_t (*digests)[SHA256_DIGEST_LENGTH])
+{
+	uint8_t tails[SHA256_MB_MAX_LANES][128] = {{0}};
+	uint8_t const *chunks[SHA256_MB_MAX_LANES];
+	uint32_t words[16 * SHA256_MB_MAX_LANES];
+	uint32_t st[8 * SHA256_MB_MAX_LANES], saved[8 * SHA256_MB_MAX_LANES];
+	size_t total[SHA256_MB_MAX_LANES] = {0}, full[SHA256_MB_MAX_LANES] = {0};
+	size_t max = 0, c, l, L = kernel->lanes;
+
+	for (l = 0; l < count; l++)
+	{
+		total[l] = sha256_mb_pad(msgs[l], lens[l], tails[l]);
+		full[l] = lens[l] / 64;
+		max = total[l] > max ? total[l] : max;
+	}
+	sha256_mb_init(st, L);
+	for (c = 0; c < max; c++)
+	{
+		memcpy(saved, st, 8 * L * sizeof(*st));
+		for (l = 0; l < L; l++)
+			chunks[l] = c < full[l] ? msgs[l] + c * 64 :
+				tails[l] + (c < total[l] ? (c - full[l]) * 64 : 0);
+		sha256_mb_load(words, chunks, L);
+		kernel->compress(st, words);
+		for (l = 0; l < L; l++)
+			if (c >= total[l])
+				sha256_mb_lane_copy(st, saved, L, l);
+	}
+	for (l = 0; l < count; l++)
+		sha256_mb_digest(st, L, l, digests[l]);
+}
+
+/**
+ * sha256_mb_init - Sets every lane of a multi-buffer state to the IV
+ * @st: hash states
+ * @lanes: number of lanes
+ */
+void sha256_mb_init(uint32_t *st, size_t lanes)
+{
+	size_t i, l;
+
+	for (i = 0; i < 8; i++)
+		for (l = 0; l < lanes; l++)
+			st[i * lanes + l] = sha256_iv[i];
+}
+
+/**
+ * sha256_mb_load - Loads one chunk per lane as interleaved message words
+ * @words: buffer to store the words to, word t of lane l at
+ * words[t * lanes + l]
+ * @chunks: chunk of each lane
+ * @lanes: number of lanes
+ */
+void sha256_mb_load(uint32_t *words, uint8_t const *const *chunks,
+	size_t lanes)
+{
+	uint32_t w;
+	size_t t, l;
+
+	for (t = 0; t < 16; t++)
+		for (l = 0; l < lanes; l++)
+		{
+			memcpy(&w, chunks[l] + 4 * t, sizeof(w));
+			*words++ = SHA_BE32(w);
+		}
+}
+
+/**
+ * sha256_mb_lane_copy - Copies the state of one lane
+ * @dst: hash states to copy to
+ * @src: hash states to copy from
+ * @lanes: number of lanes
+ * @lane: lane to copy
+ */
+void sha256_mb_lane_copy(uint32_t *dst, uint32_t const *src, size_t lanes,
+	size_t lane)
+{
+	size_t i;
+
+	for (i = 0; i < 8; i++)
+		dst[i * lanes + lane] = src[i * lanes + lane];
+}
+
+/**
+ * sha256_mb_digest - Writes the digest held by one lane
+ * @st: hash states
+ * @lanes: number of lanes
+ * @lane: lane to write the digest of
+ * @digest: buffer to store the digest to
+ */
+void sha256_mb_digest(uint32_t const *st, size_t lanes, size_t lane,
+	uint8_t digest[SHA256_DIGEST_LENGTH])
+{
+	uint32_t state[8];
+	size_t i;
+
+	for (i = 0; i < 8; i++)
+		state[i] = st[i * lanes + lane];
+	sha256_store_digest(state, digest);
+}
+
+/**
+ * sha256_mb_pad - Builds the padded last chunks of a message
+ * @msg: message to pad
+ * @len: length of the message
+ * @tail: buffer to store the one or two padded last chunks to
+ * Return: total number of chunks in the padded message
+ */
+size_t sha256_mb_pad(uint8_t const *msg, size_t len, uint8_t tail[128])
+{
+	size_t rem = len % 64, ntail = rem + 9 > 64 ? 2 : 1, i;
+	uint64_t bits = (uint64_t)len * 8;
+
+	memset(tail, 0, 128);
+	memcpy(tail, msg + len - rem, rem);
+	tail[rem] = 0x80;
+	for (i = 0; i < 8; i++)
+		tail[ntail * 64 - 1 - i] = (uint8_t)(bits >> (i * 8));
+	return (len / 64 + ntail);
+}
+
+/**
+ * sha256_mb1_scalar_supported - The scalar kernel runs everywhere
+ * Return: Always 1
+ */
+int sha256_mb1_scalar_supported(void)
+{
+	return (1);
+}
+
+/**
+ * sha256_mb1_scalar - Single lane fallback kernel
+ * @st: hash state
+ * @words: message words of the one chunk to compress
+ */
+void sha256_mb1_scalar(uint32_t *st, uint32_t const *words)
+{
+	uint32_t w[64];
+
+	memcpy(w, words, 16 * sizeof(*w));
+	sha256_expand(w, 16);
+	sha256_add_k(w, w, 0);
+	sha256_mb1_scalar_wk(st, w);
+}
+
+/**
+ * sha256_mb1_scalar_wk - Single lane fallback kernel, expanded schedule
+ * @st: hash state
+ * @wk: W + K schedule of the chunk to compress
+ */
+void sha256_mb1_scalar_wk(uint32_t *st, uint32_t const wk[64])
+{
+	uint32_t v[8];
+	int i;
+
+	memcpy(v, st, sizeof(v));
+	sha256_rounds(v, wk, 0, 64);
+	for (i = 0; i < 8; i++)
+		st[i] += v[i];
+}
@@ -0,0 +1,55 @@
+#include "blockchain.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+typedef uint32_t mb16_vec_t __attribute__((vector_size(64)));
+
+#define MB_LANES 16
+#define MB_VEC mb16_vec_t
+#define MB_NAME sha256_mb16_avx512
+#define MB_NAME_WK sha256_mb16_avx512_wk
+#define MB_TARGET __attribute__((target("avx512f")))
+#include "sha256_mb_kernel.h"
+
+/**
+ * sha256_mb16_avx512_supported - Checks for the 16-lane kernel instruction set
+ * Return: 1 if the CPU has it, 0 otherwise
+ */
+int sha256_mb16_avx512_supported(void)
+{
+	__builtin_cpu_init();
+	return (__builtin_cpu_supports("avx512f"));
+}
+
+#else
+
+/**
+ * sha256_mb16_avx512 - Stand-in for the 16-lane kernel outside of x86
+ * @st: hash states
+ * @words: message words of each lane
+ */
+void sha256_mb16_avx512(uint32_t *st, uint32_t const *words)
+{
+	(void)st, (void)words;
+}
+
+/**
+ * sha256_mb16_avx512_wk - Stand-in for the 16-lane kernel outside of x86
+ * @st: hash states
+ * @wk: schedule shared by every lane
+ */
+void sha256_mb16_avx512_wk(uint32_t *st, uint32_t const wk[64])
+{
+	(void)st, (void)wk;
+}
+
+/**
+ * sha256_mb16_avx512_supported - Checks for the 16-lane kernel instruction set
+ * Return: Always 0 outside of x86
+ */
+int sha256_mb16_avx512_supported(void)
+{
+	return (0);
+}
+
+#endif
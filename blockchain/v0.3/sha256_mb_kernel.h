@@ -0,0 +1,77 @@
+/*
+ * Multi-buffer SHA-256 compression kernels, included once per lane
+ * width. The including file defines:
+ * MB_LANES   - number of independent messages hashed at once
+ * MB_VEC     - GCC vector type holding one uint32_t per lane
+ * MB_NAME    - name of the kernel taking one message per lane
+ * MB_NAME_WK - name of the kernel taking a schedule shared by all lanes
+ * MB_TARGET  - function attribute enabling the matching instruction set
+ *
+ * Lane l of every vector works on its own message, so the SHA_* macros
+ * from blockchain.h apply unchanged to whole vectors. Both round loops
+ * are unrolled so that w and v index with constants and stay in
+ * registers.
+ */
+
+/**
+ * MB_NAME - Compresses one 64-byte chunk of MB_LANES messages at once
+ * @st: hash states, word i of lane l at st[i * MB_LANES + l]
+ * @words: big-endian message words, word t of lane l at
+ * words[t * MB_LANES + l]
+ */
+MB_TARGET void MB_NAME(uint32_t *st, uint32_t const *words)
+{
+	MB_VEC w[16], v[8], s, t1, t2;
+	int t;
+
+	memcpy(w, words, sizeof(w));
+	memcpy(v, st, sizeof(v));
+#pragma GCC unroll 64
+	for (t = 0; t < 64; t++)
+	{
+		if (t >= 16)
+			w[t & 15] += SHA_SIG1(w[(t - 2) & 15]) + w[(t - 7) & 15] +
+				SHA_SIG0(w[(t - 15) & 15]);
+		t1 = v[7] + SHA_EP1(v[4]) + SHA_CH(v[4], v[5], v[6]) +
+			sha256_k[t] + w[t & 15];
+		t2 = SHA_EP0(v[0]) + SHA_MAJ(v[0], v[1], v[2]);
+		v[7] = v[6], v[6] = v[5], v[5] = v[4], v[4] = v[3] + t1;
+		v[3] = v[2], v[2] = v[1], v[1] = v[0], v[0] = t1 + t2;
+	}
+	for (t = 0; t < 8; t++)
+	{
+		memcpy(&s, st + t * MB_LANES, sizeof(s));
+		s += v[t];
+		memcpy(st + t * MB_LANES, &s, sizeof(s));
+	}
+}
+
+/**
+ * MB_NAME_WK - Compresses the same chunk for MB_LANES different states
+ * @st: hash states, word i of lane l at st[i * MB_LANES + l]
+ * @wk: W + K schedule of the chunk, shared by every lane
+ *
+ * Description: With the schedule already expanded, only the rounds are
+ * left to run, each one reading a single broadcast word.
+ */
+MB_TARGET void MB_NAME_WK(uint32_t *st, uint32_t const wk[64])
+{
+	MB_VEC v[8], s, t1, t2;
+	int t;
+
+	memcpy(v, st, sizeof(v));
+#pragma GCC unroll 64
+	for (t = 0; t < 64; t++)
+	{
+		t1 = v[7] + SHA_EP1(v[4]) + SHA_CH(v[4], v[5], v[6]) + wk[t];
+		t2 = SHA_EP0(v[0]) + SHA_MAJ(v[0], v[1], v[2]);
+		v[7] = v[6], v[6] = v[5], v[5] = v[4], v[4] = v[3] + t1;
+		v[3] = v[2], v[2] = v[1], v[1] = v[0], v[0] = t1 + t2;
+	}
+	for (t = 0; t < 8; t++)
+	{
+		memcpy(&s, st + t * MB_LANES, sizeof(s));
+		s += v[t];
+		memcpy(st + t * MB_LANES, &s, sizeof(s));
+	}
+}
@@ -0,0 +1,55 @@
+#include "blockchain.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+typedef uint32_t mb4_vec_t __attribute__((vector_size(16)));
+
+#define MB_LANES 4
+#define MB_VEC mb4_vec_t
+#define MB_NAME sha256_mb4_sse4
+#define MB_NAME_WK sha256_mb4_sse4_wk
+#define MB_TARGET __attribute__((target("sse4.1")))
+#include "sha256_mb_kernel.h"
+
+/**
+ * sha256_mb4_sse4_supported - Checks for the 4-lane kernel instruction set
+ * Return: 1 if the CPU has it, 0 otherwise
+ */
+int sha256_mb4_sse4_supported(void)
+{
+	__builtin_cpu_init();
+	return (__builtin_cpu_supports("sse4.1"));
+}
+
+#else
+
+/**
+ * sha256_mb4_sse4 - Stand-in for the 4-lane kernel outside of x86
+ * @st: hash states
+ * @words: message words of each lane
+ */
+void sha256_mb4_sse4(uint32_t *st, uint32_t const *words)
+{
+	(void)st, (void)words;
+}
+
+/**
+ * sha256_mb4_sse4_wk - Stand-in for the 4-lane kernel outside of x86
+ * @st: hash states
+ * @wk: schedule shared by every lane
+ */
+void sha256_mb4_sse4_wk(uint32_t *st, uint32_t const wk[64])
+{
+	(void)st, (void)wk;
+}
+
+/**
+ * sha256_mb4_sse4_supported - Checks for the 4-lane kernel instruction set
+ * Return: Always 0 outside of x86
+ */
+int sha256_mb4_sse4_supported(void)
+{
+	return (0);
+}
+
+#endif
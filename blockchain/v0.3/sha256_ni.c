@@ -0,0 +1,153 @@
+#include "blockchain.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+#define NI_TARGET __attribute__((target("sha,sse4.1")))
+
+void sha256_ni_expand(uint32_t wk[64], uint32_t const *words, size_t stride);
+void sha256_ni_rounds2(uint32_t *st, uint32_t const wk0[64],
+	uint32_t const wk1[64]);
+
+/**
+ * sha256_mb2_ni_supported - Checks for the SHA extensions
+ * Return: 1 if the CPU has them, 0 otherwise
+ */
+int sha256_mb2_ni_supported(void)
+{
+	__builtin_cpu_init();
+	return (__builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1"));
+}
+
+/**
+ * sha256_mb2_ni - Compresses one chunk of two messages with the x86 SHA
+ * extensions
+ * @st: hash states, word i of lane l at st[i * 2 + l]
+ * @words: message words, word t of lane l at words[t * 2 + l]
+ */
+NI_TARGET void sha256_mb2_ni(uint32_t *st, uint32_t const *words)
+{
+	uint32_t wk0[64], wk1[64];
+
+	sha256_ni_expand(wk0, words, 2);
+	sha256_ni_expand(wk1, words + 1, 2);
+	sha256_ni_rounds2(st, wk0, wk1);
+}
+
+/**
+ * sha256_mb2_ni_wk - Compresses the same chunk for two states with the
+ * x86 SHA extensions
+ * @st: hash states, word i of lane l at st[i * 2 + l]
+ * @wk: W + K schedule of the chunk, shared by both lanes
+ */
+NI_TARGET void sha256_mb2_ni_wk(uint32_t *st, uint32_t const wk[64])
+{
+	sha256_ni_rounds2(st, wk, wk);
+}
+
+/**
+ * sha256_ni_expand - Expands a message schedule with sha256msg1/2 and
+ * adds the round constants
+ * @wk: buffer to store the W + K schedule to
+ * @words: first message word, word t at words[t * @stride]
+ * @stride: distance between two message words
+ */
+NI_TARGET void sha256_ni_expand(uint32_t wk[64], uint32_t const *words,
+	size_t stride)
+{
+	__m128i w[16], tmp;
+	int i;
+
+	for (i = 0; i < 4; i++, words += 4 * stride)
+		w[i] = _mm_set_epi32(words[3 * stride], words[2 * stride],
+			words[stride], words[0]);
+	for (i = 4; i < 16; i++)
+	{
+		tmp = _mm_sha256msg1_epu32(w[i - 4], w[i - 3]);
+		tmp = _mm_add_epi32(tmp, _mm_alignr_epi8(w[i - 1], w[i - 2], 4));
+		w[i] = _mm_sha256msg2_epu32(tmp, w[i - 1]);
+	}
+	for (i = 0; i < 16; i++)
+		_mm_storeu_si128((__m128i *)(wk + 4 * i), _mm_add_epi32(w[i],
+			_mm_loadu_si128((__m128i const *)(sha256_k + 4 * i))));
+}
+
+/**
+ * sha256_ni_rounds2 - Runs the 64 rounds of two independent lanes
+ * @st: hash states, word i of lane l at st[i * 2 + l]
+ * @wk0: W + K schedule of lane 0
+ * @wk1: W + K schedule of lane 1
+ *
+ * Description: sha256rnds2 is bound by its latency, interleaving two
+ * dependency chains nearly doubles the throughput of a single one.
+ */
+NI_TARGET void sha256_ni_rounds2(uint32_t *st, uint32_t const wk0[64],
+	uint32_t const wk1[64])
+{
+	__m128i abef[2], cdgh[2], save[4], msg, tmp;
+	int l, t;
+
+	for (l = 0; l < 2; l++)
+	{
+		tmp = _mm_set_epi32(st[0 + l], st[2 + l], st[8 + l], st[10 + l]);
+		cdgh[l] = _mm_set_epi32(st[4 + l], st[6 + l], st[12 + l], st[14 + l]);
+		abef[l] = tmp, save[l] = tmp, save[2 + l] = cdgh[l];
+	}
+	for (t = 0; t < 64; t += 4)
+	{
+		msg = _mm_loadu_si128((__m128i const *)(wk0 + t));
+		cdgh[0] = _mm_sha256rnds2_epu32(cdgh[0], abef[0], msg);
+		tmp = _mm_loadu_si128((__m128i const *)(wk1 + t));
+		cdgh[1] = _mm_sha256rnds2_epu32(cdgh[1], abef[1], tmp);
+		abef[0] = _mm_sha256rnds2_epu32(abef[0], cdgh[0],
+			_mm_shuffle_epi32(msg, 0x0E));
+		abef[1] = _mm_sha256rnds2_epu32(abef[1], cdgh[1],
+			_mm_shuffle_epi32(tmp, 0x0E));
+	}
+	for (l = 0; l < 2; l++)
+	{
+		abef[l] = _mm_add_epi32(abef[l], save[l]);
+		cdgh[l] = _mm_add_epi32(cdgh[l], save[2 + l]);
+		st[0 + l] = _mm_extract_epi32(abef[l], 3);
+		st[2 + l] = _mm_extract_epi32(abef[l], 2);
+		st[8 + l] = _mm_extract_epi32(abef[l], 1);
+		st[10 + l] = _mm_extract_epi32(abef[l], 0);
+		st[4 + l] = _mm_extract_epi32(cdgh[l], 3);
+		st[6 + l] = _mm_extract_epi32(cdgh[l], 2);
+		st[12 + l] = _mm_extract_epi32(cdgh[l], 1);
+		st[14 + l] = _mm_extract_epi32(cdgh[l], 0);
+	}
+}
+
+#else
+
+/**
+ * sha256_mb2_ni_supported - Checks for the SHA extensions
+ * Return: Always 0 outside of x86
+ */
+int sha256_mb2_ni_supported(void)
+{
+	return (0);
+}
+
+/**
+ * sha256_mb2_ni - Stand-in for the SHA extensions kernel outside of x86
+ * @st: hash states
+ * @words: message words of each lane
+ */
+void sha256_mb2_ni(uint32_t *st, uint32_t const *words)
+{
+	(void)st, (void)words;
+}
+
+/**
+ * sha256_mb2_ni_wk - Stand-in for the SHA extensions kernel outside of x86
+ * @st: hash states
+ * @wk: schedule shared by both lanes
+ */
+void sha256_mb2_ni_wk(uint32_t *st, uint32_t const wk[64])
+{
+	(void)st, (void)wk;
+}
+
+#endif
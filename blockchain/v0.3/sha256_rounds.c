@@ -0,0 +1,100 @@
+#include "blockchain.h"
+
+/* SHA-256 round constants (FIPS 180-4, 4.2.2) */
+uint32_t const sha256_k[64] = {
+	0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+	0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+	0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+	0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+	0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+	0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+	0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+	0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+	0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+	0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+	0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/* SHA-256 initial hash value (FIPS 180-4, 5.3.3) */
+uint32_t const sha256_iv[8] = {
+	0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+	0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+/**
+ * sha256_expand - Computes the message schedule words @from to 63
+ * @w: message schedule, words 0 to @from - 1 must already be set
+ * @from: first word to compute, at least 16
+ */
+void sha256_expand(uint32_t w[64], int from)
+{
+	int t;
+
+	for (t = from; t < 64; t++)
+		w[t] = SHA_SIG1(w[t - 2]) + w[t - 7] + SHA_SIG0(w[t - 15]) + w[t - 16];
+}
+
+/**
+ * sha256_add_k - Adds the round constants to a message schedule
+ * @wk: buffer to store the W[t] + K[t] words to
+ * @w: expanded message schedule
+ * @from: first word to compute
+ */
+void sha256_add_k(uint32_t wk[64], uint32_t const w[64], int from)
+{
+	int t;
+
+	for (t = from; t < 64; t++)
+		wk[t] = w[t] + sha256_k[t];
+}
+
+/**
+ * sha256_rounds - Runs the compression rounds @from to @to - 1
+ * @v: working variables a to h
+ * @wk: message schedule of the chunk with the round constants added
+ * @from: first round to run
+ * @to: round to stop before
+ */
+void sha256_rounds(uint32_t v[8], uint32_t const wk[64], int from, int to)
+{
+	uint32_t t1, t2;
+	int t;
+
+	for (t = from; t < to; t++)
+	{
+		t1 = v[7] + SHA_EP1(v[4]) + SHA_CH(v[4], v[5], v[6]) + wk[t];
+		t2 = SHA_EP0(v[0]) + SHA_MAJ(v[0], v[1], v[2]);
+		v[7] = v[6], v[6] = v[5], v[5] = v[4], v[4] = v[3] + t1;
+		v[3] = v[2], v[2] = v[1], v[1] = v[0], v[0] = t1 + t2;
+	}
+}
+
+/**
+ * sha256_load_chunk - Loads a 64-byte chunk as big-endian message words
+ * @w: message schedule to fill, only words 0 to 15 are written
+ * @chunk: chunk to load
+ */
+void sha256_load_chunk(uint32_t w[64], uint8_t const *chunk)
+{
+	int t;
+
+	for (t = 0; t < 16; t++, chunk += 4)
+		w[t] = SHA_LOAD32(chunk);
+}
+
+/**
+ * sha256_store_digest - Writes a hash state as a big-endian digest
+ * @state: hash state
+ * @digest: buffer to write the digest to
+ */
+void sha256_store_digest(uint32_t const state[8],
+	uint8_t digest[SHA256_DIGEST_LENGTH])
+{
+	int i;
+
+	for (i = 0; i < 8; i++, digest += 4)
+	{
+		digest[0] = state[i] >> 24, digest[1] = state[i] >> 16;
+		digest[2] = state[i] >> 8, digest[3] = state[i];
+	}
+}
@@ -0,0 +1,98 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "blockchain.h"
+#include "provided/test_fixtures.h"
+
+#define NB_BLOCKS 2000
+#define NB_TXS 20
+
+/**
+ * _same_block - Compares a loaded block with the one that was saved
+ *
+ * @loaded: Block loaded back, freed
+ * @block:  Block that was saved
+ *
+ * Return: 1 if they match, 0 otherwise
+ */
+static int _same_block(block_t *loaded, block_t *block)
+{
+    transaction_t *a, *b;
+    int i, same = loaded != NULL;
+
+    same = same && !memcmp(&loaded->info, &block->info, sizeof(block->info));
+    same = same && loaded->data.len == block->data.len &&
+        !memcmp(loaded->data.buffer, block->data.buffer, block->data.len);
+    same = same && !memcmp(loaded->hash, block->hash, sizeof(block->hash));
+    same = same && llist_size(loaded->transactions) ==
+        llist_size(block->transactions);
+    for (i = 0; same && i < llist_size(block->transactions); i++)
+    {
+        a = llist_get_node_at(loaded->transactions, i);
+        b = llist_get_node_at(block->transactions, i);
+        same = !memcmp(a->id, b->id, sizeof(a->id)) &&
+            llist_size(a->inputs) == llist_size(b->inputs);
+    }
+    block_destroy(loaded);
+    return (same);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    blockchain_t *blockchain;
+    block_t *block, *last;
+    chain_log_t *log;
+    uint8_t hash[SHA256_DIGEST_LENGTH] = {0};
+    int i, fails = 0;
+
+    srand(14);
+    blockchain = _random_chain(NB_BLOCKS, NB_TXS, 0);
+    block = blockchain_tip(blockchain);
+    fails += !blockchain_serialize(blockchain, "save.hblk");
+
+    fails += !_same_block(blockchain_load_block("save.hblk", NB_BLOCKS),
+        block);
+
+    for (i = 0; i < 100; i++)
+    {
+        block = blockchain_block_at(blockchain, i * 17);
+        fails += !_same_block(blockchain_load_block("save.hblk", i * 17),
+            block);
+        fails += !_same_block(blockchain_load_block_by_hash("save.hblk",
+            block->hash), block);
+    }
+    fails += blockchain_load_block("save.hblk", NB_BLOCKS + 1) != NULL;
+    fails += blockchain_load_block_by_hash("save.hblk", hash) != NULL;
+
+    /* Missing sidecar: rebuilt */
+    remove("save.hblk" HBLK_INDEX_EXT);
+    fails += !_same_block(blockchain_load_block("save.hblk", 1000),
+        blockchain_block_at(blockchain, 1000));
+
+    /* Stale sidecar after an append: rebuilt too */
+    fails += _random_blocks(blockchain, 1, NB_TXS);
+    last = blockchain_tip(blockchain);
+    log = chain_log_open("save.hblk");
+    fails += !log;
+    chain_log_close(log);
+    fails += !_same_block(blockchain_load_block("save.hblk", NB_BLOCKS),
+        blockchain_block_at(blockchain, NB_BLOCKS));
+    log = chain_log_open("save.hblk");
+    fails += !log || chain_log_append(log, last);
+    chain_log_close(log);
+    fails += !_same_block(blockchain_load_block_by_hash("save.hblk",
+        last->hash), last);
+
+    remove("save.hblk");
+    remove("save.hblk" HBLK_INDEX_EXT);
+    printf("block_index: %s\n", fails ? "FAIL" : "OK");
+    blockchain_destroy(blockchain);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
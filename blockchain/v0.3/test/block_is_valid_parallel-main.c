@@ -0,0 +1,124 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "blockchain.h"
+
+#define NB_SENDERS 64
+
+/**
+ * _add_block - Mines a block holding a coinbase and the given transactions,
+ * and applies it to the unspent outputs
+ *
+ * @blockchain: Blockchain to add the block to
+ * @miner:      Key receiving the coinbase
+ * @txs:        Transactions to put in the block
+ * @n:          Number of transactions
+ *
+ * Return: Pointer to the block, or NULL on failure
+ */
+static block_t *_add_block(blockchain_t *blockchain, EC_KEY *miner,
+    transaction_t **txs, size_t n)
+{
+    block_t *block, *prev = llist_get_tail(blockchain->chain);
+    size_t i;
+
+    block = block_create(prev, (int8_t *)"Holberton", 9);
+    llist_add_node(block->transactions,
+        coinbase_create(miner, block->info.index), ADD_NODE_FRONT);
+    for (i = 0; i < n; i++)
+        llist_add_node(block->transactions, txs[i], ADD_NODE_REAR);
+    block_mine(block);
+    llist_add_node(blockchain->chain, block, ADD_NODE_REAR);
+    return (block);
+}
+
+/**
+ * _check_modes - Validates a block serially and in parallel
+ *
+ * @block:    Block to validate
+ * @prev:     Block before it
+ * @unspent:  Unspent outputs
+ * @expected: Result block_is_valid() should give
+ *
+ * Return: Number of results differing from @expected
+ */
+static int _check_modes(block_t *block, block_t *prev, llist_t *unspent,
+    int expected)
+{
+    struct timespec start, mid, end;
+    unsigned int nthreads[] = {0, 1, 2, 4, 16};
+    size_t i;
+    int fails = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    fails += block_is_valid(block, prev, unspent) != expected;
+    clock_gettime(CLOCK_MONOTONIC, &mid);
+    fails += block_is_valid_parallel(block, prev, unspent, 4) != expected;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("Serial %.2f ms, 4 threads %.2f ms\n",
+        ((mid.tv_sec - start.tv_sec) * 1e9 + (mid.tv_nsec - start.tv_nsec))
+        / 1e6, ((end.tv_sec - mid.tv_sec) * 1e9 +
+        (end.tv_nsec - mid.tv_nsec)) / 1e6);
+    for (i = 0; i < sizeof(nthreads) / sizeof(*nthreads); i++)
+        fails += block_is_valid_parallel(block, prev, unspent,
+            nthreads[i]) != expected;
+    return (fails);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    blockchain_t *blockchain = blockchain_create();
+    EC_KEY *senders[NB_SENDERS], *receiver = ec_create();
+    transaction_t *txs[NB_SENDERS];
+    block_t *block, *prev;
+    tx_in_t *in;
+    size_t i;
+    int fails = 0;
+
+    /* One coinbase for each sender */
+    for (i = 0; i < NB_SENDERS; i++)
+    {
+        senders[i] = ec_create();
+        block = _add_block(blockchain, senders[i], NULL, 0);
+        update_unspent(block->transactions, block->hash, blockchain->unspent);
+    }
+
+    /* Then a block where they all spend it */
+    for (i = 0; i < NB_SENDERS; i++)
+    {
+        txs[i] = transaction_create(senders[i], receiver, 40,
+            blockchain->unspent);
+        fails += !txs[i];
+    }
+    prev = llist_get_tail(blockchain->chain);
+    block = _add_block(blockchain, receiver, txs, NB_SENDERS);
+    fails += _check_modes(block, prev, blockchain->unspent, 0);
+
+    /* The signatures aren't hashed, the block stays well formed */
+    in = llist_get_head(txs[NB_SENDERS / 2]->inputs);
+    in->sig.sig[in->sig.len - 1] ^= 0xff;
+    fails += _check_modes(block, prev, blockchain->unspent, 1);
+    in->sig.sig[in->sig.len - 1] ^= 0xff;
+    fails += _check_modes(block, prev, blockchain->unspent, 0);
+
+    /* A missing output is still caught before any signature is checked */
+    in = llist_get_head(txs[NB_SENDERS - 1]->inputs);
+    in->tx_id[0] ^= 0xff;
+    fails += _check_modes(block, prev, blockchain->unspent, 1);
+    in->tx_id[0] ^= 0xff;
+
+    printf("block_is_valid_parallel: %s\n", fails ? "FAIL" : "OK");
+    blockchain_destroy(blockchain);
+    for (i = 0; i < NB_SENDERS; i++)
+        EC_KEY_free(senders[i]);
+    EC_KEY_free(receiver);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,77 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "blockchain.h"
+
+/**
+ * _print_hex_buffer - Prints a buffer in its hexadecimal form
+ *
+ * @buf: Pointer to the buffer to be printed
+ * @len: Number of bytes from @buf to be printed
+ */
+static void _print_hex_buffer(uint8_t const *buf, size_t len)
+{
+    size_t i;
+
+    for (i = 0; buf && i < len; i++)
+        printf("%02x", buf[i]);
+}
+
+/**
+ * _mine_both - Mines a copy of a block serially and in parallel
+ *
+ * @prev:     Previous block
+ * @s:        Block data
+ * @nthreads: Number of workers for the parallel miner
+ *
+ * Return: 0 if both miners settle on the same nonce and hash, 1 otherwise
+ */
+static int _mine_both(block_t const *prev, char const *s,
+    unsigned int nthreads)
+{
+    block_t *serial, *parallel;
+    int ret;
+
+    serial = block_create(prev, (int8_t *)s, (uint32_t)strlen(s));
+    serial->info.difficulty = 16;
+    parallel = block_create(prev, (int8_t *)s, (uint32_t)strlen(s));
+    parallel->info = serial->info;
+
+    block_mine(serial);
+    block_mine_parallel(parallel, nthreads);
+
+    ret = serial->info.nonce != parallel->info.nonce ||
+        memcmp(serial->hash, parallel->hash, SHA256_DIGEST_LENGTH);
+    printf("[%u threads] nonce: %lu ", nthreads, parallel->info.nonce);
+    _print_hex_buffer(parallel->hash, SHA256_DIGEST_LENGTH);
+    printf(" %s\n", ret ? "MISMATCH" : "OK");
+
+    block_destroy(serial);
+    block_destroy(parallel);
+    return (ret);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    blockchain_t *blockchain;
+    block_t *block;
+    int ret = 0;
+
+    blockchain = blockchain_create();
+    block = llist_get_head(blockchain->chain);
+
+    ret |= _mine_both(block, "Holberton", 1);
+    ret |= _mine_both(block, "School", 2);
+    ret |= _mine_both(block, "of", 4);
+    ret |= _mine_both(block, "Software", 7);
+
+    blockchain_destroy(blockchain);
+
+    return (ret ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,49 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "blockchain.h"
+#include "provided/test_fixtures.h"
+
+#define NB_BLOCKS 2000
+#define NB_TXS 20
+#define NB_UNSPENT 20000
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    blockchain_t *blockchain, *loaded;
+    unsigned int const threads[] = {1, 2, 3, 8, 0};
+    int i, fails = 0;
+
+    srand(17);
+    blockchain = _random_chain(NB_BLOCKS, NB_TXS, NB_UNSPENT);
+    fails += !blockchain_serialize(blockchain, "save.hblk");
+
+    /* Whatever the number of threads, the chain comes back in order */
+    for (i = 0; i < (int)(sizeof(threads) / sizeof(*threads)); i++)
+    {
+        loaded = blockchain_deserialize_parallel("save.hblk", threads[i]);
+        fails += !loaded || !blockchain_serialize(loaded, "copy.hblk");
+        fails += !_same_files("save.hblk", "copy.hblk");
+        blockchain_destroy(loaded);
+    }
+
+    /* A truncated file is refused */
+    fails += truncate("copy.hblk", 100000) ||
+        blockchain_deserialize_parallel("copy.hblk", 4);
+    remove("copy.hblk");
+    remove("copy.hblk" HBLK_INDEX_EXT);
+    remove("save.hblk");
+    remove("save.hblk" HBLK_INDEX_EXT);
+
+    printf("blockchain_deserialize_parallel: %s\n", fails ? "FAIL" : "OK");
+    blockchain_destroy(blockchain);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,76 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "blockchain.h"
+
+#define NB_BLOCKS 20000
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    blockchain_t *blockchain = blockchain_create();
+    block_t *block = llist_get_head(blockchain->chain), *genesis = block;
+    uint8_t missing[SHA256_DIGEST_LENGTH] = {0};
+    blockchain_t *loaded;
+    uint8_t old_hash[SHA256_DIGEST_LENGTH];
+    block_t *deep;
+    int i, fails = 0;
+
+    /* Blocks appended by blockchain_add_block() are filed by hash */
+    for (i = 1; i < NB_BLOCKS; i++)
+    {
+        block = block_create(block, (int8_t *)"Holberton", 9);
+        block_hash(block, block->hash);
+        fails += blockchain_add_block(blockchain, block);
+    }
+    for (i = 0; i < NB_BLOCKS; i += 7)
+    {
+        block = blockchain_block_at(blockchain, i);
+        fails += blockchain_find_block(blockchain, block->hash) != block;
+    }
+    fails += blockchain_find_block(blockchain, missing) != NULL;
+
+    deep = blockchain_tip(blockchain);
+    fails += blockchain_find_block(blockchain, deep->hash) != deep;
+
+    /* A block hashed again is found by its new hash once the edit counts */
+    block = blockchain_block_at(blockchain, NB_BLOCKS / 2);
+    memcpy(old_hash, block->hash, SHA256_DIGEST_LENGTH);
+    block->info.nonce++;
+    block_hash(block, block->hash);
+    blockchain->edits++;
+    fails += blockchain_find_block(blockchain, block->hash) != block;
+    fails += blockchain_find_block(blockchain, old_hash) != NULL;
+    fails += chain_store_sync(blockchain);
+    fails += blockchain_find_block(blockchain, block->hash) != block;
+    fails += blockchain_find_block(blockchain, old_hash) != NULL;
+
+    /* Reads walk the list behind a direct edit, without filling the table */
+    block = block_create(deep, (int8_t *)"Holberton", 9);
+    block_hash(block, block->hash);
+    llist_add_node(blockchain->chain, block, ADD_NODE_REAR);
+    fails += blockchain_find_block(blockchain, block->hash) != block;
+    fails += blockchain->store.count != NB_BLOCKS;
+    llist_pop(blockchain->chain);
+    fails += blockchain_find_block(blockchain, genesis->hash) != NULL;
+    fails += blockchain_find_block(blockchain, deep->hash) != deep;
+    block_destroy(genesis);
+
+    /* A loaded chain is filed by the loader */
+    fails += !blockchain_serialize(blockchain, "save.hblk");
+    loaded = blockchain_deserialize("save.hblk");
+    fails += !loaded || loaded->store.count != NB_BLOCKS;
+    fails += loaded && !blockchain_find_block(loaded, deep->hash);
+    blockchain_destroy(loaded);
+    remove("save.hblk");
+
+    printf("blockchain_find_block: %s\n", fails ? "FAIL" : "OK");
+    blockchain_destroy(blockchain);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
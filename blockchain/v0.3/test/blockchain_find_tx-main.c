@@ -0,0 +1,89 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "blockchain.h"
+#include "provided/test_fixtures.h"
+
+#define NB_BLOCKS 1000
+#define NB_TXS 10
+
+/**
+ * _check - Checks a transaction is found where it is, in memory and in
+ * the sidecar
+ *
+ * @blockchain: Chain, saved to @path
+ * @path:       Chain file
+ * @height:     Height of the block holding the transaction
+ * @pos:        Position of the transaction in the block
+ *
+ * Return: Number of failures
+ */
+static int _check(blockchain_t const *blockchain, char const *path,
+    uint32_t height, uint32_t pos)
+{
+    block_t *block = blockchain_block_at(blockchain, height), *loaded;
+    transaction_t *tx = llist_get_node_at(block->transactions, pos);
+    uint32_t found_height = 0, found_pos = 0;
+    int fails = 0;
+
+    fails += blockchain_find_tx(blockchain, tx->id, &found_height,
+        &found_pos) != tx;
+    fails += found_height != height || found_pos != pos;
+    found_pos = 0;
+    loaded = blockchain_load_block_by_tx(path, tx->id, &found_pos);
+    fails += !loaded || memcmp(loaded->hash, block->hash,
+        SHA256_DIGEST_LENGTH) || found_pos != pos;
+    block_destroy(loaded);
+    return (fails);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    blockchain_t *blockchain = blockchain_create();
+    uint8_t missing[SHA256_DIGEST_LENGTH] = {0};
+    chain_log_t *log;
+    int i, fails = 0;
+
+    srand(23);
+    /* Half the blocks come before the index, half are appended to it */
+    fails += _random_blocks(blockchain, NB_BLOCKS / 2 - 1, NB_TXS);
+    fails += blockchain_index_txs(blockchain);
+    fails += _random_blocks(blockchain, NB_BLOCKS - NB_BLOCKS / 2, NB_TXS);
+    fails += blockchain->store.tx_count != (NB_BLOCKS - 1) * NB_TXS;
+    fails += !blockchain_serialize(blockchain, "save.hblk");
+    fails += tx_index_save(blockchain, "save.hblk");
+
+    for (i = 1; i < NB_BLOCKS; i += 37)
+        fails += _check(blockchain, "save.hblk", i, i % NB_TXS);
+    fails += _check(blockchain, "save.hblk", NB_BLOCKS - 1, NB_TXS - 1);
+    fails += blockchain_find_tx(blockchain, missing, NULL, NULL) != NULL;
+    fails += blockchain_load_block_by_tx("save.hblk", missing, NULL) != NULL;
+
+    remove("save.hblk");
+    remove("save.hblk" HBLK_INDEX_EXT);
+    remove("save.hblk" TX_INDEX_EXT);
+
+    /* A block appended to a log after the sidecar was saved is found */
+    log = chain_log_open("log.hblk");
+    fails += !log || chain_log_sync(log, blockchain);
+    fails += tx_index_save(blockchain, "log.hblk");
+    fails += _random_blocks(blockchain, 1, NB_TXS);
+    fails += !log || chain_log_append(log, blockchain_tip(blockchain));
+    chain_log_close(log);
+    fails += _check(blockchain, "log.hblk", NB_BLOCKS, NB_TXS - 1);
+    fails += _check(blockchain, "log.hblk", 1, 0);
+    remove("log.hblk");
+    remove("log.hblk" HBLK_INDEX_EXT);
+    remove("log.hblk" TX_INDEX_EXT);
+
+    printf("blockchain_find_tx: %s\n", fails ? "FAIL" : "OK");
+    blockchain_destroy(blockchain);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
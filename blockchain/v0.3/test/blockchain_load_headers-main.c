@@ -0,0 +1,147 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "blockchain.h"
+#include "provided/test_fixtures.h"
+
+#define NB_BLOCKS 2000
+#define NB_TXS 20
+#define NB_UNSPENT 20000
+
+/**
+ * _same_txs - Compares two lists of transactions by ID and counts
+ *
+ * @a: First list
+ * @b: Second list
+ *
+ * Return: 1 if they match, 0 otherwise
+ */
+static int _same_txs(llist_t *a, llist_t *b)
+{
+    transaction_t *ta, *tb;
+    int i;
+
+    if (llist_size(a) != llist_size(b))
+        return (0);
+    for (i = 0; i < llist_size(a); i++)
+    {
+        ta = llist_get_node_at(a, i);
+        tb = llist_get_node_at(b, i);
+        if (memcmp(ta->id, tb->id, SHA256_DIGEST_LENGTH) ||
+            llist_size(ta->inputs) != llist_size(tb->inputs) ||
+            llist_size(ta->outputs) != llist_size(tb->outputs))
+            return (0);
+    }
+    return (1);
+}
+
+/**
+ * _round_trip - Saves a chain and checks it loads back as another one
+ *
+ * @saved:    Chain to save
+ * @expected: Chain it must load back as
+ * @compact:  1 to save in the compact format, 0 otherwise
+ *
+ * Return: 0 if the blocks match, 1 otherwise
+ */
+static int _round_trip(blockchain_t const *saved,
+    blockchain_t const *expected, int compact)
+{
+    blockchain_t *loaded;
+    block_t *a, *b;
+    int i, fails = 0;
+
+    if (compact)
+        fails += !blockchain_serialize_compact(saved, "lazy.hblk");
+    else
+        fails += !blockchain_serialize(saved, "lazy.hblk");
+    loaded = blockchain_deserialize("lazy.hblk");
+    fails += !loaded ||
+        llist_size(loaded->chain) != llist_size(expected->chain);
+    for (i = 0; !fails && i < llist_size(expected->chain); i++)
+    {
+        a = blockchain_block_at(loaded, i);
+        b = blockchain_block_at(expected, i);
+        fails += memcmp(a->hash, b->hash, SHA256_DIGEST_LENGTH);
+        fails += !a->transactions != !b->transactions;
+        fails += b->transactions && !_same_txs(a->transactions,
+            b->transactions);
+    }
+    blockchain_destroy(loaded);
+    remove("lazy.hblk");
+    remove("lazy.hblk" HBLK_INDEX_EXT);
+    return (fails != 0);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    uint8_t hash[SHA256_DIGEST_LENGTH], expected[SHA256_DIGEST_LENGTH];
+    blockchain_t *blockchain;
+    block_t *block, *lazy_block;
+    chain_lazy_t *lazy;
+    llist_t *txs;
+    int i, fails = 0;
+
+    srand(20);
+    blockchain = _random_chain(NB_BLOCKS, NB_TXS, NB_UNSPENT);
+    /* Spread out, so that blockchain_difficulty() has retargets to do */
+    for (i = 1; i <= NB_BLOCKS; i++)
+        blockchain_block_at(blockchain, i)->info.timestamp = (i - 1) * 60;
+    fails += !blockchain_serialize(blockchain, "save.hblk");
+
+    lazy = blockchain_load_headers("save.hblk");
+
+    /* Headers are there, transactions aren't yet */
+    fails += !lazy || llist_size(lazy->blockchain->chain) !=
+        llist_size(blockchain->chain);
+    fails += !lazy || llist_size(lazy->blockchain->unspent) != NB_UNSPENT;
+    fails += !lazy || blockchain_difficulty(lazy->blockchain) !=
+        blockchain_difficulty(blockchain);
+    for (i = 0; !fails && i < llist_size(blockchain->chain); i++)
+    {
+        block = blockchain_block_at(blockchain, i);
+        lazy_block = blockchain_block_at(lazy->blockchain, i);
+        fails += memcmp(&block->info, &lazy_block->info, sizeof(block->info));
+        fails += memcmp(block->hash, lazy_block->hash, SHA256_DIGEST_LENGTH);
+        fails += lazy_block->transactions != NULL;
+    }
+
+    /* A pending block can't be hashed without its transaction IDs */
+    lazy_block = lazy ? lazy->blocks[NB_BLOCKS / 2] : NULL;
+    fails += !lazy_block || block_hash(lazy_block, hash) != NULL;
+
+    /* They are decoded on first access, then kept */
+    txs = chain_lazy_txs(lazy, lazy_block);
+    block_hash(blockchain_block_at(blockchain, NB_BLOCKS / 2), expected);
+    fails += !lazy_block || block_hash(lazy_block, hash) != hash ||
+        memcmp(hash, expected, SHA256_DIGEST_LENGTH);
+    fails += !txs || !_same_txs(txs, blockchain_block_at(blockchain,
+        NB_BLOCKS / 2)->transactions);
+    fails += !lazy_block || chain_lazy_txs(lazy, lazy_block) != txs ||
+        lazy_block->transactions != txs;
+    fails += !lazy || lazy->blocks[NB_BLOCKS / 2 + 1]->transactions != NULL;
+    fails += !lazy || lazy->blocks[NB_BLOCKS / 2 + 1]->lazy != lazy;
+    fails += !lazy_block || lazy_block->lazy != NULL;
+    /* The genesis block has no list of transactions to decode */
+    fails += !lazy || chain_lazy_txs(lazy, lazy->blocks[0]) != NULL;
+    fails += !lazy || lazy->blocks[0]->lazy != NULL;
+
+    /* Pending blocks are saved with their transactions, and stay pending */
+    fails += !lazy || _round_trip(lazy->blockchain, blockchain, 0);
+    fails += !lazy || _round_trip(lazy->blockchain, blockchain, 1);
+    fails += !lazy || lazy->blocks[NB_BLOCKS / 2 + 1]->lazy != lazy;
+    chain_lazy_close(lazy);
+    remove("save.hblk");
+    remove("save.hblk" HBLK_INDEX_EXT);
+
+    printf("blockchain_load_headers: %s\n", fails ? "FAIL" : "OK");
+    blockchain_destroy(blockchain);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
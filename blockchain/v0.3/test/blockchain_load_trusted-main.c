@@ -0,0 +1,155 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "blockchain.h"
+#include "provided/test_fixtures.h"
+
+#define NB_BLOCKS 2000
+#define NB_TXS 20
+#define BAD_BLOCK 1234
+
+/**
+ * _check_kernels - Checks every CRC-32C kernel the CPU runs against the
+ * reference value, whole and in pieces
+ *
+ * Return: Number of failures
+ */
+static int _check_kernels(void)
+{
+    crc32c_kernel_t const *kernel = crc32c_kernels;
+    uint8_t const *check = (uint8_t const *)"123456789";
+    uint8_t buf[1000];
+    uint32_t whole;
+    int fails = 0;
+
+    _fill(buf, sizeof(buf));
+    whole = crc32c(0, buf, sizeof(buf));
+    printf("CRC-32C kernel: %s\n", crc32c_kernel()->name);
+    for (; kernel->name; kernel++)
+    {
+        if (!kernel->supported())
+            continue;
+        fails += kernel->update(0, check, 9) != 0xe3069283;
+        fails += kernel->update(kernel->update(0, buf, 333), buf + 333,
+            sizeof(buf) - 333) != whole;
+    }
+    return (fails);
+}
+
+/**
+ * _corrupt - Flips one byte of the data of a block in a chain file
+ *
+ * @path:   Chain file
+ * @height: Height of the block
+ *
+ * Return: 0 on success, 1 on failure
+ */
+static int _corrupt(char const *path, uint32_t height)
+{
+    chain_map_t *map = chain_map_open(path);
+    uint8_t byte;
+    off_t off;
+    int fd, fails;
+
+    if (!map)
+        return (1);
+    off = map->blocks[height] + sizeof(block_info_t) + 4;
+    chain_map_close(map);
+    fd = open(path, O_RDWR);
+    fails = fd == -1 || pread(fd, &byte, 1, off) != 1;
+    byte ^= 0x20;
+    fails += fd == -1 || pwrite(fd, &byte, 1, off) != 1;
+    if (fd != -1)
+        close(fd);
+    return (fails);
+}
+
+/**
+ * _rewrite_tip - Saves a chain again with another tip of the same size, over
+ * a chain file whose sidecar is kept
+ *
+ * @blockchain: Chain saved in @path, its tip is changed
+ * @path:       Chain file
+ *
+ * Return: 0 on success, 1 on failure
+ */
+static int _rewrite_tip(blockchain_t *blockchain, char const *path)
+{
+    block_t *tip = llist_get_tail(blockchain->chain);
+
+    tip->info.nonce++;
+    block_hash(tip, tip->hash);
+    if (!blockchain_serialize(blockchain, "other.hblk"))
+        return (1);
+    remove("other.hblk" HBLK_INDEX_EXT);
+    return (rename("other.hblk", path) != 0);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    blockchain_t *blockchain, *loaded;
+    chain_verify_t verify;
+    uint32_t nblocks;
+    int fails = 0, fd;
+
+    srand(19);
+    fails += _check_kernels();
+    blockchain = _random_chain(NB_BLOCKS, NB_TXS, 0);
+    fails += !blockchain_serialize(blockchain, "save.hblk");
+
+    /* The CRCs are checked up front, the hashes in the background */
+    loaded = blockchain_load_trusted("save.hblk", &verify);
+    fails += !loaded || chain_verify_wait(&verify);
+    blockchain_destroy(loaded);
+
+    /* A corrupted block fails its CRC */
+    fails += _corrupt("save.hblk", BAD_BLOCK);
+    loaded = blockchain_load_trusted("save.hblk", &verify);
+    fails += loaded || verify.bad != BAD_BLOCK;
+
+    /* A rebuilt sidecar vouches for nothing: the hashes are checked first */
+    fails += block_index_rebuild("save.hblk");
+    loaded = blockchain_load_trusted("save.hblk", &verify);
+    fails += loaded || verify.bad != BAD_BLOCK;
+    fails += access("save.hblk" HBLK_INDEX_EXT, F_OK);
+
+    /* Without a sidecar the hashes are checked before returning */
+    remove("save.hblk" HBLK_INDEX_EXT);
+    loaded = blockchain_load_trusted("save.hblk", &verify);
+    fails += loaded || verify.bad != BAD_BLOCK;
+    fails += !blockchain_serialize(blockchain, "save.hblk");
+    remove("save.hblk" HBLK_INDEX_EXT);
+    loaded = blockchain_load_trusted("save.hblk", &verify);
+    fails += !loaded || chain_verify_wait(&verify);
+    fails += access("save.hblk" HBLK_INDEX_EXT, F_OK);
+    blockchain_destroy(loaded);
+
+    /* A chain rewritten with as many bytes leaves the sidecar stale */
+    fails += _rewrite_tip(blockchain, "save.hblk");
+    fd = block_index_open("save.hblk", &nblocks, -1);
+    fails += fd != -1;
+    if (fd != -1)
+        close(fd);
+    loaded = blockchain_load_trusted("save.hblk", &verify);
+    fails += !loaded || chain_verify_wait(&verify);
+    fails += !loaded || memcmp(
+        ((block_t *)llist_get_tail(loaded->chain))->hash,
+        ((block_t *)llist_get_tail(blockchain->chain))->hash,
+        SHA256_DIGEST_LENGTH);
+    blockchain_destroy(loaded);
+    remove("save.hblk");
+    remove("save.hblk" HBLK_INDEX_EXT);
+
+    printf("blockchain_load_trusted: %s\n", fails ? "FAIL" : "OK");
+    blockchain_destroy(blockchain);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,193 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "blockchain.h"
+#include "provided/test_fixtures.h"
+
+#define NB_BLOCKS 2000
+#define NB_TXS 20
+#define NB_UNSPENT 20000
+
+/**
+ * _write_in - llist_for_each() action writing an input the way the
+ * serializer used to, one fwrite() per record
+ *
+ * @node:  Input
+ * @iter:  Unused
+ * @fptr:  File to write to
+ *
+ * Return: 0
+ */
+static int _write_in(llist_node_t node, unsigned int iter, void *fptr)
+{
+    tx_in_t *in = node;
+    uint8_t buf[169];
+
+    (void)iter;
+    memcpy(&buf[0], in->block_hash, 32);
+    memcpy(&buf[32], in->tx_id, 32);
+    memcpy(&buf[64], in->tx_out_hash, 32);
+    memcpy(&buf[96], in->sig.sig, 72);
+    memcpy(&buf[168], &in->sig.len, 1);
+    fwrite(buf, 1, sizeof(buf), fptr);
+    return (0);
+}
+
+/**
+ * _write_out - llist_for_each() action writing an output with fwrite()
+ *
+ * @node:  Output
+ * @iter:  Unused
+ * @fptr:  File to write to
+ *
+ * Return: 0
+ */
+static int _write_out(llist_node_t node, unsigned int iter, void *fptr)
+{
+    tx_out_t *out = node;
+    uint8_t buf[101];
+
+    (void)iter;
+    memcpy(&buf[0], &out->amount, 4);
+    memcpy(&buf[4], out->pub, 65);
+    memcpy(&buf[69], out->hash, 32);
+    fwrite(buf, 1, sizeof(buf), fptr);
+    return (0);
+}
+
+/**
+ * _write_tx - llist_for_each() action writing a transaction with fwrite()
+ *
+ * @node:  Transaction
+ * @iter:  Unused
+ * @fptr:  File to write to
+ *
+ * Return: 0
+ */
+static int _write_tx(llist_node_t node, unsigned int iter, void *fptr)
+{
+    transaction_t *tx = node;
+    int ins = llist_size(tx->inputs), outs = llist_size(tx->outputs);
+    uint8_t buf[40];
+
+    (void)iter;
+    memcpy(&buf[0], tx->id, 32);
+    memcpy(&buf[32], &ins, 4);
+    memcpy(&buf[36], &outs, 4);
+    fwrite(buf, 1, sizeof(buf), fptr);
+    llist_for_each(tx->inputs, _write_in, fptr);
+    llist_for_each(tx->outputs, _write_out, fptr);
+    return (0);
+}
+
+/**
+ * _write_block - llist_for_each() action writing a block with fwrite()
+ *
+ * @node:  Block
+ * @iter:  Unused
+ * @fptr:  File to write to
+ *
+ * Return: 0
+ */
+static int _write_block(llist_node_t node, unsigned int iter, void *fptr)
+{
+    block_t *block = node;
+    int tx_size = llist_size(block->transactions);
+    uint32_t len = block->data.len;
+    uint8_t buf[96 + BLOCKCHAIN_DATA_MAX];
+
+    (void)iter;
+    memcpy(&buf[0], &block->info, sizeof(block->info));
+    memcpy(&buf[56], &len, 4);
+    memcpy(&buf[60], block->data.buffer, len);
+    memcpy(&buf[60 + len], block->hash, 32);
+    memcpy(&buf[92 + len], &tx_size, 4);
+    fwrite(buf, 1, 96 + len, fptr);
+    if (tx_size > 0)
+        llist_for_each(block->transactions, _write_tx, fptr);
+    return (0);
+}
+
+/**
+ * _write_unspent - llist_for_each() action writing an unspent output with
+ * fwrite()
+ *
+ * @node:  Unspent output
+ * @iter:  Unused
+ * @fptr:  File to write to
+ *
+ * Return: 0
+ */
+static int _write_unspent(llist_node_t node, unsigned int iter, void *fptr)
+{
+    uto_t *unspent = node;
+    uint8_t buf[165];
+
+    (void)iter;
+    memcpy(&buf[0], unspent->block_hash, 32);
+    memcpy(&buf[32], unspent->tx_id, 32);
+    memcpy(&buf[64], &unspent->out.amount, 4);
+    memcpy(&buf[68], unspent->out.pub, 65);
+    memcpy(&buf[133], unspent->out.hash, 32);
+    fwrite(buf, 1, sizeof(buf), fptr);
+    return (0);
+}
+
+/**
+ * _stdio_serialize - Reference serializer, one stdio call per record
+ *
+ * @blockchain: Chain to serialize
+ * @path:       File to write
+ */
+static void _stdio_serialize(blockchain_t const *blockchain, char const *path)
+{
+    FILE *fptr = fopen(path, "w");
+    int blocks = llist_size(blockchain->chain);
+    int unspent = llist_size(blockchain->unspent);
+
+    uint8_t header[16];
+
+    memcpy(&header[0], FHEADER, 7);
+    memcpy(&header[7], END, 1);
+    memcpy(&header[8], &blocks, 4);
+    memcpy(&header[12], &unspent, 4);
+    fwrite(header, 1, sizeof(header), fptr);
+    llist_for_each(blockchain->chain, _write_block, fptr);
+    llist_for_each(blockchain->unspent, _write_unspent, fptr);
+    fclose(fptr);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    blockchain_t *blockchain;
+    struct timespec start, mid, end;
+    int fails = 0;
+
+    srand(11);
+    blockchain = _random_chain(NB_BLOCKS, NB_TXS, NB_UNSPENT);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    _stdio_serialize(blockchain, "save_stdio.hblk");
+    clock_gettime(CLOCK_MONOTONIC, &mid);
+    fails += !blockchain_serialize(blockchain, "save.hblk");
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("stdio %.1f ms, buffered %.1f ms\n", _elapsed_ms(&start, &mid),
+        _elapsed_ms(&mid, &end));
+    fails += !_same_files("save_stdio.hblk", "save.hblk");
+    fails += blockchain_serialize(blockchain, "no/such/dir.hblk");
+    remove("save_stdio.hblk");
+    remove("save.hblk");
+    remove("save.hblk" HBLK_INDEX_EXT);
+
+    printf("blockchain_serialize: %s\n", fails ? "FAIL" : "OK");
+    blockchain_destroy(blockchain);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,133 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "blockchain.h"
+#include "provided/test_fixtures.h"
+
+#define NB_BLOCKS 300
+#define NB_TXS 10
+#define NB_KEYS 32
+
+/**
+ * _signed_tx - Creates a transaction with one signed input and two outputs
+ * to real keys
+ *
+ * @keys: Keys to pick from
+ *
+ * Return: Pointer to the transaction
+ */
+static transaction_t *_signed_tx(EC_KEY **keys)
+{
+    transaction_t *tx = calloc(1, sizeof(*tx));
+    uint8_t pub[EC_PUB_LEN];
+    tx_in_t *in;
+    tx_out_t *out;
+    int i;
+
+    tx->inputs = llist_create(MT_SUPPORT_FALSE);
+    tx->outputs = llist_create(MT_SUPPORT_FALSE);
+    in = calloc(1, sizeof(*in));
+    _fill(in->block_hash, sizeof(in->block_hash));
+    _fill(in->tx_id, sizeof(in->tx_id));
+    _fill(in->tx_out_hash, sizeof(in->tx_out_hash));
+    llist_add_node(tx->inputs, in, ADD_NODE_REAR);
+    for (i = 0; i < 2; i++)
+    {
+        ec_to_pub(keys[rand() % NB_KEYS], pub);
+        out = tx_out_create(1 + rand() % 1000, pub);
+        llist_add_node(tx->outputs, out, ADD_NODE_REAR);
+    }
+    transaction_hash(tx, tx->id);
+    ec_sign(keys[rand() % NB_KEYS], tx->id, sizeof(tx->id), &in->sig);
+    return (tx);
+}
+
+/**
+ * _file_size - Gets the size of a file
+ *
+ * @path: File
+ *
+ * Return: Size in bytes
+ */
+static long _file_size(char const *path)
+{
+    struct stat st;
+
+    return (stat(path, &st) ? -1 : st.st_size);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    blockchain_t *blockchain = blockchain_create(), *loaded;
+    block_t *block = llist_get_head(blockchain->chain);
+    EC_KEY *keys[NB_KEYS];
+    transaction_t *tx;
+    tx_out_t *out;
+    int i, j, fails = 0;
+
+    srand(15);
+    for (i = 0; i < NB_KEYS; i++)
+        keys[i] = ec_create();
+    for (i = 0; i < NB_BLOCKS; i++)
+    {
+        block = block_create(block, (int8_t *)"Holberton", 9);
+        for (j = 0; j < NB_TXS; j++)
+            llist_add_node(block->transactions, _signed_tx(keys),
+                ADD_NODE_REAR);
+        /* Hashes that can't be computed back have to be stored */
+        if (i == NB_BLOCKS / 2)
+            _fill(llist_get_tail(block->transactions), SHA256_DIGEST_LENGTH);
+        block_hash(block, block->hash);
+        if (i == NB_BLOCKS / 3)
+            _fill(block->hash, sizeof(block->hash));
+        for (j = 0; j < NB_TXS; j++)
+        {
+            tx = llist_get_node_at(block->transactions, j);
+            llist_add_node(blockchain->unspent,
+                unspent_tx_out_create(block->hash, tx->id,
+                    llist_get_head(tx->outputs)), ADD_NODE_REAR);
+        }
+        fails += blockchain_add_block(blockchain, block);
+    }
+    /* A key that isn't a point of the curve is kept as it is */
+    out = llist_get_head(tx->outputs);
+    _fill(out->pub, sizeof(out->pub));
+
+    fails += !blockchain_serialize(blockchain, "save.hblk");
+    fails += !blockchain_convert("save.hblk", "compact.hblk", 1);
+    printf("v0.3 %ld bytes, compact %ld bytes\n", _file_size("save.hblk"),
+        _file_size("compact.hblk"));
+    fails += _file_size("compact.hblk") * 10 > _file_size("save.hblk") * 6;
+
+    /* The loader reads both, and the conversion loses nothing */
+    loaded = blockchain_deserialize("compact.hblk");
+    fails += !loaded || !blockchain_serialize(loaded, "copy.hblk");
+    fails += !_same_files("save.hblk", "copy.hblk");
+    blockchain_destroy(loaded);
+    fails += !blockchain_convert("compact.hblk", "copy.hblk", 0);
+    fails += !_same_files("save.hblk", "copy.hblk");
+
+    /* A truncated file is refused */
+    fails += truncate("compact.hblk", _file_size("compact.hblk") - 1) ||
+        blockchain_deserialize("compact.hblk") != NULL;
+
+    remove("save.hblk");
+    remove("save.hblk" HBLK_INDEX_EXT);
+    remove("copy.hblk");
+    remove("copy.hblk" HBLK_INDEX_EXT);
+    remove("compact.hblk");
+    printf("blockchain_serialize_compact: %s\n", fails ? "FAIL" : "OK");
+    blockchain_destroy(blockchain);
+    for (i = 0; i < NB_KEYS; i++)
+        EC_KEY_free(keys[i]);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,107 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+/* signal.h and hblk_crypto.h both name a type sig_t */
+#define sig_t _signal_sig_t
+#include <signal.h>
+#undef sig_t
+
+#include "blockchain.h"
+#include "provided/test_fixtures.h"
+
+#define NB_BLOCKS 500
+#define NB_TXS 20
+#define NB_UNSPENT 10000
+
+/**
+ * _append_over - Appends a block to a log past a file size limit, which
+ * makes the append fail
+ *
+ * @log:   Log to append to
+ * @block: Block to append
+ *
+ * Return: 0 if the append failed, 1 otherwise
+ */
+static int _append_over(chain_log_t *log, block_t const *block)
+{
+    struct rlimit limit, small;
+    int ret;
+
+    signal(SIGXFSZ, SIG_IGN);
+    getrlimit(RLIMIT_FSIZE, &limit);
+    small = limit;
+    small.rlim_cur = log->size + 10;
+    setrlimit(RLIMIT_FSIZE, &small);
+    ret = chain_log_append(log, block);
+    setrlimit(RLIMIT_FSIZE, &limit);
+    return (ret == 0);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    blockchain_t *blockchain = blockchain_create(), *loaded;
+    chain_log_t *log;
+    FILE *fptr;
+    int i, fails = 0;
+
+    srand(13);
+    remove("chain.log");
+    log = chain_log_open("chain.log");
+    fails += !log || chain_log_sync(log, blockchain);
+    for (i = 0; i < NB_BLOCKS; i++)
+    {
+        fails += _random_blocks(blockchain, 1, NB_TXS);
+        fails += chain_log_append(log, blockchain_tip(blockchain));
+    }
+    fails += log->nblocks != NB_BLOCKS + 1;
+    fails += _random_unspent(blockchain, NB_UNSPENT);
+    chain_log_close(log);
+    fails += unspent_save(blockchain->unspent, "chain.utxo");
+    blockchain_serialize(blockchain, "save.hblk");
+
+    /* The log and the outputs load back to the very same chain */
+    loaded = chain_log_load("chain.log", "chain.utxo");
+    fails += !loaded || !blockchain_serialize(loaded, "copy.hblk");
+    fails += !_same_files("save.hblk", "copy.hblk");
+    blockchain_destroy(loaded);
+
+    /* Bytes of an interrupted append are dropped, appends carry on */
+    fptr = fopen("chain.log", "a");
+    fputs("torn block", fptr);
+    fclose(fptr);
+    log = chain_log_open("chain.log");
+    fails += !log || log->nblocks != NB_BLOCKS + 1;
+    fails += _random_blocks(blockchain, 1, NB_TXS);
+    fails += !log || chain_log_sync(log, blockchain);
+
+    /* A failed append is cut off, the next one goes through */
+    fails += _random_blocks(blockchain, 1, NB_TXS);
+    fails += !log || _append_over(log, blockchain_tip(blockchain));
+    fails += !log || log->nblocks != NB_BLOCKS + 2;
+    fails += !log || chain_log_sync(log, blockchain);
+    fails += !log || log->nblocks != NB_BLOCKS + 3;
+    chain_log_close(log);
+    fails += unspent_save(blockchain->unspent, "chain.utxo");
+    loaded = chain_log_load("chain.log", "chain.utxo");
+    blockchain_serialize(blockchain, "save.hblk");
+    fails += !loaded || !blockchain_serialize(loaded, "copy.hblk");
+    fails += !_same_files("save.hblk", "copy.hblk");
+    blockchain_destroy(loaded);
+
+    remove("chain.log");
+    remove("chain.utxo");
+    remove("save.hblk");
+    remove("save.hblk" HBLK_INDEX_EXT);
+    remove("copy.hblk");
+    remove("copy.hblk" HBLK_INDEX_EXT);
+    printf("chain_log: %s\n", fails ? "FAIL" : "OK");
+    blockchain_destroy(blockchain);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
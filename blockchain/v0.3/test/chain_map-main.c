@@ -0,0 +1,91 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "blockchain.h"
+#include "provided/test_fixtures.h"
+
+#define NB_BLOCKS 2000
+#define NB_TXS 20
+#define NB_UNSPENT 20000
+
+/**
+ * _check_views - Checks the views of a mapped chain against the chain
+ *
+ * @map:        Mapped chain
+ * @blockchain: Chain that was serialized
+ *
+ * Return: Number of differences
+ */
+static int _check_views(chain_map_t const *map, blockchain_t *blockchain)
+{
+    block_view_t view;
+    tx_view_t tx_view;
+    block_t *block;
+    transaction_t *tx;
+    tx_out_t out, *first;
+    int i, j, fails = 0;
+
+    fails += map->nblocks != (uint32_t)llist_size(blockchain->chain);
+    fails += map->nunspent != (uint32_t)llist_size(blockchain->unspent);
+    for (i = 0; !fails && i < llist_size(blockchain->chain); i++)
+    {
+        block = blockchain_block_at(blockchain, i);
+        fails += chain_map_block_view(map, i, &view);
+        fails += memcmp(&view.info, &block->info, sizeof(view.info)) != 0;
+        fails += view.data_len != block->data.len;
+        fails += memcmp(view.data, block->data.buffer, view.data_len) != 0;
+        fails += memcmp(view.hash, block->hash, SHA256_DIGEST_LENGTH) != 0;
+        fails += view.ntxs != llist_size(block->transactions);
+        for (j = 0; !fails && j < view.ntxs; j++)
+        {
+            tx = llist_get_node_at(block->transactions, j);
+            fails += chain_map_tx_view(map, view.first_tx + j, &tx_view);
+            fails += memcmp(tx_view.id, tx->id, SHA256_DIGEST_LENGTH) != 0;
+            fails += tx_view.nouts != (uint32_t)llist_size(tx->outputs);
+            hblk_out_decode(tx_view.outs, &out);
+            first = llist_get_head(tx->outputs);
+            fails += out.amount != first->amount;
+            fails += memcmp(out.pub, first->pub, EC_PUB_LEN) != 0;
+            fails += memcmp(out.hash, first->hash, SHA256_DIGEST_LENGTH) != 0;
+        }
+    }
+    fails += !chain_map_block_view(map, map->nblocks, &view);
+    return (fails);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    blockchain_t *blockchain, *loaded;
+    chain_map_t *map;
+    int fails = 0;
+
+    srand(12);
+    blockchain = _random_chain(NB_BLOCKS, NB_TXS, NB_UNSPENT);
+    fails += !blockchain_serialize(blockchain, "save.hblk");
+
+    map = chain_map_open("save.hblk");
+    fails += !map || _check_views(map, blockchain);
+    /* A full copy serializes back to the same file */
+    loaded = chain_map_blockchain(map);
+    fails += !loaded || !blockchain_serialize(loaded, "copy.hblk");
+    fails += !_same_files("save.hblk", "copy.hblk");
+    blockchain_destroy(loaded);
+    chain_map_close(map);
+
+    /* A truncated file is refused */
+    fails += truncate("copy.hblk", 100000) || chain_map_open("copy.hblk");
+    remove("copy.hblk");
+    remove("save.hblk");
+
+    printf("chain_map: %s\n", fails ? "FAIL" : "OK");
+    blockchain_destroy(blockchain);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
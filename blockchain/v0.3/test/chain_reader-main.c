@@ -0,0 +1,111 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "blockchain.h"
+#include "provided/test_fixtures.h"
+
+#define NB_BLOCKS 2000
+#define NB_TXS 20
+#define NB_UNSPENT 20000
+
+/**
+ * _same_block - Compares a block read back with the one serialized
+ *
+ * @read:  Block read back
+ * @block: Block that was serialized
+ *
+ * Return: 1 if they match, 0 otherwise
+ */
+static int _same_block(block_t const *read, block_t const *block)
+{
+    transaction_t *a, *b;
+    int i;
+
+    if (memcmp(&read->info, &block->info, sizeof(block->info)) ||
+        read->data.len != block->data.len ||
+        memcmp(read->data.buffer, block->data.buffer, block->data.len) ||
+        memcmp(read->hash, block->hash, SHA256_DIGEST_LENGTH) ||
+        llist_size(read->transactions) != llist_size(block->transactions))
+        return (0);
+    for (i = 0; i < llist_size(block->transactions); i++)
+    {
+        a = llist_get_node_at(read->transactions, i);
+        b = llist_get_node_at(block->transactions, i);
+        if (memcmp(a->id, b->id, SHA256_DIGEST_LENGTH) ||
+            llist_size(a->inputs) != llist_size(b->inputs) ||
+            llist_size(a->outputs) != llist_size(b->outputs))
+            return (0);
+    }
+    return (1);
+}
+
+/**
+ * _add_amount - llist_for_each() action summing unspent output amounts
+ *
+ * @unspent: Unspent output
+ * @iter:    Unused
+ * @sum:     Running sum
+ *
+ * Return: 0
+ */
+static int _add_amount(llist_node_t unspent, unsigned int iter, void *sum)
+{
+    (void)iter;
+    *(uint64_t *)sum += ((uto_t *)unspent)->out.amount;
+    return (0);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    blockchain_t *blockchain;
+    block_t *block;
+    block_t const *read;
+    chain_reader_t *reader;
+    uto_t const *read_unspent;
+    uint64_t supply = 0, read_supply = 0;
+    int i, fails = 0;
+
+    srand(16);
+    blockchain = _random_chain(NB_BLOCKS, NB_TXS, NB_UNSPENT);
+    /* One block bigger than the initial decode buffer */
+    block = blockchain_block_at(blockchain, NB_BLOCKS / 2);
+    llist_add_node(block->transactions, _random_tx(300), ADD_NODE_REAR);
+    llist_for_each(blockchain->unspent, _add_amount, &supply);
+    fails += !blockchain_serialize(blockchain, "save.hblk");
+
+    reader = chain_reader_open("save.hblk");
+    fails += !reader;
+    for (i = 0; reader && (read = chain_reader_next_block(reader)); i++)
+        fails += !_same_block(read, blockchain_block_at(blockchain, i));
+    fails += i != llist_size(blockchain->chain);
+    while (reader && (read_unspent = chain_reader_next_unspent(reader)))
+        read_supply += read_unspent->out.amount;
+    fails += read_supply != supply;
+    /* The buffer only grew to fit the biggest block */
+    printf("Decode buffer %lu bytes\n", reader ? reader->capacity : 0);
+    fails += !reader || reader->error ||
+        reader->capacity > 2 * CHAIN_READER_BUF_SIZE;
+    chain_reader_close(reader);
+
+    /* A truncated file stops the reader with an error */
+    fails += truncate("save.hblk", 100000);
+    reader = chain_reader_open("save.hblk");
+    for (i = 0; reader && chain_reader_next_block(reader); i++)
+        ;
+    fails += !reader || !reader->error || i >= llist_size(blockchain->chain);
+    chain_reader_close(reader);
+    remove("save.hblk");
+    remove("save.hblk" HBLK_INDEX_EXT);
+
+    printf("chain_reader: %s\n", fails ? "FAIL" : "OK");
+    blockchain_destroy(blockchain);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,98 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "blockchain.h"
+
+#define NB_BLOCKS 20000
+
+/**
+ * _check_order - llist_for_each() action checking blocks come by height
+ *
+ * @block: Block
+ * @iter:  Height of the block
+ * @arg:   Chain the block belongs to
+ *
+ * Return: 0 if the block is the one at its height, 1 otherwise
+ */
+static int _check_order(llist_node_t block, unsigned int iter, void *arg)
+{
+    return (blockchain_block_at(arg, iter) != block);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    blockchain_t *blockchain = blockchain_create();
+    block_t *block = llist_get_head(blockchain->chain), *genesis = block;
+    block_t *replaced = NULL;
+    int i, fails = 0;
+
+    /* Blocks appended directly are read from the list until synced */
+    for (i = 1; i < NB_BLOCKS; i++)
+    {
+        block = block_create(block, (int8_t *)"Holberton", 9);
+        block->info.timestamp = genesis->info.timestamp + i * 3;
+        if (i < NB_BLOCKS / 2)
+            fails += blockchain_add_block(blockchain, block);
+        else
+            llist_add_node(blockchain->chain, block, ADD_NODE_REAR);
+    }
+    fails += blockchain->store.count != NB_BLOCKS / 2;
+    fails += blockchain_tip(blockchain) != llist_get_tail(blockchain->chain);
+    fails += blockchain_block_at(blockchain, NB_BLOCKS - 1) != block;
+    fails += blockchain->store.count != NB_BLOCKS / 2;
+    fails += chain_store_sync(blockchain);
+    fails += blockchain->store.count != NB_BLOCKS;
+    fails += blockchain_tip(blockchain) != llist_get_tail(blockchain->chain);
+    fails += blockchain_block_at(blockchain, 0) != genesis;
+    fails += blockchain_block_at(blockchain, NB_BLOCKS / 2) !=
+        llist_get_node_at(blockchain->chain, NB_BLOCKS / 2);
+    fails += blockchain_block_at(blockchain, NB_BLOCKS) != NULL;
+    fails += llist_for_each(blockchain->chain, _check_order, blockchain) != 0;
+    fails += chain_store_for_each(blockchain, _check_order, blockchain) != 0;
+
+    /* Retargets read the block an interval back from the store */
+    fails += blockchain_block_at(blockchain,
+        NB_BLOCKS - 1 - DIFFICULTY_ADJUSTMENT_INTERVAL) != llist_get_node_at(
+        blockchain->chain, NB_BLOCKS - 1 - DIFFICULTY_ADJUSTMENT_INTERVAL);
+
+    /* Taking the genesis block out is seen, reads walk the list meanwhile */
+    llist_pop(blockchain->chain);
+    fails += blockchain_block_at(blockchain, 0) !=
+        llist_get_head(blockchain->chain);
+    fails += blockchain_tip(blockchain) != llist_get_tail(blockchain->chain);
+    fails += blockchain->store.count != NB_BLOCKS;
+    block_destroy(genesis);
+    fails += chain_store_sync(blockchain);
+
+    /* A block replaced in the middle is seen once the edit is counted */
+    for (i = 0; i < NB_BLOCKS - 1; i++)
+    {
+        block = llist_pop(blockchain->chain);
+        if (i == NB_BLOCKS / 2)
+        {
+            block_destroy(block);
+            block = block_create(llist_get_tail(blockchain->chain),
+                (int8_t *)"Replacement", 11);
+            replaced = block;
+        }
+        llist_add_node(blockchain->chain, block, ADD_NODE_REAR);
+    }
+    blockchain->edits++;
+    fails += blockchain_block_at(blockchain, NB_BLOCKS / 2) != replaced;
+    fails += chain_store_fresh(blockchain);
+    fails += chain_store_sync(blockchain);
+    fails += !chain_store_fresh(blockchain);
+    fails += blockchain_block_at(blockchain, NB_BLOCKS / 2) != replaced;
+    fails += chain_store_for_each(blockchain, _check_order, blockchain) != 0;
+
+    printf("chain_store: %s\n", fails ? "FAIL" : "OK");
+    blockchain_destroy(blockchain);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
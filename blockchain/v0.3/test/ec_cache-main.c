@@ -0,0 +1,151 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "blockchain.h"
+
+#define NB_KEYS 64
+#define NB_THREADS 4
+#define NB_LOOKUPS 20000
+
+static uint8_t pubs[NB_KEYS][EC_PUB_LEN];
+
+/**
+ * _get_ok - Looks a key up and checks it decodes to the right point
+ *
+ * @i: Index of the key in pubs
+ *
+ * Return: 1 if the key is right, 0 otherwise
+ */
+static int _get_ok(size_t i)
+{
+    uint8_t pub[EC_PUB_LEN];
+    EC_KEY *key = ec_cache_get(pubs[i]);
+    int ok;
+
+    ok = key && ec_to_pub(key, pub) && !memcmp(pub, pubs[i], EC_PUB_LEN);
+    EC_KEY_free(key);
+    return (ok);
+}
+
+/**
+ * _worker - Looks random keys up
+ *
+ * @arg: Seed, then number of wrong keys
+ *
+ * Return: NULL
+ */
+static void *_worker(void *arg)
+{
+    unsigned int seed = *(unsigned int *)arg, fails = 0;
+    size_t i;
+
+    for (i = 0; i < NB_LOOKUPS / NB_THREADS; i++)
+        fails += !_get_ok(rand_r(&seed) % NB_KEYS);
+    *(unsigned int *)arg = fails;
+    return (NULL);
+}
+
+/**
+ * _check_lru - Checks the least recently used key is the one evicted
+ *
+ * Return: Number of failures
+ */
+static int _check_lru(void)
+{
+    ec_cache_stats_t stats;
+    size_t i;
+    int fails = 0;
+
+    ec_cache_resize(4);
+    for (i = 0; i < 4; i++)
+        fails += !_get_ok(i);
+    fails += !_get_ok(0);
+    /* Key 1 is now the least recently used one */
+    fails += !_get_ok(4);
+    ec_cache_stats(&stats);
+    fails += stats.misses != 5 || stats.hits != 1 || stats.count != 4;
+    fails += !_get_ok(0) + !_get_ok(2) + !_get_ok(3) + !_get_ok(4);
+    ec_cache_stats(&stats);
+    fails += stats.misses != 5 || stats.hits != 5;
+    fails += !_get_ok(1);
+    ec_cache_stats(&stats);
+    fails += stats.misses != 6;
+    return (fails);
+}
+
+/**
+ * _bench - Times decoding a key against getting it from the cache
+ */
+static void _bench(void)
+{
+    struct timespec start, mid, end;
+    EC_KEY *key;
+    size_t i;
+
+    ec_cache_resize(EC_CACHE_SIZE);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < NB_LOOKUPS; i++)
+        EC_KEY_free(ec_from_pub(pubs[i % NB_KEYS]));
+    clock_gettime(CLOCK_MONOTONIC, &mid);
+    for (i = 0; i < NB_LOOKUPS; i++)
+    {
+        key = ec_cache_get(pubs[i % NB_KEYS]);
+        EC_KEY_free(key);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("ec_from_pub %.0f ns, ec_cache_get %.0f ns\n",
+        ((mid.tv_sec - start.tv_sec) * 1e9 + (mid.tv_nsec - start.tv_nsec))
+        / NB_LOOKUPS, ((end.tv_sec - mid.tv_sec) * 1e9 +
+        (end.tv_nsec - mid.tv_nsec)) / NB_LOOKUPS);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    pthread_t threads[NB_THREADS];
+    unsigned int seeds[NB_THREADS];
+    ec_cache_stats_t stats;
+    EC_KEY *key;
+    size_t i;
+    int fails = 0;
+
+    for (i = 0; i < NB_KEYS; i++)
+    {
+        key = ec_create();
+        ec_to_pub(key, pubs[i]);
+        EC_KEY_free(key);
+    }
+    fails += _check_lru();
+
+    /* Threads sharing a cache too small for the keys they use */
+    ec_cache_resize(NB_KEYS / 4);
+    for (i = 0; i < NB_THREADS; i++)
+    {
+        seeds[i] = i + 1;
+        pthread_create(&threads[i], NULL, _worker, &seeds[i]);
+    }
+    for (i = 0; i < NB_THREADS; i++)
+    {
+        pthread_join(threads[i], NULL);
+        fails += seeds[i];
+    }
+    ec_cache_stats(&stats);
+    printf("%lu hits, %lu misses, %lu keys held\n", stats.hits,
+        stats.misses, (unsigned long)stats.count);
+    fails += stats.count != NB_KEYS / 4;
+
+    _bench();
+    ec_cache_stats(&stats);
+    fails += stats.count != NB_KEYS;
+    printf("ec_cache: %s\n", fails ? "FAIL" : "OK");
+    ec_cache_resize(0);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
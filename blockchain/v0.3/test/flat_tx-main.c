@@ -0,0 +1,110 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "blockchain.h"
+#include "provided/test_fixtures.h"
+
+#define NB_TXS 2000
+#define RECORD_MAX (HBLK_TX_SIZE + 8 * (HBLK_IN_SIZE + HBLK_OUT_SIZE))
+
+/**
+ * _sum_out - llist_for_each() action summing output amounts
+ *
+ * @out:  Output
+ * @iter: Unused
+ * @sum:  Running sum
+ *
+ * Return: 0
+ */
+static int _sum_out(llist_node_t out, unsigned int iter, void *sum)
+{
+    (void)iter;
+    *(uint64_t *)sum += ((tx_out_t *)out)->amount;
+    return (0);
+}
+
+/**
+ * _check - Checks the flat layout of a transaction against its list one
+ * and its record in a chain file
+ *
+ * @tx:   Transaction
+ * @view: View of its record
+ *
+ * Return: Number of failures
+ */
+static int _check(transaction_t const *tx, tx_view_t const *view)
+{
+    uint8_t a[SHA256_DIGEST_LENGTH], b[SHA256_DIGEST_LENGTH];
+    uint8_t record[RECORD_MAX];
+    flat_tx_t *flat = transaction_flatten(tx), *decoded, *again;
+    transaction_t *expanded;
+    uint64_t sum = 0;
+    size_t size;
+    int fails = 0;
+
+    if (!flat)
+        return (1);
+    llist_for_each(tx->outputs, _sum_out, &sum);
+    fails += memcmp(transaction_hash(tx, a), flat_tx_hash(flat, b), sizeof(a));
+    fails += flat_tx_amount(flat) != sum;
+
+    /* Encoded, it is the record blockchain_serialize() wrote */
+    size = hblk_flat_tx_encode(flat, record);
+    fails += size != hblk_flat_tx_size(flat) || memcmp(record, view->id, size);
+    decoded = hblk_flat_tx_decode(view);
+    fails += !decoded || hblk_flat_tx_encode(decoded, record) != size ||
+        memcmp(record, view->id, size);
+
+    /* Expanded back, it flattens to the same columns */
+    expanded = flat_tx_expand(flat);
+    again = transaction_flatten(expanded);
+    fails += !again || hblk_flat_tx_encode(again, record) != size ||
+        memcmp(record, view->id, size);
+
+    transaction_destroy(expanded);
+    free(again);
+    free(decoded);
+    free(flat);
+    return (fails);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    blockchain_t *blockchain = blockchain_create();
+    block_t *block = llist_get_head(blockchain->chain);
+    transaction_t **txs = calloc(NB_TXS, sizeof(*txs));
+    chain_map_t *map;
+    tx_view_t view;
+    int i, fails = 0;
+
+    srand(25);
+    block = block_create(block, (int8_t *)"Holberton", 9);
+    for (i = 0; i < NB_TXS; i++)
+    {
+        txs[i] = _random_tx(i % 8);
+        llist_add_node(block->transactions, txs[i], ADD_NODE_REAR);
+    }
+    fails += blockchain_add_block(blockchain, block);
+    fails += !blockchain_serialize(blockchain, "save.hblk");
+    map = chain_map_open("save.hblk");
+    fails += !map;
+    for (i = 0; map && i < NB_TXS; i++)
+        fails += chain_map_tx_view(map, i, &view) ||
+            _check(txs[i], &view);
+    chain_map_close(map);
+
+    free(txs);
+    remove("save.hblk");
+    remove("save.hblk" HBLK_INDEX_EXT);
+
+    printf("flat_tx: %s\n", fails ? "FAIL" : "OK");
+    blockchain_destroy(blockchain);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
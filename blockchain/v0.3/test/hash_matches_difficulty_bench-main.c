@@ -0,0 +1,132 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "blockchain.h"
+
+#define NB_HASHES 4096
+#define NB_ROUNDS 1000
+
+/**
+ * _bytewise_matches - Byte then bit scan, as hash_matches_difficulty()
+ * used to be written
+ *
+ * @hash:       Hash to check
+ * @difficulty: Difficulty to match
+ *
+ * Return: 1 on match, 0 on fail
+ */
+static int _bytewise_matches(uint8_t const *hash, uint32_t difficulty)
+{
+    uint32_t i = 0, count = 0, j;
+
+    for (; i < SHA256_DIGEST_LENGTH && hash[i] == 0; i++)
+        count += 8;
+    for (j = 0; i < SHA256_DIGEST_LENGTH && j < 8; j++, count++)
+        if ((hash[i] << j) & 0x80)
+            break;
+    return (count >= difficulty);
+}
+
+/**
+ * _check - Compares every form of the check on one hash
+ *
+ * @hash: Hash to check
+ *
+ * Return: Number of disagreements
+ */
+static int _check(uint8_t const *hash)
+{
+    difficulty_mask_t mask;
+    uint32_t difficulty;
+    int expected, fails = 0;
+
+    for (difficulty = 0; difficulty <= 260; difficulty++)
+    {
+        expected = _bytewise_matches(hash, difficulty);
+        difficulty_mask_init(&mask, difficulty);
+        fails += hash_matches_difficulty(hash, difficulty) != expected;
+        fails += hash_matches_mask(hash, &mask) != expected;
+    }
+    return (fails);
+}
+
+/**
+ * _elapsed_ns - Gets the nanoseconds elapsed since a point in time
+ *
+ * @start: Point in time
+ *
+ * Return: Elapsed nanoseconds
+ */
+static double _elapsed_ns(struct timespec const *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((now.tv_sec - start->tv_sec) * 1e9 +
+        (now.tv_nsec - start->tv_nsec));
+}
+
+/**
+ * _bench - Times the three forms of the check at one difficulty
+ *
+ * @hashes:     Hashes to check, most of them mining misses
+ * @difficulty: Difficulty to match
+ */
+static void _bench(uint8_t (*hashes)[SHA256_DIGEST_LENGTH],
+    uint32_t difficulty)
+{
+    struct timespec start;
+    difficulty_mask_t mask;
+    double bytewise, words, masked;
+    int i, round;
+    volatile int sink = 0;
+
+    difficulty_mask_init(&mask, difficulty);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (round = 0; round < NB_ROUNDS; round++)
+        for (i = 0; i < NB_HASHES; i++)
+            sink += _bytewise_matches(hashes[i], difficulty);
+    bytewise = _elapsed_ns(&start) / (NB_ROUNDS * NB_HASHES);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (round = 0; round < NB_ROUNDS; round++)
+        for (i = 0; i < NB_HASHES; i++)
+            sink += hash_matches_difficulty(hashes[i], difficulty);
+    words = _elapsed_ns(&start) / (NB_ROUNDS * NB_HASHES);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (round = 0; round < NB_ROUNDS; round++)
+        for (i = 0; i < NB_HASHES; i++)
+            sink += hash_matches_mask(hashes[i], &mask);
+    masked = _elapsed_ns(&start) / (NB_ROUNDS * NB_HASHES);
+    printf("Difficulty %3u: bytewise %.2f ns, words %.2f ns, mask %.2f ns\n",
+        difficulty, bytewise, words, masked);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    static uint8_t hashes[NB_HASHES][SHA256_DIGEST_LENGTH];
+    int i, j, fails = 0;
+
+    srand(98);
+    for (i = 0; i < NB_HASHES; i++)
+    {
+        for (j = 0; j < SHA256_DIGEST_LENGTH; j++)
+            hashes[i][j] = rand() & 0xff;
+        /* Leading zeros of every length, up to the all zero hash */
+        memset(hashes[i], 0, (i % 34) * SHA256_DIGEST_LENGTH / 33);
+        fails += _check(hashes[i]);
+    }
+    printf("Checked %d hashes: %d disagreements\n", NB_HASHES, fails);
+    for (i = 0; i < NB_HASHES; i++)
+        SHA256(hashes[i], SHA256_DIGEST_LENGTH, hashes[i]);
+    _bench(hashes, 20);
+    _bench(hashes, 100);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
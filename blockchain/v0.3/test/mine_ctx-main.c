@@ -0,0 +1,106 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "blockchain.h"
+
+/**
+ * _check_batch - Compares mine_ctx_batch() against block_hash()
+ *
+ * @block: Block to check, its nonce is modified
+ * @ctx: Mining context of @block
+ * @nonce: First nonce of the batch
+ *
+ * Return: Number of mismatching nonces
+ */
+static int _check_batch(block_t *block, mine_ctx_t const *ctx, uint64_t nonce)
+{
+    uint8_t digests[SHA256_MB_MAX_LANES][SHA256_DIGEST_LENGTH];
+    uint8_t expected[SHA256_DIGEST_LENGTH];
+    size_t n, i;
+    int fails = 0;
+
+    n = mine_ctx_batch(ctx, nonce, digests);
+    for (i = 0; i < n; i++)
+    {
+        block->info.nonce = nonce + i;
+        block_hash(block, expected);
+        fails += !!memcmp(expected, digests[i], SHA256_DIGEST_LENGTH);
+    }
+    return (fails);
+}
+
+/**
+ * _check_block - Compares mine_ctx_hash() and mine_ctx_batch() with every
+ * supported kernel against block_hash()
+ *
+ * @block: Block to check, its nonce is modified
+ *
+ * Return: Number of mismatching nonces
+ */
+static int _check_block(block_t *block)
+{
+    uint8_t expected[SHA256_DIGEST_LENGTH], got[SHA256_DIGEST_LENGTH];
+    uint64_t nonces[] = {0, 1, 255, 256, 65537, 0xdeadbeefcafe, UINT64_MAX};
+    sha256_mb_kernel_t const *kernel;
+    mine_ctx_t ctx;
+    size_t i;
+    int fails = 0;
+
+    if (mine_ctx_init(&ctx, block))
+        return (1);
+    for (i = 0; i < sizeof(nonces) / sizeof(*nonces); i++)
+    {
+        block->info.nonce = nonces[i];
+        block_hash(block, expected);
+        mine_ctx_hash(&ctx, nonces[i], got);
+        fails += !!memcmp(expected, got, SHA256_DIGEST_LENGTH);
+        for (kernel = sha256_mb_kernels; kernel->name; kernel++)
+        {
+            if (!kernel->supported())
+                continue;
+            ctx.kernel = kernel, ctx.lanes = kernel->lanes;
+            fails += _check_batch(block, &ctx, nonces[i]);
+        }
+        /* One nonce at a time, for CPUs with only the scalar kernel */
+        ctx.kernel = NULL, ctx.lanes = 1;
+        fails += _check_batch(block, &ctx, nonces[i]);
+    }
+    mine_ctx_free(&ctx);
+    return (fails);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    int8_t data[BLOCKCHAIN_DATA_MAX];
+    blockchain_t *blockchain;
+    block_t *block;
+    EC_KEY *miner;
+    uint32_t len;
+    int fails = 0, checked = 0;
+
+    memset(data, 'H', sizeof(data));
+    miner = ec_create();
+    blockchain = blockchain_create();
+    block = llist_get_head(blockchain->chain);
+    for (len = 0; len <= BLOCKCHAIN_DATA_MAX; len += 7, checked++)
+    {
+        block = block_create(block, data, len);
+        if (len % 3 == 0)
+            llist_add_node(block->transactions,
+                coinbase_create(miner, block->info.index), ADD_NODE_REAR);
+        fails += _check_block(block);
+        llist_add_node(blockchain->chain, block, ADD_NODE_REAR);
+    }
+    printf("Checked %d blocks: %d mismatches\n", checked, fails);
+
+    blockchain_destroy(blockchain);
+    EC_KEY_free(miner);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
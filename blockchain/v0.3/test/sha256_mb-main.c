@@ -0,0 +1,75 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "blockchain.h"
+
+#define NB_MSGS 75
+#define MSG_MAX 300
+
+/**
+ * _check_kernel - Compares a multi-buffer kernel against sha256()
+ *
+ * @kernel: Kernel to check
+ * @msgs:   Messages to hash
+ * @lens:   Length of each message
+ *
+ * Return: Number of mismatching digests
+ */
+static int _check_kernel(sha256_mb_kernel_t const *kernel,
+    uint8_t const *const msgs[], size_t const lens[])
+{
+    uint8_t digests[NB_MSGS][SHA256_DIGEST_LENGTH];
+    uint8_t expected[SHA256_DIGEST_LENGTH];
+    size_t i, n;
+    int fails = 0;
+
+    /* Every batch size exercises a different count of idle lanes */
+    for (n = 1; n <= NB_MSGS; n += 7)
+    {
+        sha256_mb_with(kernel, msgs, lens, n, digests);
+        for (i = 0; i < n; i++)
+        {
+            sha256((int8_t const *)msgs[i], lens[i], expected);
+            fails += !!memcmp(expected, digests[i], SHA256_DIGEST_LENGTH);
+        }
+    }
+    printf("%-7s [%2lu lanes]: %s\n", kernel->name, kernel->lanes,
+        fails ? "MISMATCH" : "OK");
+    return (fails);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    static uint8_t buffers[NB_MSGS][MSG_MAX];
+    uint8_t const *msgs[NB_MSGS];
+    size_t lens[NB_MSGS], i, j;
+    sha256_mb_kernel_t const *kernel;
+    int fails = 0;
+
+    srand(98);
+    for (i = 0; i < NB_MSGS; i++)
+    {
+        for (j = 0; j < MSG_MAX; j++)
+            buffers[i][j] = (uint8_t)rand();
+        /* Lengths around every padding boundary, and a few long ones */
+        lens[i] = i < 70 ? i + 50 : (size_t)rand() % MSG_MAX;
+        msgs[i] = buffers[i];
+    }
+    for (kernel = sha256_mb_kernels; kernel->name; kernel++)
+    {
+        if (kernel->supported())
+            fails += _check_kernel(kernel, msgs, lens);
+        else
+            printf("%-7s [%2lu lanes]: not supported\n", kernel->name,
+                kernel->lanes);
+    }
+    printf("Default kernel: %s\n", sha256_mb_kernel()->name);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,89 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "blockchain.h"
+
+#define NB_NONCES 100000
+
+/**
+ * _elapsed_ns - Gets the nanoseconds elapsed since a point in time
+ *
+ * @start: Point in time
+ *
+ * Return: Elapsed nanoseconds
+ */
+static double _elapsed_ns(struct timespec const *start)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((now.tv_sec - start->tv_sec) * 1e9 +
+        (now.tv_nsec - start->tv_nsec));
+}
+
+/**
+ * _bench_nonces - Times the hashing of a block under many nonces
+ *
+ * @block: Block to hash, its nonce is modified
+ */
+static void _bench_nonces(block_t *block)
+{
+    uint8_t digests[SHA256_MB_MAX_LANES][SHA256_DIGEST_LENGTH];
+    sha256_mb_kernel_t const *kernel;
+    struct timespec start;
+    mine_ctx_t ctx;
+    uint64_t nonce;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (nonce = 0; nonce < NB_NONCES; nonce++)
+    {
+        block->info.nonce = nonce;
+        block_hash(block, digests[0]);
+    }
+    printf("  %-10s %7.1f ns/nonce\n", "block_hash",
+        _elapsed_ns(&start) / NB_NONCES);
+    if (mine_ctx_init(&ctx, block))
+        return;
+    for (kernel = sha256_mb_kernels; kernel->name; kernel++)
+    {
+        if (!kernel->supported())
+            continue;
+        ctx.kernel = kernel, ctx.lanes = kernel->lanes;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (nonce = 0; nonce < NB_NONCES; nonce += ctx.lanes)
+            mine_ctx_batch(&ctx, nonce, digests);
+        printf("  %-10s %7.1f ns/nonce\n", kernel->name,
+            _elapsed_ns(&start) / NB_NONCES);
+    }
+    mine_ctx_free(&ctx);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    int8_t data[BLOCKCHAIN_DATA_MAX];
+    blockchain_t *blockchain;
+    block_t *block;
+    uint32_t lens[] = {16, BLOCKCHAIN_DATA_MAX};
+    int i;
+
+    memset(data, 'H', sizeof(data));
+    blockchain = blockchain_create();
+    block = llist_get_head(blockchain->chain);
+    for (i = 0; i < 2; i++)
+    {
+        block = block_create(block, data, lens[i]);
+        printf("Block with %u bytes of data:\n", lens[i]);
+        _bench_nonces(block);
+        llist_add_node(blockchain->chain, block, ADD_NODE_REAR);
+    }
+    blockchain_destroy(blockchain);
+
+    return (EXIT_SUCCESS);
+}
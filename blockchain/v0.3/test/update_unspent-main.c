@@ -0,0 +1,201 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "blockchain.h"
+
+/**
+ * _add_block - Creates a block paying a miner and holding one transaction,
+ * and applies it to the unspent outputs
+ *
+ * @blockchain: Blockchain to add the block to
+ * @miner:      Key receiving the coinbase
+ * @tx:         Transaction to put in the block, may be NULL
+ * @set:        Set of unspent outputs updated alongside the list
+ *
+ * Return: 0 on success, 1 on failure
+ */
+static int _add_block(blockchain_t *blockchain, EC_KEY *miner,
+    transaction_t *tx, utxo_set_t *set)
+{
+    block_t *block, *prev = llist_get_tail(blockchain->chain);
+
+    block = block_create(prev, (int8_t *)"Holberton", 9);
+    llist_add_node(block->transactions,
+        coinbase_create(miner, block->info.index), ADD_NODE_FRONT);
+    if (tx)
+        llist_add_node(block->transactions, tx, ADD_NODE_REAR);
+    block->info.difficulty = 8;
+    block_mine(block);
+    if (block_is_valid(block, prev, blockchain->unspent))
+        return (1);
+    llist_add_node(blockchain->chain, block, ADD_NODE_REAR);
+    if (utxo_set_update(set, block->transactions, block->hash, NULL, 1))
+        return (1);
+    return (update_unspent(block->transactions, block->hash,
+        blockchain->unspent) != blockchain->unspent);
+}
+
+/**
+ * _same_outputs - Checks a list and a set hold the same outputs
+ *
+ * @list: List of unspent outputs
+ * @set:  Set of unspent outputs
+ *
+ * Return: 1 if they do, 0 otherwise
+ */
+static int _same_outputs(llist_t *list, utxo_set_t const *set)
+{
+    uto_t *unspent;
+    int i;
+
+    if ((size_t)llist_size(list) != set->count)
+        return (0);
+    for (i = 0; i < llist_size(list); i++)
+    {
+        unspent = llist_get_node_at(list, i);
+        if (!utxo_set_find(set, unspent->block_hash, unspent->tx_id,
+            unspent->out.hash))
+            return (0);
+    }
+    return (1);
+}
+
+/**
+ * _check_rejected - Checks a block that doesn't apply is reported by NULL
+ * and leaves the list as it was: its transaction spends an output and
+ * creates the same one twice
+ *
+ * @unspent: List of unspent outputs
+ * @receiver: Key the outputs pay to
+ *
+ * Return: Number of failures
+ */
+static int _check_rejected(llist_t *unspent, EC_KEY *receiver)
+{
+    uint8_t pub[EC_PUB_LEN], hash[SHA256_DIGEST_LENGTH] = {0};
+    llist_t *txs = llist_create(MT_SUPPORT_FALSE);
+    uto_t *spent = llist_get_head(unspent);
+    transaction_t tx = {{0}, NULL, NULL};
+    int size = llist_size(unspent), fails = 0;
+
+    tx.inputs = llist_create(MT_SUPPORT_FALSE);
+    tx.outputs = llist_create(MT_SUPPORT_FALSE);
+    llist_add_node(tx.inputs, tx_in_create(spent), ADD_NODE_REAR);
+    ec_to_pub(receiver, pub);
+    llist_add_node(tx.outputs, tx_out_create(10, pub), ADD_NODE_REAR);
+    llist_add_node(tx.outputs, tx_out_create(10, pub), ADD_NODE_REAR);
+    llist_add_node(txs, &tx, ADD_NODE_REAR);
+
+    fails += update_unspent(txs, hash, unspent) != NULL;
+    fails += llist_size(unspent) != size || llist_get_head(unspent) != spent;
+
+    llist_destroy(tx.inputs, 1, NULL);
+    llist_destroy(tx.outputs, 1, NULL);
+    llist_destroy(txs, 0, NULL);
+    return (fails);
+}
+
+/**
+ * _pay_twice - Replaces the outputs of a transaction by two outputs paying
+ * a key, then hashes and signs it again
+ *
+ * @tx:      Transaction to modify
+ * @sender:  Key owning the outputs spent by @tx
+ * @pub:     Public key the outputs pay to
+ * @amounts: Amount of each output
+ * @unspent: List of unspent outputs
+ */
+static void _pay_twice(transaction_t *tx, EC_KEY *sender,
+    uint8_t const pub[EC_PUB_LEN], uint32_t const amounts[2],
+    llist_t *unspent)
+{
+    int i;
+
+    llist_destroy(tx->outputs, 1, NULL);
+    tx->outputs = llist_create(MT_SUPPORT_FALSE);
+    for (i = 0; i < 2; i++)
+        llist_add_node(tx->outputs, tx_out_create(amounts[i], pub),
+            ADD_NODE_REAR);
+    transaction_hash(tx, tx->id);
+    for (i = 0; i < llist_size(tx->inputs); i++)
+        tx_in_sign(llist_get_node_at(tx->inputs, i), tx->id, sender, unspent);
+}
+
+/**
+ * _check_duplicate_outputs - Checks a signed and balanced transaction
+ * creating the same output twice is refused by validation, while the same
+ * one paying two different amounts is accepted
+ *
+ * @unspent:  List of unspent outputs
+ * @set:      Set of the same unspent outputs
+ * @miner:    Key owning some of them
+ * @receiver: Key to pay
+ *
+ * Return: Number of failures
+ */
+static int _check_duplicate_outputs(llist_t *unspent, utxo_set_t *set,
+    EC_KEY *miner, EC_KEY *receiver)
+{
+    transaction_t *tx = transaction_create(miner, receiver, 50, unspent);
+    uint8_t pub[EC_PUB_LEN];
+    uint32_t total = 0, amounts[2];
+    int i, fails = 0;
+
+    if (!tx)
+        return (1);
+    for (i = 0; i < llist_size(tx->outputs); i++)
+        total += ((tx_out_t *)llist_get_node_at(tx->outputs, i))->amount;
+    ec_to_pub(receiver, pub);
+
+    amounts[0] = amounts[1] = total / 2;
+    _pay_twice(tx, miner, pub, amounts, unspent);
+    fails += transaction_is_valid_set(tx, set) != 0;
+    fails += transaction_is_valid(tx, unspent) != 0;
+
+    amounts[0] = total / 2 + 1, amounts[1] = total - amounts[0];
+    _pay_twice(tx, miner, pub, amounts, unspent);
+    fails += transaction_is_valid_set(tx, set) != 1;
+    fails += transaction_is_valid(tx, unspent) != 1;
+
+    transaction_destroy(tx);
+    return (fails);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    blockchain_t *blockchain = blockchain_create();
+    EC_KEY *miner = ec_create(), *receiver = ec_create();
+    utxo_set_t *set = utxo_set_create(0);
+    transaction_t *tx;
+    int fails = 0;
+
+    fails += _add_block(blockchain, miner, NULL, set);
+    fails += _add_block(blockchain, miner, NULL, set);
+    printf("After 2 coinbases: %d unspent\n", llist_size(blockchain->unspent));
+    fails += llist_size(blockchain->unspent) != 2;
+
+    /* Spends both coinbases: one output to the receiver, one change */
+    tx = transaction_create(miner, receiver, 70, blockchain->unspent);
+    fails += !tx || _add_block(blockchain, miner, tx, set);
+    printf("After spending 100: %d unspent\n", llist_size(blockchain->unspent));
+    fails += llist_size(blockchain->unspent) != 3;
+    fails += !_same_outputs(blockchain->unspent, set);
+    fails += _check_rejected(blockchain->unspent, receiver);
+    fails += _check_duplicate_outputs(blockchain->unspent, set, miner,
+        receiver);
+    fails += !_same_outputs(blockchain->unspent, set);
+
+    printf("update_unspent: %s\n", fails ? "FAIL" : "OK");
+    utxo_set_destroy(set, 1);
+    blockchain_destroy(blockchain);
+    EC_KEY_free(miner);
+    EC_KEY_free(receiver);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,174 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+
+#include "blockchain.h"
+
+#define NB_KEYS 8
+#define NB_ROUNDS 200
+
+/**
+ * _apply - Applies a transaction to a set and to an unspent list
+ *
+ * @set:        Set to update
+ * @unspent:    Unspent list to update, kept as the reference
+ * @tx:         Transaction to apply, destroyed
+ * @block_hash: Hash of the block holding @tx
+ *
+ * Return: 0 on success, 1 on failure
+ */
+static int _apply(utxo_set_t *set, llist_t **unspent, transaction_t *tx,
+    uint8_t block_hash[SHA256_DIGEST_LENGTH])
+{
+    llist_t *txs = llist_create(MT_SUPPORT_FALSE);
+    int ret;
+
+    llist_add_node(txs, tx, ADD_NODE_REAR);
+    ret = utxo_set_update(set, txs, block_hash, NULL, 1);
+    ret |= !update_unspent(txs, block_hash, *unspent);
+    llist_destroy(txs, 1, (node_dtor_t)transaction_destroy);
+    return (ret);
+}
+
+/**
+ * _coinbase - Adds a coinbase output paying a key to a set and a list
+ *
+ * @set:     Set to add to
+ * @unspent: Unspent list to add to
+ * @key:     Key to pay
+ * @index:   Block index of the coinbase, makes each one unique
+ *
+ * Return: 0 on success, 1 on failure
+ */
+static int _coinbase(utxo_set_t *set, llist_t **unspent, EC_KEY const *key,
+    uint32_t index)
+{
+    uint8_t block_hash[SHA256_DIGEST_LENGTH] = {0};
+
+    memcpy(block_hash, &index, sizeof(index));
+    return (_apply(set, unspent, coinbase_create(key, index), block_hash));
+}
+
+/**
+ * _same_inputs - Checks two transactions spend the same outputs, in the
+ * same order
+ *
+ * @a: First transaction
+ * @b: Second transaction
+ *
+ * Return: 1 if they do, 0 otherwise
+ */
+static int _same_inputs(transaction_t const *a, transaction_t const *b)
+{
+    tx_in_t const *in_a, *in_b;
+    int i;
+
+    if (!a || !b)
+        return (!a && !b);
+    if (llist_size(a->inputs) != llist_size(b->inputs))
+        return (0);
+    for (i = 0; i < llist_size(a->inputs); i++)
+    {
+        in_a = llist_get_node_at(a->inputs, i);
+        in_b = llist_get_node_at(b->inputs, i);
+        /* Signatures are randomized, compare the references only */
+        if (memcmp(in_a, in_b, offsetof(tx_in_t, sig)))
+            return (0);
+    }
+    return (1);
+}
+
+/**
+ * _scan_balance - Sums the outputs paying a key by scanning the whole set
+ *
+ * @set: Set to scan
+ * @pub: Public key
+ *
+ * Return: The balance
+ */
+static uint64_t _scan_balance(utxo_set_t const *set, uint8_t const *pub)
+{
+    uint64_t balance = 0;
+    size_t i;
+
+    for (i = 0; i < set->capacity; i++)
+        if (set->slots[i].utxo &&
+            !memcmp(set->slots[i].utxo->out.pub, pub, EC_PUB_LEN))
+            balance += set->slots[i].utxo->out.amount;
+    return (balance);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    EC_KEY *keys[NB_KEYS];
+    uint8_t pubs[NB_KEYS][EC_PUB_LEN];
+    utxo_set_t *set = utxo_set_create(0);
+    llist_t *unspent = llist_create(MT_SUPPORT_FALSE);
+    uint8_t block_hash[SHA256_DIGEST_LENGTH] = {0xbb};
+    transaction_t *tx, *ref;
+    uint64_t balance;
+    uint32_t index = 1;
+    int i, round, fails = 0;
+
+    for (i = 0; i < NB_KEYS; i++)
+    {
+        keys[i] = ec_create();
+        ec_to_pub(keys[i], pubs[i]);
+        fails += _coinbase(set, &unspent, keys[i], index++);
+    }
+    fails += utxo_set_index_addresses(set);
+    for (round = 0; round < NB_ROUNDS; round++)
+    {
+        /* Pay the next key, then mint for a random one */
+        i = round % NB_KEYS;
+        tx = transaction_create_set(keys[i], keys[(i + 1) % NB_KEYS],
+            1 + round % 60, set);
+        if (tx)
+        {
+            fails += !transaction_is_valid_set(tx, set);
+            block_hash[1] = round & 0xff, block_hash[2] = round >> 8;
+            fails += _apply(set, &unspent, tx, block_hash);
+        }
+        fails += _coinbase(set, &unspent, keys[rand() % NB_KEYS], index++);
+    }
+    for (i = 0; i < NB_KEYS; i++)
+    {
+        printf("Key %d: balance %lu\n", i,
+            (unsigned long)utxo_set_balance(set, pubs[i]));
+        fails += utxo_set_balance(set, pubs[i]) != _scan_balance(set, pubs[i]);
+    }
+    fails += set->count != 0 && !set->addr_count;
+
+    /* Same coins as transaction_create(), live and from a fresh index */
+    for (round = 0; round < 2; round++)
+    {
+        for (i = 0; i < NB_KEYS; i++)
+        {
+            balance = utxo_set_balance(set, pubs[i]);
+            if (balance < 2)
+                continue;
+            tx = transaction_create_set(keys[i], keys[(i + 1) % NB_KEYS],
+                balance - 1, set);
+            ref = transaction_create(keys[i], keys[(i + 1) % NB_KEYS],
+                balance - 1, unspent);
+            fails += !_same_inputs(tx, ref);
+            transaction_destroy(tx);
+            transaction_destroy(ref);
+        }
+        utxo_addr_destroy(set);
+        fails += utxo_set_index_addresses(set);
+    }
+    printf("utxo_addr: %s\n", fails ? "FAIL" : "OK");
+
+    utxo_set_destroy(set, 1);
+    llist_destroy(unspent, 1, free);
+    for (i = 0; i < NB_KEYS; i++)
+        EC_KEY_free(keys[i]);
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
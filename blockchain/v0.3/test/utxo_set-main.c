@@ -0,0 +1,143 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "blockchain.h"
+
+#define NB_UTXOS 100000
+
+/**
+ * _random_utxo - Creates an unspent output with random hashes
+ *
+ * Return: Pointer to the new output
+ */
+static uto_t *_random_utxo(void)
+{
+    uint8_t block_hash[SHA256_DIGEST_LENGTH], tx_id[SHA256_DIGEST_LENGTH];
+    uint8_t pub[EC_PUB_LEN] = {0};
+    tx_out_t *out;
+    uto_t *utxo;
+    size_t i;
+
+    for (i = 0; i < SHA256_DIGEST_LENGTH; i++)
+        block_hash[i] = rand() & 0xff, tx_id[i] = rand() & 0xff;
+    /* Same amount and key: every output shares its hash, tx_id tells apart */
+    out = tx_out_create(50, pub);
+    utxo = unspent_tx_out_create(block_hash, tx_id, out);
+    free(out);
+    return (utxo);
+}
+
+/**
+ * _check_set - Checks a set against the outputs it should and shouldn't hold
+ *
+ * @set:   Set to check
+ * @utxos: Every output
+ * @from:  First output that should be in the set
+ *
+ * Return: Number of wrong lookups
+ */
+static int _check_set(utxo_set_t const *set, uto_t **utxos, size_t from)
+{
+    size_t i;
+    int fails = 0;
+    uto_t *found;
+
+    for (i = 0; i < NB_UTXOS; i++)
+    {
+        found = utxo_set_find(set, utxos[i]->block_hash, utxos[i]->tx_id,
+            utxos[i]->out.hash);
+        fails += found != (i >= from ? utxos[i] : NULL);
+    }
+    fails += set->count != NB_UTXOS - from;
+    return (fails);
+}
+
+/**
+ * _bench_lookups - Times lookups through the set and through the list
+ *
+ * @list:  List of the outputs
+ * @set:   Set of the same outputs
+ * @utxos: Outputs to look up
+ */
+static void _bench_lookups(llist_t *list, utxo_set_t const *set, uto_t **utxos)
+{
+    struct timespec start, end;
+    tx_in_t in;
+    uto_t *utxo;
+    double list_ns, set_ns;
+    size_t i;
+    int hits = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < 100; i++)
+    {
+        utxo = utxos[(i * 7919) % NB_UTXOS];
+        memcpy(in.block_hash, utxo->block_hash, SHA256_DIGEST_LENGTH);
+        memcpy(in.tx_id, utxo->tx_id, SHA256_DIGEST_LENGTH);
+        memcpy(in.tx_out_hash, utxo->out.hash, SHA256_DIGEST_LENGTH);
+        hits += !!llist_find_node(list, (node_ident_t)&match_unspent_output,
+            &in);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    list_ns = ((end.tv_sec - start.tv_sec) * 1e9 +
+        (end.tv_nsec - start.tv_nsec)) / 100;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < NB_UTXOS; i++)
+        hits += !!utxo_set_find(set, utxos[i]->block_hash, utxos[i]->tx_id,
+            utxos[i]->out.hash);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    set_ns = ((end.tv_sec - start.tv_sec) * 1e9 +
+        (end.tv_nsec - start.tv_nsec)) / NB_UTXOS;
+    printf("Lookup among %d outputs: llist %.0f ns, set %.1f ns (%d hits)\n",
+        NB_UTXOS, list_ns, set_ns, hits);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    static uto_t *utxos[NB_UTXOS];
+    utxo_set_t *set, *copy;
+    llist_t *list;
+    size_t i;
+    int fails = 0;
+
+    srand(98);
+    set = utxo_set_create(0);
+    list = llist_create(MT_SUPPORT_FALSE);
+    for (i = 0; i < NB_UTXOS; i++)
+    {
+        utxos[i] = _random_utxo();
+        fails += utxo_set_add(set, utxos[i]);
+        llist_add_node(list, utxos[i], ADD_NODE_REAR);
+    }
+    /* The same key twice is refused */
+    fails += !utxo_set_add(set, utxos[0]);
+    fails += _check_set(set, utxos, 0);
+
+    copy = utxo_set_from_list(list);
+    fails += !copy || _check_set(copy, utxos, 0);
+    _bench_lookups(list, copy, utxos);
+    utxo_set_destroy(copy, 0);
+
+    for (i = 0; i < NB_UTXOS / 2; i++)
+        fails += utxo_set_remove(set, utxos[i]->block_hash, utxos[i]->tx_id,
+            utxos[i]->out.hash) != utxos[i];
+    fails += _check_set(set, utxos, NB_UTXOS / 2);
+    llist_destroy(list, 0, NULL);
+    list = utxo_set_to_list(set);
+    fails += llist_size(list) != NB_UTXOS / 2;
+    printf("utxo_set: %s\n", fails ? "FAIL" : "OK");
+
+    llist_destroy(list, 0, NULL);
+    utxo_set_destroy(set, 1);
+    for (i = 0; i < NB_UTXOS / 2; i++)
+        free(utxos[i]);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,140 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "blockchain.h"
+
+#define NB_BLOCKS 10
+#define SNAPSHOT "utxo.snap"
+
+/**
+ * _add_block - Creates a block paying a miner, and spending to a receiver
+ * once the miner has coins
+ *
+ * @blockchain: Blockchain to add the block to
+ * @miner:      Key receiving the coinbase
+ * @receiver:   Key paid by the miner
+ * @set:        Set of unspent outputs updated alongside the chain
+ *
+ * Return: 0 on success, 1 on failure
+ */
+static int _add_block(blockchain_t *blockchain, EC_KEY *miner,
+    EC_KEY *receiver, utxo_set_t *set)
+{
+    block_t *block, *prev = llist_get_tail(blockchain->chain);
+    transaction_t *tx;
+
+    block = block_create(prev, (int8_t *)"Holberton", 9);
+    llist_add_node(block->transactions,
+        coinbase_create(miner, block->info.index), ADD_NODE_FRONT);
+    tx = transaction_create(miner, receiver, 30, blockchain->unspent);
+    if (tx)
+        llist_add_node(block->transactions, tx, ADD_NODE_REAR);
+    block_hash(block, block->hash);
+    if (blockchain_add_block(blockchain, block) ||
+        utxo_set_update(set, block->transactions, block->hash, NULL, 1))
+        return (1);
+    return (update_unspent(block->transactions, block->hash,
+        blockchain->unspent) != blockchain->unspent);
+}
+
+/**
+ * _same_set - Checks two sets hold the same outputs
+ *
+ * @a: First set
+ * @b: Second set
+ *
+ * Return: 1 if they do, 0 otherwise
+ */
+static int _same_set(utxo_set_t const *a, utxo_set_t const *b)
+{
+    uto_t const *utxo, *found;
+    size_t i;
+
+    if (!a || !b || a->count != b->count)
+        return (0);
+    for (i = 0; i < a->capacity; i++)
+    {
+        utxo = a->slots[i].utxo;
+        if (!utxo)
+            continue;
+        found = utxo_set_find(b, utxo->block_hash, utxo->tx_id,
+            utxo->out.hash);
+        if (!found || found->out.amount != utxo->out.amount ||
+            memcmp(found->out.pub, utxo->out.pub, EC_PUB_LEN))
+            return (0);
+    }
+    return (1);
+}
+
+/**
+ * _sync - Loads the snapshot against the chain and checks the result
+ *
+ * @blockchain: Chain
+ * @expected:   Set the result must match, NULL to skip the check
+ * @replays:    Number of blocks that must be replayed
+ *
+ * Return: Number of failures
+ */
+static int _sync(blockchain_t *blockchain, utxo_set_t const *expected,
+    uint32_t replays)
+{
+    uint32_t replayed = UINT32_MAX;
+    utxo_set_t *set;
+    int fails;
+
+    set = utxo_snapshot_sync(SNAPSHOT, blockchain, &replayed);
+    printf("Replayed %u blocks\n", replayed);
+    fails = !set || (expected && !_same_set(set, expected)) ||
+        replayed != replays;
+    utxo_set_destroy(set, 1);
+    return (fails);
+}
+
+/**
+ * main - Entry point
+ *
+ * Return: EXIT_SUCCESS or EXIT_FAILURE
+ */
+int main(void)
+{
+    blockchain_t *blockchain = blockchain_create();
+    EC_KEY *miner = ec_create(), *receiver = ec_create();
+    utxo_set_t *set = utxo_set_create(0);
+    block_t *block;
+    int i, fails = 0;
+
+    for (i = 1; i < NB_BLOCKS; i++)
+    {
+        fails += _add_block(blockchain, miner, receiver, set);
+        if (i == NB_BLOCKS / 2)
+            fails += utxo_snapshot_save(set,
+                llist_get_tail(blockchain->chain), i, SNAPSHOT);
+    }
+
+    /* Only the blocks after the snapshot are replayed */
+    fails += _sync(blockchain, set, NB_BLOCKS - 1 - NB_BLOCKS / 2);
+
+    /* A snapshot of the tip needs no replay */
+    fails += utxo_snapshot_save(set, llist_get_tail(blockchain->chain),
+        NB_BLOCKS - 1, SNAPSHOT);
+    fails += _sync(blockchain, set, 0);
+
+    /* A tip that isn't in the chain any more means a full replay */
+    block = llist_get_tail(blockchain->chain);
+    block->hash[0] ^= 1;
+    fails += _sync(blockchain, NULL, NB_BLOCKS - 1);
+    block->hash[0] ^= 1;
+
+    /* So does a missing snapshot */
+    remove(SNAPSHOT);
+    fails += _sync(blockchain, set, NB_BLOCKS - 1);
+
+    printf("utxo_snapshot: %s\n", fails ? "FAIL" : "OK");
+    utxo_set_destroy(set, 1);
+    blockchain_destroy(blockchain);
+    EC_KEY_free(miner);
+    EC_KEY_free(receiver);
+
+    return (fails ? EXIT_FAILURE : EXIT_SUCCESS);
+}
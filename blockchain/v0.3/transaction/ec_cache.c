@@ -0,0 +1,156 @@
+#include "transaction.h"
+
+int ec_cache_resize_locked(void);
+
+static ec_cache_t cache = {
+	PTHREAD_MUTEX_INITIALIZER, NULL, NULL, 0, EC_CACHE_SIZE, 0,
+	EC_CACHE_NONE, EC_CACHE_NONE, 0, 0
+};
+
+/**
+* ec_cache_get - Decodes a public key, through the shared ec_cache
+* @pub: Public key
+* Return: A reference to the key, to release with EC_KEY_free(), or NULL
+*
+* Description: Decoding is done outside the lock, so threads missing on
+* different keys don't wait on each other. The reference returned stays
+* valid even if the entry gets evicted meanwhile.
+*/
+EC_KEY *ec_cache_get(uint8_t const pub[EC_PUB_LEN])
+{
+	uint64_t hash;
+	size_t slot;
+	EC_KEY *key = NULL;
+
+	if (!pub)
+		return (NULL);
+
+	hash = utxo_addr_hash(pub);
+	pthread_mutex_lock(&cache.lock);
+	if (cache.capacity && !cache.entries)
+		ec_cache_resize_locked();
+	if (cache.capacity)
+	{
+		slot = ec_cache_find(&cache, pub, hash);
+		if (cache.table[slot])
+		{
+			/* Hit: hand out a new reference to the cached key */
+			key = cache.entries[cache.table[slot] - 1].key;
+			EC_KEY_up_ref(key);
+			ec_cache_touch(&cache, cache.table[slot] - 1);
+			cache.hits++;
+			pthread_mutex_unlock(&cache.lock);
+			return (key);
+		}
+	}
+	cache.misses++;
+	pthread_mutex_unlock(&cache.lock);
+
+	key = ec_from_pub(pub);
+	if (!key)
+		return (NULL);
+
+	/* Another thread may have added the same key while we decoded it */
+	pthread_mutex_lock(&cache.lock);
+	if (cache.capacity && !cache.table[ec_cache_find(&cache, pub, hash)])
+		ec_cache_insert(&cache, pub, hash, key);
+	pthread_mutex_unlock(&cache.lock);
+	return (key);
+}
+
+/**
+* ec_cache_match - Checks a key is the one of a public key
+* @key: Key to check, usually a private one
+* @pub: Public key
+* Return: 1 if they match, 0 otherwise
+*
+* Description: Comparing the points spares encoding @key, and leaves @pub
+* decoded in the cache for when the input gets validated.
+*/
+int ec_cache_match(EC_KEY const *key, uint8_t const pub[EC_PUB_LEN])
+{
+	EC_KEY *cached = ec_cache_get(pub);
+	int match;
+
+	if (!key || !cached)
+	{
+		EC_KEY_free(cached);
+		return (0);
+	}
+	match = EC_POINT_cmp(EC_KEY_get0_group(key), EC_KEY_get0_public_key(key),
+		EC_KEY_get0_public_key(cached), NULL) == 0;
+	EC_KEY_free(cached);
+	return (match);
+}
+
+/**
+* ec_cache_resize - Empties the ec_cache and changes its capacity
+* @capacity: Most keys kept, 0 to disable the cache
+* Return: 0 on success, 1 on failure
+*/
+int ec_cache_resize(size_t capacity)
+{
+	int ret;
+
+	pthread_mutex_lock(&cache.lock);
+	cache.capacity = capacity;
+	ret = ec_cache_resize_locked();
+	pthread_mutex_unlock(&cache.lock);
+	return (ret);
+}
+
+/**
+* ec_cache_resize_locked - Empties the ec_cache and allocates it for its
+* capacity
+* Return: 0 on success, 1 on failure, the cache is then disabled
+*/
+int ec_cache_resize_locked(void)
+{
+	size_t i;
+
+	for (i = 0; i < cache.count; i++)
+		EC_KEY_free(cache.entries[i].key);
+	free(cache.entries);
+	free(cache.table);
+	cache.entries = NULL;
+	cache.table = NULL;
+	cache.table_capacity = 0;
+	cache.count = 0;
+	cache.head = EC_CACHE_NONE;
+	cache.tail = EC_CACHE_NONE;
+	if (!cache.capacity)
+		return (0);
+
+	/* Keep the table at most half full, probes stay short */
+	cache.table_capacity = 1;
+	while (cache.table_capacity < cache.capacity * 2)
+		cache.table_capacity *= 2;
+	cache.entries = calloc(cache.capacity, sizeof(*cache.entries));
+	cache.table = calloc(cache.table_capacity, sizeof(*cache.table));
+	if (!cache.entries || !cache.table)
+	{
+		free(cache.entries);
+		free(cache.table);
+		cache.entries = NULL;
+		cache.table = NULL;
+		cache.capacity = 0;
+		return (1);
+	}
+	return (0);
+}
+
+/**
+* ec_cache_stats - Reads the ec_cache counters
+* @stats: Filled in with the counters
+*/
+void ec_cache_stats(ec_cache_stats_t *stats)
+{
+	if (!stats)
+		return;
+	pthread_mutex_lock(&cache.lock);
+	stats->hits = cache.hits;
+	stats->misses = cache.misses;
+	stats->count = cache.count;
+	stats->capacity = cache.capacity;
+	pthread_mutex_unlock(&cache.lock);
+}
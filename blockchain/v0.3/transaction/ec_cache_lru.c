@@ -0,0 +1,123 @@
+#include "transaction.h"
+
+/**
+* ec_cache_find - Looks a public key up in the cache table
+* @cache: Locked cache
+* @pub: Public key
+* @hash: Hash of @pub
+* Return: Index of the table slot holding the key, or of the empty slot
+* ending the probe
+*/
+size_t ec_cache_find(ec_cache_t const *cache, uint8_t const pub[EC_PUB_LEN],
+	uint64_t hash)
+{
+	size_t mask = cache->table_capacity - 1, i = hash & mask;
+	ec_cache_entry_t const *entry;
+
+	for (; cache->table[i]; i = (i + 1) & mask)
+	{
+		entry = &cache->entries[cache->table[i] - 1];
+		if (entry->hash == hash && !memcmp(entry->pub, pub, EC_PUB_LEN))
+			return (i);
+	}
+	return (i);
+}
+
+/**
+* ec_cache_touch - Moves an entry to the front of the LRU list
+* @cache: Locked cache
+* @i: Entry index
+*/
+void ec_cache_touch(ec_cache_t *cache, size_t i)
+{
+	ec_cache_entry_t *entry = &cache->entries[i];
+
+	if (cache->head == i)
+		return;
+
+	/* Unlink, it isn't the head so it has a previous entry */
+	cache->entries[entry->prev].next = entry->next;
+	if (entry->next != EC_CACHE_NONE)
+		cache->entries[entry->next].prev = entry->prev;
+	else
+		cache->tail = entry->prev;
+
+	entry->prev = EC_CACHE_NONE;
+	entry->next = cache->head;
+	if (cache->head != EC_CACHE_NONE)
+		cache->entries[cache->head].prev = i;
+	cache->head = i;
+	if (cache->tail == EC_CACHE_NONE)
+		cache->tail = i;
+}
+
+/**
+* ec_cache_insert - Adds a decoded key, evicting the least recently used
+* @cache: Locked cache
+* @pub: Public key
+* @hash: Hash of @pub
+* @key: Decoded key, the cache takes a reference of its own
+* Return: 0 on success, 1 on failure
+*/
+int ec_cache_insert(ec_cache_t *cache, uint8_t const pub[EC_PUB_LEN],
+	uint64_t hash, EC_KEY *key)
+{
+	ec_cache_entry_t *entry;
+	size_t i;
+
+	if (!EC_KEY_up_ref(key))
+		return (1);
+	i = cache->count < cache->capacity ? cache->count++ :
+		ec_cache_evict(cache);
+	entry = &cache->entries[i];
+	memcpy(entry->pub, pub, EC_PUB_LEN);
+	entry->hash = hash;
+	entry->key = key;
+
+	/* Append at the tail then touch, the list code stays in one place */
+	entry->next = EC_CACHE_NONE;
+	entry->prev = cache->tail;
+	if (cache->tail != EC_CACHE_NONE)
+		cache->entries[cache->tail].next = i;
+	else
+		cache->head = i;
+	cache->tail = i;
+	ec_cache_touch(cache, i);
+
+	cache->table[ec_cache_find(cache, pub, hash)] = i + 1;
+	return (0);
+}
+
+/**
+* ec_cache_evict - Drops the least recently used entry
+* @cache: Locked, full cache
+* Return: Index of the freed entry
+*/
+size_t ec_cache_evict(ec_cache_t *cache)
+{
+	size_t mask = cache->table_capacity - 1, victim = cache->tail, i, j, home;
+	ec_cache_entry_t *entry = &cache->entries[victim];
+
+	/* Unlink the tail */
+	cache->tail = entry->prev;
+	if (cache->tail != EC_CACHE_NONE)
+		cache->entries[cache->tail].next = EC_CACHE_NONE;
+	else
+		cache->head = EC_CACHE_NONE;
+
+	/* Take it out of the table, shifting the rest of its probe run back */
+	i = ec_cache_find(cache, entry->pub, entry->hash);
+	for (j = (i + 1) & mask; cache->table[j]; j = (j + 1) & mask)
+	{
+		home = cache->entries[cache->table[j] - 1].hash & mask;
+		if (((j - home) & mask) >= ((j - i) & mask))
+		{
+			cache->table[i] = cache->table[j];
+			i = j;
+		}
+	}
+	cache->table[i] = 0;
+	EC_KEY_free(entry->key);
+	entry->key = NULL;
+	return (victim);
+}
@@ -0,0 +1,145 @@
+#include "transaction.h"
+
+int flat_tx_in(llist_node_t input, unsigned int iter, void *flat);
+int flat_tx_out(llist_node_t output, unsigned int iter, void *flat);
+
+/**
+* flat_tx_create - Allocates a flat transaction and its columns
+* @nins: Number of inputs
+* @nouts: Number of outputs
+* Return: NULL or pointer to the zeroed transaction, to free()
+*
+* Description: The columns follow the structure in the same block, the
+* signatures and hashes first so the signature lengths and the 32-bit
+* amounts stay aligned.
+*/
+flat_tx_t *flat_tx_create(uint32_t nins, uint32_t nouts)
+{
+	size_t size = sizeof(flat_tx_t) + (size_t)nins *
+		(3 * SHA256_DIGEST_LENGTH + sizeof(sig_t)) + (size_t)nouts *
+		(SHA256_DIGEST_LENGTH + sizeof(uint32_t) + EC_PUB_LEN);
+	flat_tx_t *flat = calloc(1, size);
+	uint8_t *p;
+
+	if (!flat)
+		return (NULL);
+	flat->nins = nins;
+	flat->nouts = nouts;
+	p = (uint8_t *)(flat + 1);
+	flat->in_sigs = (void *)p;
+	p += (size_t)nins * sizeof(sig_t);
+	flat->in_refs = (void *)p;
+	p += (size_t)nins * 3 * SHA256_DIGEST_LENGTH;
+	flat->out_hashes = (void *)p;
+	p += (size_t)nouts * SHA256_DIGEST_LENGTH;
+	flat->amounts = (void *)p;
+	p += (size_t)nouts * sizeof(uint32_t);
+	flat->pubs = (void *)p;
+	return (flat);
+}
+
+/**
+* transaction_flatten - Copies a transaction to the flat layout
+* @transaction: Transaction to copy
+* Return: NULL or pointer to the flat transaction, to free()
+*/
+flat_tx_t *transaction_flatten(transaction_t const *transaction)
+{
+	flat_tx_t *flat;
+	int nins, nouts;
+
+	if (!transaction)
+		return (NULL);
+	nins = llist_size(transaction->inputs);
+	nouts = llist_size(transaction->outputs);
+	flat = flat_tx_create(nins > 0 ? nins : 0, nouts > 0 ? nouts : 0);
+	if (!flat)
+		return (NULL);
+	memcpy(flat->id, transaction->id, SHA256_DIGEST_LENGTH);
+	llist_for_each(transaction->inputs, flat_tx_in, flat);
+	llist_for_each(transaction->outputs, flat_tx_out, flat);
+	return (flat);
+}
+
+/**
+* flat_tx_expand - Copies a flat transaction back to a transaction_t
+* @flat: Flat transaction
+* Return: NULL or pointer to the transaction, see transaction_destroy()
+*/
+transaction_t *flat_tx_expand(flat_tx_t const *flat)
+{
+	transaction_t *tx = flat ? calloc(1, sizeof(*tx)) : NULL;
+	ti_t *in;
+	to_t *out;
+	uint32_t i;
+
+	if (!tx)
+		return (NULL);
+	memcpy(tx->id, flat->id, SHA256_DIGEST_LENGTH);
+	tx->inputs = llist_create(MT_SUPPORT_FALSE);
+	tx->outputs = llist_create(MT_SUPPORT_FALSE);
+	if (!tx->inputs || !tx->outputs)
+		goto fail;
+	for (i = 0; i < flat->nins; i++)
+	{
+		in = malloc(sizeof(*in));
+		if (!in || llist_add_node(tx->inputs, in, ADD_NODE_REAR))
+		{
+			free(in);
+			goto fail;
+		}
+		/* block_hash, tx_id and tx_out_hash are the reference as is */
+		memcpy(in, flat->in_refs[i], 3 * SHA256_DIGEST_LENGTH);
+		in->sig = flat->in_sigs[i];
+	}
+	for (i = 0; i < flat->nouts; i++)
+	{
+		out = calloc(1, sizeof(*out));
+		if (!out || llist_add_node(tx->outputs, out, ADD_NODE_REAR))
+		{
+			free(out);
+			goto fail;
+		}
+		out->amount = flat->amounts[i];
+		memcpy(out->pub, flat->pubs[i], EC_PUB_LEN);
+		memcpy(out->hash, flat->out_hashes[i], SHA256_DIGEST_LENGTH);
+	}
+	return (tx);
+fail:
+	transaction_destroy(tx);
+	return (NULL);
+}
+
+/**
+* flat_tx_in - llist_for_each() action copying an input to its columns
+* @input: Input
+* @iter: Index of the input
+* @flat: Flat transaction
+* Return: 0
+*/
+int flat_tx_in(llist_node_t input, unsigned int iter, void *flat)
+{
+	flat_tx_t *f = flat;
+
+	memcpy(f->in_refs[iter], input, 3 * SHA256_DIGEST_LENGTH);
+	f->in_sigs[iter] = ((ti_t *)input)->sig;
+	return (0);
+}
+
+/**
+* flat_tx_out - llist_for_each() action copying an output to its columns
+* @output: Output
+* @iter: Index of the output
+* @flat: Flat transaction
+* Return: 0
+*/
+int flat_tx_out(llist_node_t output, unsigned int iter, void *flat)
+{
+	flat_tx_t *f = flat;
+	to_t const *out = output;
+
+	f->amounts[iter] = out->amount;
+	memcpy(f->pubs[iter], out->pub, EC_PUB_LEN);
+	memcpy(f->out_hashes[iter], out->hash, SHA256_DIGEST_LENGTH);
+	return (0);
+}
@@ -0,0 +1,36 @@
+#include "transaction.h"
+
+/**
+* flat_tx_hash - Calculates the hash of a flat transaction, the same as
+* transaction_hash() of its transaction_t
+* @flat: Flat transaction
+* @hash_buf: Buffer to hold the hash
+* Return: pointer to hash_buf or NULL
+*
+* Description: The input references and output hashes are already laid
+* out back to back, nothing is copied before hashing.
+*/
+uint8_t *flat_tx_hash(flat_tx_t const *flat,
+	uint8_t hash_buf[SHA256_DIGEST_LENGTH])
+{
+	if (!flat || !hash_buf)
+		return (NULL);
+	SHA256(flat->in_refs[0], (size_t)flat->nins * 3 * SHA256_DIGEST_LENGTH +
+		(size_t)flat->nouts * SHA256_DIGEST_LENGTH, hash_buf);
+	return (hash_buf);
+}
+
+/**
+* flat_tx_amount - Sums the amounts of the outputs of a flat transaction
+* @flat: Flat transaction
+* Return: The sum
+*/
+uint64_t flat_tx_amount(flat_tx_t const *flat)
+{
+	uint64_t sum = 0;
+	uint32_t i;
+
+	for (i = 0; flat && i < flat->nouts; i++)
+		sum += flat->amounts[i];
+	return (sum);
+}
@@ -0,0 +1,66 @@
+#include "transaction.h"
+
+/**
+* sig_batch_add - Defers one signature check to a batch
+* @batch: Batch to add to
+* @pub: Public key of the spent output
+* @tx_id: ID of the transaction the signature covers
+* @sig: Signature to check, must outlive the batch
+* Return: 0 on success, 1 on failure
+*/
+int sig_batch_add(sig_batch_t *batch, uint8_t const pub[EC_PUB_LEN],
+	uint8_t const tx_id[SHA256_DIGEST_LENGTH], sig_t const *sig)
+{
+	sig_check_t *checks;
+	size_t capacity;
+
+	if (!batch || !pub || !tx_id || !sig)
+		return (1);
+
+	/* Grow the array geometrically */
+	if (batch->count == batch->capacity)
+	{
+		capacity = batch->capacity ? batch->capacity * 2 : 16;
+		checks = realloc(batch->checks, capacity * sizeof(*checks));
+		if (!checks)
+			return (1);
+		batch->checks = checks;
+		batch->capacity = capacity;
+	}
+	memcpy(batch->checks[batch->count].pub, pub, EC_PUB_LEN);
+	memcpy(batch->checks[batch->count].tx_id, tx_id, SHA256_DIGEST_LENGTH);
+	batch->checks[batch->count].sig = sig;
+	batch->count++;
+	return (0);
+}
+
+/**
+* sig_batch_free - Frees the checks of a batch
+* @batch: Batch to empty
+*/
+void sig_batch_free(sig_batch_t *batch)
+{
+	if (!batch)
+		return;
+	free(batch->checks);
+	batch->checks = NULL;
+	batch->count = 0;
+	batch->capacity = 0;
+}
+
+/**
+* sig_check_is_valid - Runs one signature check
+* @check: Check to run
+* Return: 1 if the signature is valid, 0 otherwise
+*/
+int sig_check_is_valid(sig_check_t const *check)
+{
+	EC_KEY *key = ec_cache_get(check->pub);
+	int valid;
+
+	if (!key)
+		return (0);
+	valid = ec_verify(key, check->tx_id, SHA256_DIGEST_LENGTH, check->sig);
+	EC_KEY_free(key);
+	return (valid);
+}
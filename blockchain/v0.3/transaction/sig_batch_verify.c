@@ -0,0 +1,58 @@
+#include "transaction.h"
+
+/**
+* sig_batch_verify - Runs every check of a batch across worker threads
+* @batch: Batch to verify
+* @nthreads: Number of workers, 0 to use one per online CPU
+* Return: 1 if every signature is valid, 0 otherwise
+*
+* Description: Workers grab the next check with an atomic counter and all
+* stop as soon as one check fails. The calling thread works too, so the
+* batch still gets verified if no worker can be started.
+*/
+int sig_batch_verify(sig_batch_t *batch, unsigned int nthreads)
+{
+	pthread_t *threads;
+	unsigned int i, started = 0;
+
+	if (!batch)
+		return (0);
+	if (!nthreads)
+		nthreads = (unsigned int)sysconf(_SC_NPROCESSORS_ONLN);
+	if (nthreads > batch->count)
+		nthreads = batch->count ? (unsigned int)batch->count : 1;
+	batch->next = 0;
+	batch->failed = 0;
+	batch->nthreads = nthreads;
+
+	threads = nthreads > 1 ? calloc(nthreads - 1, sizeof(*threads)) : NULL;
+	for (i = 0; threads && i < nthreads - 1; i++, started++)
+		if (pthread_create(&threads[i], NULL, sig_batch_worker, batch))
+			break;
+	sig_batch_worker(batch);
+	for (i = 0; i < started; i++)
+		pthread_join(threads[i], NULL);
+	free(threads);
+	return (!batch->failed);
+}
+
+/**
+* sig_batch_worker - Thread routine running checks until none is left
+* @arg: Batch being verified
+* Return: NULL
+*/
+void *sig_batch_worker(void *arg)
+{
+	sig_batch_t *batch = arg;
+	size_t i;
+
+	while (!__atomic_load_n(&batch->failed, __ATOMIC_RELAXED))
+	{
+		i = __atomic_fetch_add(&batch->next, 1, __ATOMIC_RELAXED);
+		if (i >= batch->count)
+			break;
+		if (!sig_check_is_valid(&batch->checks[i]))
+			__atomic_store_n(&batch->failed, 1, __ATOMIC_RELAXED);
+	}
+	return (NULL);
+}
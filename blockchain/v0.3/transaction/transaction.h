@@ -11,6 +11,8 @@
 #include <stdint.h>
 #include <string.h>
 #include <time.h>
+#include <pthread.h>
+#include <unistd.h>
 
 /* Macros */
 #define COINBASE_AMOUNT 50
@@ -20,6 +22,13 @@
 #define PTR_MOVE (sizeof(uint32_t) + EC_PUB_LEN)
 #define UNSPENT ((uto_t *)unspent)
 #define CONTEXT ((tc_t *)context)
+#define UTXO_SET_MIN 16
+/* Highest load of a utxo_set_t, as UTXO_SET_LOAD_NUM / UTXO_SET_LOAD_DEN */
+#define UTXO_SET_LOAD_NUM 3
+#define UTXO_SET_LOAD_DEN 4
+/* Default number of decoded public keys kept by the ec_cache */
+#define EC_CACHE_SIZE 4096
+#define EC_CACHE_NONE ((size_t)-1)
 
 
 /* Structs */
@@ -90,6 +99,98 @@ typedef struct unspent_tx_out_s
 	tx_out_t    out;
 } unspent_tx_out_t, uto_t;
 
+/**
+* struct flat_tx_s - Transaction with its inputs and outputs in columns
+*
+* Description: Everything lives in the one allocation of flat_tx_create().
+* @out_hashes starts right where @in_refs ends, so the two together are
+* the message transaction_hash() hashes, as is.
+*
+* @id:         Transaction identifier
+* @nins:       Number of inputs
+* @nouts:      Number of outputs
+* @in_sigs:    Signature of each input
+* @in_refs:    Block hash, transaction ID and output hash each input
+*              references, 3 * SHA256_DIGEST_LENGTH bytes per input
+* @out_hashes: Hash of each output
+* @amounts:    Amount of each output
+* @pubs:       Public key each output pays to
+*/
+typedef struct flat_tx_s
+{
+	uint8_t     id[SHA256_DIGEST_LENGTH];
+	uint32_t    nins;
+	uint32_t    nouts;
+	sig_t       *in_sigs;
+	uint8_t     (*in_refs)[3 * SHA256_DIGEST_LENGTH];
+	uint8_t     (*out_hashes)[SHA256_DIGEST_LENGTH];
+	uint32_t    *amounts;
+	uint8_t     (*pubs)[EC_PUB_LEN];
+} flat_tx_t;
+
+/**
+* struct utxo_slot_s - Slot of a utxo_set_t
+* @hash: Hash of the key of @utxo, saves most full key compares
+* @utxo: Unspent output held by the slot, NULL if the slot is empty
+* @seq: Number of outputs added to the set before @utxo
+*/
+typedef struct utxo_slot_s
+{
+	uint64_t    hash;
+	uto_t       *utxo;
+	uint64_t    seq;
+} utxo_slot_t;
+
+/**
+* struct utxo_addr_s - Unspent outputs of one public key
+* @pub: Public key the outputs pay to
+* @hash: Hash of @pub
+* @balance: Sum of the amounts of @utxos
+* @utxos: Outputs paying to @pub, oldest first
+* @count: Number of outputs in @utxos
+* @capacity: Number of outputs @utxos has room for
+*/
+typedef struct utxo_addr_s
+{
+	uint8_t     pub[EC_PUB_LEN];
+	uint64_t    hash;
+	uint64_t    balance;
+	uto_t       **utxos;
+	size_t      count;
+	size_t      capacity;
+} utxo_addr_t;
+
+/**
+* struct utxo_set_s - Open-addressing hash set of unspent outputs
+*
+* Description: Keyed by (block_hash, tx_id, out.hash), the same three
+* hashes a transaction input references. Linear probing over a power of two
+* number of slots, removals shift the probe run back so no tombstones build
+* up. The set only holds pointers; whether it owns the outputs is up to the
+* caller, see utxo_set_destroy(). Once utxo_set_index_addresses() is
+* called, a second table of the same kind also groups the outputs by
+* public key.
+*
+* @slots: Slot array
+* @capacity: Number of slots, a power of two
+* @count: Number of outputs in the set
+* @addrs: Address table, NULL while addresses aren't indexed
+* @addr_capacity: Number of address slots, a power of two
+* @addr_count: Number of public keys with at least one output
+* @next_seq: Insertion number of the next output added, so the address
+* index can follow insertion order
+*/
+typedef struct utxo_set_s
+{
+	utxo_slot_t *slots;
+	size_t      capacity;
+	size_t      count;
+	utxo_addr_t **addrs;
+	size_t      addr_capacity;
+	size_t      addr_count;
+	uint64_t    next_seq;
+} utxo_set_t;
+
 /**
 * struct tx_context_s - Tracks the balance available for a specific private key
 * @pub: Public key used to match with a private key
@@ -98,6 +199,8 @@ typedef struct unspent_tx_out_s
 * @tx: The transaction structure
 * @sender: The sender's private key
 * @unused_transactions: A list of unspent transaction outputs (uto_t)
+* @set: Set of unspent transaction outputs, used instead of
+*       @unused_transactions when not NULL
 */
 typedef struct tx_context_s
 {
@@ -107,14 +210,110 @@ typedef struct tx_context_s
 	transaction_t *tx;
 	EC_KEY const  *sender;
 	llist_t       *unused_transactions;
+	utxo_set_t    *set;
 } tc_t;
 
+/**
+* struct sig_check_s - Signature check deferred to a sig_batch_t
+* @pub: Public key of the spent output
+* @tx_id: ID of the transaction the signature covers
+* @sig: Signature of the input, owned by the transaction being validated
+*/
+typedef struct sig_check_s
+{
+	uint8_t     pub[EC_PUB_LEN];
+	uint8_t     tx_id[SHA256_DIGEST_LENGTH];
+	sig_t const *sig;
+} sig_check_t;
+
+/**
+* struct sig_batch_s - Signature checks collected over a whole block
+* @checks: Checks to run
+* @count: Number of checks
+* @capacity: Number of checks @checks has room for
+* @next: Index of the next check to hand to a worker
+* @failed: Set to 1 as soon as one check fails
+* @nthreads: Number of workers verifying the batch
+*/
+typedef struct sig_batch_s
+{
+	sig_check_t *checks;
+	size_t      count;
+	size_t      capacity;
+	size_t      next;
+	int         failed;
+	unsigned int nthreads;
+} sig_batch_t;
+
+/**
+* struct ec_cache_entry_s - Decoded public key kept by the ec_cache
+* @pub: Public key
+* @hash: Hash of @pub, from utxo_addr_hash()
+* @key: Decoded key, the cache holds one reference to it
+* @prev: More recently used entry, EC_CACHE_NONE for the first one
+* @next: Less recently used entry, EC_CACHE_NONE for the last one
+*/
+typedef struct ec_cache_entry_s
+{
+	uint8_t  pub[EC_PUB_LEN];
+	uint64_t hash;
+	EC_KEY   *key;
+	size_t   prev;
+	size_t   next;
+} ec_cache_entry_t;
+
+/**
+* struct ec_cache_s - Bounded LRU cache of decoded public keys
+* @lock: Guards every other field
+* @entries: Entries, @count of them are used
+* @table: Open addressing table of entry indexes plus one, 0 when empty
+* @table_capacity: Number of slots of @table, a power of two
+* @capacity: Most entries the cache holds, 0 disables it
+* @count: Number of entries in use
+* @head: Most recently used entry
+* @tail: Least recently used entry, the next one evicted
+* @hits: Number of lookups served from the cache
+* @misses: Number of lookups that had to decode the key
+*/
+typedef struct ec_cache_s
+{
+	pthread_mutex_t  lock;
+	ec_cache_entry_t *entries;
+	size_t           *table;
+	size_t           table_capacity;
+	size_t           capacity;
+	size_t           count;
+	size_t           head;
+	size_t           tail;
+	unsigned long    hits;
+	unsigned long    misses;
+} ec_cache_t;
+
+/**
+* struct ec_cache_stats_s - Snapshot of the ec_cache counters
+* @hits: Number of lookups served from the cache
+* @misses: Number of lookups that had to decode the key
+* @count: Number of keys held
+* @capacity: Most keys held
+*/
+typedef struct ec_cache_stats_s
+{
+	unsigned long hits;
+	unsigned long misses;
+	size_t        count;
+	size_t        capacity;
+} ec_cache_stats_t;
+
 /**
 * struct tx_valid_s - Holds information to validate a transaction
 * @input: The total amount from transaction inputs
 * @output: The total amount from transaction outputs
 * @tx_id: The transaction ID
 * @unspent: A list of unspent transaction outputs (uto_t)
+* @set: Hashed set of the unspent outputs, searched instead of @unspent
+*       when not NULL
+* @batch: When not NULL, signatures are collected there to be verified
+*         later instead of right away
 */
 typedef struct tx_valid_s
 {
@@ -122,19 +321,25 @@ typedef struct tx_valid_s
 	uint32_t   output;
 	uint8_t    tx_id[SHA256_DIGEST_LENGTH];
 	llist_t    *unspent;
+	utxo_set_t *set;
+	sig_batch_t *batch;
 } tv_t;
 
 /**
 * struct update_list_s - Holds information for updating the list of unspent outputs
 * @hash: The hash of the block containing the transaction
-* @unspent: The list of unspent transaction outputs (uto_t)
+* @unspent: The list collecting the created unspent outputs (uto_t), or NULL
 * @tx_id: The transaction ID
+* @set: The set of unspent outputs being updated
+* @free_spent: 1 if the spent outputs are to be freed as they leave @set
 */
 typedef struct update_list_s
 {
 	uint8_t    hash[SHA256_DIGEST_LENGTH];
 	llist_t    *unspent;
 	uint8_t    tx_id[SHA256_DIGEST_LENGTH];
+	utxo_set_t *set;
+	int        free_spent;
 } ul_t;
 
 /* Prototypes */
@@ -145,12 +350,64 @@ typedef struct update_list_s
 * @transactions: List of validated transactions
 * @block_hash: Hash of the block containing these transactions
 * @all_unspent: Current list of all unspent transaction outputs
-* Return: A new list of unspent transaction outputs
+* Return: @all_unspent, updated in place, or NULL if an argument is NULL
+* or the block doesn't apply, @all_unspent then being left as it was
 */
 llist_t *update_unspent(llist_t *transactions,
 							uint8_t block_hash[SHA256_DIGEST_LENGTH],
 							llist_t *all_unspent);
 
+/**
+* unspent_keep - Moves the outputs still in a set from one list to another
+* @from: List to empty
+* @to: List to append the outputs still in @set to
+* @set: Set of the outputs to keep, the others are freed
+* Return: 0 on success, 1 on failure, an output that couldn't be added is
+* freed
+*/
+int unspent_keep(llist_t *from, llist_t *to, utxo_set_t const *set);
+
+/**
+* utxo_set_update - Applies the transactions of a block to a set of
+* unspent outputs
+* @set: Set to update
+* @transactions: List of validated transactions
+* @block_hash: Hash of the block containing these transactions
+* @created: List to append each created output to, or NULL
+* @free_spent: 1 if the set owns its outputs and frees them once spent
+* Return: 0 on success, 1 on failure
+*/
+int utxo_set_update(utxo_set_t *set, llist_t *transactions,
+	uint8_t const block_hash[SHA256_DIGEST_LENGTH], llist_t *created,
+	int free_spent);
+
+/**
+* utxo_apply_tx - llist_for_each() action applying one transaction
+* @tx: Transaction (transaction_t)
+* @iter: Index of the transaction in its block (unused)
+* @context: Update context (ul_t)
+* Return: 0 on success, 1 on failure
+*/
+int utxo_apply_tx(llist_node_t tx, unsigned int iter, void *context);
+
+/**
+* utxo_spend_input - llist_for_each() action removing a spent output
+* @in: Transaction input (tx_in_t)
+* @iter: Index of the input (unused)
+* @context: Update context (ul_t)
+* Return: Always 0
+*/
+int utxo_spend_input(llist_node_t in, unsigned int iter, void *context);
+
+/**
+* utxo_add_output - llist_for_each() action adding a created output
+* @out: Transaction output (tx_out_t)
+* @iter: Index of the output (unused)
+* @context: Update context (ul_t)
+* Return: 0 on success, 1 on failure
+*/
+int utxo_add_output(llist_node_t out, unsigned int iter, void *context);
+
 
 /**
  * tx_in_sign - Signs a transaction input after verifying key
@@ -164,6 +421,19 @@ sig_t *tx_in_sign(
 	ti_t *in, uint8_t const tx_id[SHA256_DIGEST_LENGTH], EC_KEY const *sender,
 	llist_t *unused_transactions);
 
+/**
+ * tx_in_sign_set - Signs a transaction input after verifying key, looking
+ * the spent output up in a set
+ * @in: Transaction input
+ * @tx_id: hash of transaction holding tx_input
+ * @sender: private key of receiver
+ * @set: set of all unspent transactions
+ * Return: hash holding the signature or NULL
+ */
+sig_t *tx_in_sign_set(
+	ti_t *in, uint8_t const tx_id[SHA256_DIGEST_LENGTH], EC_KEY const *sender,
+	utxo_set_t const *set);
+
 /**
 * tx_in_create - creates a transaction input struct
 * @unspent: pointer to unspent transaction to be used
@@ -230,6 +500,38 @@ transaction_t *transaction_create(
 	EC_KEY const *sender, EC_KEY const *receiver, uint32_t amount,
 	llist_t *unused_transactions);
 
+/**
+ * transaction_create_set - Initializes a new transaction, selecting coins
+ * from the sender's own outputs in a set
+ * @sender: Private key of the sender
+ * @receiver: Public key of the receiver
+ * @amount: The amount to transfer
+ * @set: Set of unspent outputs, its addresses get indexed if they aren't
+ * Return: NULL if failed, otherwise pointer to the newly created transaction
+ */
+transaction_t *transaction_create_set(
+	EC_KEY const *sender, EC_KEY const *receiver, uint32_t amount,
+	utxo_set_t *set);
+
+/**
+ * transaction_finish - Builds the outputs of a transaction, hashes it and
+ * signs its inputs once the coins are selected
+ * @context: Context holding the transaction and the selected inputs
+ * @amount: The amount to transfer
+ * @receiver: Public key of the receiver
+ * Return: The transaction, or NULL if failed
+ */
+transaction_t *transaction_finish(
+	tc_t *context, uint32_t amount, EC_KEY const *receiver);
+
+/**
+ * select_unspent - Adds one of the sender's outputs as a transaction input
+ * @context: Struct holding the necessary information
+ * @unspent: Output paying to the sender
+ * Return: 0 on success, 1 on failure
+ */
+int select_unspent(tc_t *context, uto_t const *unspent);
+
 /**
  * match_transaction - Searches through unused transactions to find a match
  * @unused_tx: Unused transaction
@@ -266,6 +568,24 @@ int process_transaction_output(uint32_t amount, tc_t *tx_context, EC_KEY const *
 int transaction_is_valid(
     const transaction_t *transaction, llist_t *unused_transactions);
 
+/**
+ * transaction_is_valid_set - Checks whether a transaction is valid against
+ * a hashed set of unspent outputs
+ * @transaction: The transaction to be validated
+ * @set: Set of unspent transaction outputs
+ * Return: 1 if the transaction is valid, 0 if invalid
+ */
+int transaction_is_valid_set(
+	const transaction_t *transaction, utxo_set_t *set);
+
+/**
+ * tx_context_is_valid - Checks a transaction against a filled in context
+ * @transaction: The transaction to be validated
+ * @context: Context holding the transaction ID and the unspent outputs
+ * Return: 1 if the transaction is valid, 0 if invalid
+ */
+int tx_context_is_valid(const transaction_t *transaction, tv_t *context);
+
 /**
  * validate_input_signature - Verifies the signature and checks for unspent outputs
  * @in: Input transaction to validate
@@ -292,6 +612,30 @@ int match_unspent_output(uto_t *unspent, tx_in_t *in);
  */
 int accumulate_output_value(tx_out_t *out, unsigned int i, tv_t *context);
 
+/**
+ * tx_outputs_unique - Checks no two outputs of a transaction share a hash
+ * @transaction: The transaction to check
+ * Return: 1 if every output hash is unique, 0 otherwise or on failure
+ */
+int tx_outputs_unique(const transaction_t *transaction);
+
+/**
+ * output_hash_cpy - Copies the hash of an output into an array
+ * @out: Output to copy the hash of
+ * @i: Index of the output in the array
+ * @hashes: Array of hashes to copy to
+ * Return: Always 0
+ */
+int output_hash_cpy(tx_out_t *out, unsigned int i, void *hashes);
+
+/**
+ * output_hash_cmp - qsort() comparison of output hashes
+ * @a: First hash
+ * @b: Second hash
+ * Return: Negative, 0 or positive as for memcmp()
+ */
+int output_hash_cmp(const void *a, const void *b);
+
 /**
  * transaction_destroy - Frees a transaction and its associated lists
  * @transaction: The transaction to be freed
@@ -316,4 +660,328 @@ int coinbase_is_valid(
 transaction_t *coinbase_create(
     EC_KEY const *receiver, uint32_t block_index);
 
+/**
+ * utxo_set_create - Creates an empty hashed set of unspent outputs
+ * @hint: Number of outputs the set is expected to hold, 0 if unknown
+ * Return: NULL or pointer to the new set
+ */
+utxo_set_t *utxo_set_create(size_t hint);
+
+/**
+ * utxo_set_destroy - Frees a set of unspent outputs
+ * @set: Set to free
+ * @free_utxos: 1 to also free the outputs it holds, 0 to leave them alone
+ */
+void utxo_set_destroy(utxo_set_t *set, int free_utxos);
+
+/**
+ * utxo_key_hash - Hashes the key of an unspent output
+ * @block_hash: Hash of the block holding the output
+ * @tx_id: ID of the transaction holding the output
+ * @out_hash: Hash of the output
+ * Return: The key hash
+ */
+uint64_t utxo_key_hash(uint8_t const block_hash[SHA256_DIGEST_LENGTH],
+	uint8_t const tx_id[SHA256_DIGEST_LENGTH],
+	uint8_t const out_hash[SHA256_DIGEST_LENGTH]);
+
+/**
+ * utxo_set_slot - Finds the slot of an unspent output, or where it would go
+ * @set: Set to search
+ * @hash: Key hash, from utxo_key_hash()
+ * @block_hash: Hash of the block holding the output
+ * @tx_id: ID of the transaction holding the output
+ * @out_hash: Hash of the output
+ * Return: Index of the matching slot, or of the empty slot ending the probe
+ */
+size_t utxo_set_slot(utxo_set_t const *set, uint64_t hash,
+	uint8_t const block_hash[SHA256_DIGEST_LENGTH],
+	uint8_t const tx_id[SHA256_DIGEST_LENGTH],
+	uint8_t const out_hash[SHA256_DIGEST_LENGTH]);
+
+/**
+ * utxo_set_find - Looks an unspent output up by its key
+ * @set: Set to search
+ * @block_hash: Hash of the block holding the output
+ * @tx_id: ID of the transaction holding the output
+ * @out_hash: Hash of the output
+ * Return: The unspent output, or NULL if the set doesn't hold it
+ */
+uto_t *utxo_set_find(utxo_set_t const *set,
+	uint8_t const block_hash[SHA256_DIGEST_LENGTH],
+	uint8_t const tx_id[SHA256_DIGEST_LENGTH],
+	uint8_t const out_hash[SHA256_DIGEST_LENGTH]);
+
+/**
+ * utxo_set_add - Inserts an unspent output into a set
+ * @set: Set to insert into
+ * @utxo: Output to insert, the set only keeps the pointer
+ * Return: 0 on success, 1 on failure or if the set already holds its key
+ */
+int utxo_set_add(utxo_set_t *set, uto_t *utxo);
+
+/**
+ * utxo_set_remove - Takes an unspent output out of a set
+ * @set: Set to remove from
+ * @block_hash: Hash of the block holding the output
+ * @tx_id: ID of the transaction holding the output
+ * @out_hash: Hash of the output
+ * Return: The removed output, for the caller to free, or NULL if not found
+ */
+uto_t *utxo_set_remove(utxo_set_t *set,
+	uint8_t const block_hash[SHA256_DIGEST_LENGTH],
+	uint8_t const tx_id[SHA256_DIGEST_LENGTH],
+	uint8_t const out_hash[SHA256_DIGEST_LENGTH]);
+
+/**
+ * utxo_set_grow - Moves every output of a set to a bigger slot array
+ * @set: Set to grow
+ * @capacity: New number of slots, a power of two
+ * Return: 0 on success, 1 on failure
+ */
+int utxo_set_grow(utxo_set_t *set, size_t capacity);
+
+/**
+ * utxo_set_from_list - Indexes an llist of unspent outputs in a new set
+ * @list: List of unspent outputs (uto_t)
+ * Return: NULL or pointer to the new set, sharing the outputs with @list
+ */
+utxo_set_t *utxo_set_from_list(llist_t *list);
+
+/**
+ * utxo_set_add_node - llist_for_each() action inserting an output in a set
+ * @utxo: Unspent output (uto_t)
+ * @iter: Index of the output in its list (unused)
+ * @set: Set to insert into
+ * Return: 0 on success, 1 on failure
+ */
+int utxo_set_add_node(llist_node_t utxo, unsigned int iter, void *set);
+
+/**
+ * utxo_set_to_list - Lists the outputs of a set in an llist
+ * @set: Set to list
+ * Return: NULL or pointer to a new list sharing the outputs with @set, in
+ * the order they were added to the set
+ */
+llist_t *utxo_set_to_list(utxo_set_t const *set);
+
+/**
+ * sig_batch_add - Defers one signature check to a batch
+ * @batch: Batch to add to
+ * @pub: Public key of the spent output
+ * @tx_id: ID of the transaction the signature covers
+ * @sig: Signature to check, must outlive the batch
+ * Return: 0 on success, 1 on failure
+ */
+int sig_batch_add(sig_batch_t *batch, uint8_t const pub[EC_PUB_LEN],
+	uint8_t const tx_id[SHA256_DIGEST_LENGTH], sig_t const *sig);
+
+/**
+ * sig_batch_free - Frees the checks of a batch
+ * @batch: Batch to empty
+ */
+void sig_batch_free(sig_batch_t *batch);
+
+/**
+ * sig_check_is_valid - Runs one signature check
+ * @check: Check to run
+ * Return: 1 if the signature is valid, 0 otherwise
+ */
+int sig_check_is_valid(sig_check_t const *check);
+
+/**
+ * sig_batch_verify - Runs every check of a batch across worker threads
+ * @batch: Batch to verify
+ * @nthreads: Number of workers, 0 to use one per online CPU
+ * Return: 1 if every signature is valid, 0 otherwise
+ */
+int sig_batch_verify(sig_batch_t *batch, unsigned int nthreads);
+
+/**
+ * sig_batch_worker - Thread routine running checks until none is left
+ * @arg: Batch being verified
+ * Return: NULL
+ */
+void *sig_batch_worker(void *arg);
+
+/**
+ * ec_cache_get - Decodes a public key, through the shared ec_cache
+ * @pub: Public key
+ * Return: A reference to the key, to release with EC_KEY_free(), or NULL
+ */
+EC_KEY *ec_cache_get(uint8_t const pub[EC_PUB_LEN]);
+
+/**
+ * ec_cache_match - Checks a key is the one of a public key
+ * @key: Key to check, usually a private one
+ * @pub: Public key
+ * Return: 1 if they match, 0 otherwise
+ */
+int ec_cache_match(EC_KEY const *key, uint8_t const pub[EC_PUB_LEN]);
+
+/**
+ * ec_cache_resize - Empties the ec_cache and changes its capacity
+ * @capacity: Most keys kept, 0 to disable the cache
+ * Return: 0 on success, 1 on failure
+ */
+int ec_cache_resize(size_t capacity);
+
+/**
+ * ec_cache_stats - Reads the ec_cache counters
+ * @stats: Filled in with the counters
+ */
+void ec_cache_stats(ec_cache_stats_t *stats);
+
+/**
+ * ec_cache_find - Looks a public key up in the cache table
+ * @cache: Locked cache
+ * @pub: Public key
+ * @hash: Hash of @pub
+ * Return: Index of the table slot holding the key, or of the empty slot
+ * ending the probe
+ */
+size_t ec_cache_find(ec_cache_t const *cache, uint8_t const pub[EC_PUB_LEN],
+	uint64_t hash);
+
+/**
+ * ec_cache_touch - Moves an entry to the front of the LRU list
+ * @cache: Locked cache
+ * @i: Entry index
+ */
+void ec_cache_touch(ec_cache_t *cache, size_t i);
+
+/**
+ * ec_cache_insert - Adds a decoded key, evicting the least recently used
+ * @cache: Locked cache
+ * @pub: Public key
+ * @hash: Hash of @pub
+ * @key: Decoded key, the cache takes a reference of its own
+ * Return: 0 on success, 1 on failure
+ */
+int ec_cache_insert(ec_cache_t *cache, uint8_t const pub[EC_PUB_LEN],
+	uint64_t hash, EC_KEY *key);
+
+/**
+ * ec_cache_evict - Drops the least recently used entry
+ * @cache: Locked, full cache
+ * Return: Index of the freed entry
+ */
+size_t ec_cache_evict(ec_cache_t *cache);
+
+/**
+ * utxo_set_index_addresses - Starts grouping the outputs of a set by
+ * public key, the index is then kept up to date by every add and remove
+ * @set: Set to index
+ * Return: 0 on success, 1 on failure
+ */
+int utxo_set_index_addresses(utxo_set_t *set);
+
+/**
+ * utxo_set_balance - Sums the unspent outputs paying to a public key
+ * @set: Set with indexed addresses
+ * @pub: Public key to sum the outputs of
+ * Return: The balance, 0 if the key has no output
+ */
+uint64_t utxo_set_balance(utxo_set_t const *set,
+	uint8_t const pub[EC_PUB_LEN]);
+
+/**
+ * utxo_addr_hash - Hashes a public key
+ * @pub: Public key
+ * Return: The hash
+ */
+uint64_t utxo_addr_hash(uint8_t const pub[EC_PUB_LEN]);
+
+/**
+ * utxo_addr_find - Looks the outputs of a public key up
+ * @set: Set with indexed addresses
+ * @pub: Public key
+ * Return: The key's outputs, or NULL if it has none
+ */
+utxo_addr_t *utxo_addr_find(utxo_set_t const *set,
+	uint8_t const pub[EC_PUB_LEN]);
+
+/**
+ * utxo_addr_link - Files an output under its public key
+ * @set: Set with indexed addresses
+ * @utxo: Output to file
+ * Return: 0 on success, 1 on failure
+ */
+int utxo_addr_link(utxo_set_t *set, uto_t *utxo);
+
+/**
+ * utxo_addr_unlink - Takes an output out of its public key's outputs
+ * @set: Set with indexed addresses
+ * @utxo: Output to take out
+ */
+void utxo_addr_unlink(utxo_set_t *set, uto_t const *utxo);
+
+/**
+ * utxo_addr_grow - Moves every address of a set to a bigger table
+ * @set: Set with indexed addresses
+ * @capacity: New number of address slots, a power of two
+ * Return: 0 on success, 1 on failure
+ */
+int utxo_addr_grow(utxo_set_t *set, size_t capacity);
+
+/**
+ * utxo_set_sorted - Copies the full slots of a set in insertion order
+ * @set: Set
+ * Return: NULL or array of @set->count slots, to free
+ */
+utxo_slot_t *utxo_set_sorted(utxo_set_t const *set);
+
+/**
+ * utxo_slot_seq_cmp - qsort() comparison of slots by insertion number
+ * @a: First slot
+ * @b: Second slot
+ * Return: Negative, 0 or positive as @a was added before, with or after @b
+ */
+int utxo_slot_seq_cmp(void const *a, void const *b);
+
+/**
+ * utxo_addr_destroy - Frees the address index of a set
+ * @set: Set to drop the address index of
+ */
+void utxo_addr_destroy(utxo_set_t *set);
+
+/**
+ * flat_tx_create - Allocates a flat transaction and its columns
+ * @nins: Number of inputs
+ * @nouts: Number of outputs
+ * Return: NULL or pointer to the zeroed transaction, to free()
+ */
+flat_tx_t *flat_tx_create(uint32_t nins, uint32_t nouts);
+
+/**
+ * transaction_flatten - Copies a transaction to the flat layout
+ * @transaction: Transaction to copy
+ * Return: NULL or pointer to the flat transaction, to free()
+ */
+flat_tx_t *transaction_flatten(transaction_t const *transaction);
+
+/**
+ * flat_tx_expand - Copies a flat transaction back to a transaction_t
+ * @flat: Flat transaction
+ * Return: NULL or pointer to the transaction, see transaction_destroy()
+ */
+transaction_t *flat_tx_expand(flat_tx_t const *flat);
+
+/**
+ * flat_tx_hash - Calculates the hash of a flat transaction, the same as
+ * transaction_hash() of its transaction_t
+ * @flat: Flat transaction
+ * @hash_buf: Buffer to hold the hash
+ * Return: pointer to hash_buf or NULL
+ */
+uint8_t *flat_tx_hash(flat_tx_t const *flat,
+	uint8_t hash_buf[SHA256_DIGEST_LENGTH]);
+
+/**
+ * flat_tx_amount - Sums the amounts of the outputs of a flat transaction
+ * @flat: Flat transaction
+ * Return: The sum
+ */
+uint64_t flat_tx_amount(flat_tx_t const *flat);
+
 #endif
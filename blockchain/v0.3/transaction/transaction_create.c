@@ -40,6 +40,22 @@ transaction_t *transaction_create(EC_KEY const *sender, EC_KEY const *receiver,
 	/* Process unspent transactions */
 	llist_for_each(unused_transactions, match_transaction, context);
 
+	return (transaction_finish(context, amount, receiver));
+}
+
+/**
+* transaction_finish - Builds the outputs of a transaction, hashes it and
+* signs its inputs once the coins are selected
+* @context: Context holding the transaction and the selected inputs
+* @amount: Amount to send
+* @receiver: Public key of receiver
+* Return: NULL on Fail or pointer to new transaction
+*/
+transaction_t *transaction_finish(
+	tc_t *context, uint32_t amount, EC_KEY const *receiver)
+{
+	transaction_t *this_tx = context->tx;
+
 	/* If balance is insufficient, fail */
 	if (context->needed > 0)
 	{
@@ -77,19 +93,31 @@ transaction_t *transaction_create(EC_KEY const *sender, EC_KEY const *receiver,
 int match_transaction(llist_node_t unspent, unsigned int i, void *context)
 {
 	(void)i;
-	ti_t *new_txi;
 
 	if (CONTEXT->needed <= 0 || !unspent)
 		return (1);
 
 	/* If public keys match, add input to transaction */
 	if (!memcmp(CONTEXT->pub, UNSPENT->out.pub, EC_PUB_LEN))
-	{
-		new_txi = tx_in_create(UNSPENT);
-		llist_add_node(CONTEXT->tx->inputs, new_txi, ADD_NODE_REAR);
-		CONTEXT->balance += (int)UNSPENT->out.amount;
-		CONTEXT->needed -= (int)UNSPENT->out.amount;
-	}
+		return (select_unspent(CONTEXT, UNSPENT));
+	return (0);
+}
+
+/**
+* select_unspent - Adds one of the sender's outputs as a transaction input
+* @context: Struct holding needed info
+* @unspent: Output paying to the sender
+* Return: 0 on success or 1 on fail
+*/
+int select_unspent(tc_t *context, uto_t const *unspent)
+{
+	ti_t *new_txi = tx_in_create(unspent);
+
+	if (!new_txi)
+		return (1);
+	llist_add_node(context->tx->inputs, new_txi, ADD_NODE_REAR);
+	context->balance += (int)unspent->out.amount;
+	context->needed -= (int)unspent->out.amount;
 	return (0);
 }
 
@@ -141,6 +169,9 @@ int sign_transaction_input(llist_node_t tx_in, unsigned int i, void *context)
 		return (1);
 
 	/* Sign the input transaction */
-	tx_in_sign(((ti_t *)tx_in), CONTEXT->tx->id, CONTEXT->sender, CONTEXT->unused_transactions);
+	if (CONTEXT->set)
+		tx_in_sign_set(((ti_t *)tx_in), CONTEXT->tx->id, CONTEXT->sender, CONTEXT->set);
+	else
+		tx_in_sign(((ti_t *)tx_in), CONTEXT->tx->id, CONTEXT->sender, CONTEXT->unused_transactions);
 	return (0);
 }
@@ -0,0 +1,51 @@
+#include "transaction.h"
+
+/**
+* transaction_create_set - Creates a new transaction struct, selecting coins
+* from the sender's own outputs in a set
+* @sender: Private key of sender
+* @receiver: Public key of receiver
+* @amount: Amount to send
+* @set: Set of unused transactions, its addresses get indexed if they aren't
+* Return: NULL on Fail or pointer to new transaction
+*
+* Description: Picks the same coins as transaction_create() would, oldest
+* first, but only walks the sender's outputs instead of every output.
+*/
+transaction_t *transaction_create_set(EC_KEY const *sender,
+	EC_KEY const *receiver, uint32_t amount, utxo_set_t *set)
+{
+	transaction_t *this_tx = NULL;
+	tc_t *context = NULL;
+	utxo_addr_t *addr;
+	size_t i;
+
+	/* Validate inputs */
+	if (!sender || !receiver || !amount || !set ||
+		utxo_set_index_addresses(set))
+		return (NULL);
+	/* Allocate memory for context and transaction */
+	context = calloc(1, sizeof(tc_t));
+	this_tx = calloc(1, sizeof(transaction_t));
+	if (!this_tx || !context)
+	{
+		free(this_tx);
+		free(context);
+		return (NULL);
+	}
+
+	/* Set context fields */
+	context->tx = this_tx;
+	context->set = set;
+	ec_to_pub(sender, context->pub);
+	context->needed = (int)amount;
+	context->sender = sender;
+	this_tx->inputs = llist_create(MT_SUPPORT_FALSE);
+
+	/* Only the sender's outputs, and only while more coins are needed */
+	addr = utxo_addr_find(set, context->pub);
+	for (i = 0; addr && i < addr->count && context->needed > 0; i++)
+		select_unspent(context, addr->utxos[i]);
+
+	return (transaction_finish(context, amount, receiver));
+}
@@ -9,7 +9,6 @@
 int transaction_is_valid(
 	const transaction_t *transaction, llist_t *unused_transactions)
 {
-	uint8_t v_hash[SHA256_DIGEST_LENGTH];
 	tv_t context = {0};
 
 	/* Check if either transaction or unspent list is NULL */
@@ -20,28 +19,7 @@ int transaction_is_valid(
 	memcpy(context.tx_id, transaction->id, SHA256_DIGEST_LENGTH);
 	context.unspent = unused_transactions;
 
-	/* Compute the hash of the transaction */
-	transaction_hash(transaction, v_hash);
-
-	/* Compare the computed hash with the transaction's ID */
-	if (memcmp(v_hash, transaction->id, SHA256_DIGEST_LENGTH))
-		return (0);
-
-	/* Verify the validity of each input transaction */
-	if (llist_for_each(transaction->inputs,
-		(node_func_t)&validate_input_signature, &context))
-		return (0);
-
-	/* Accumulate the total amount from the transaction outputs */
-	llist_for_each(transaction->outputs,
-					(node_func_t)&accumulate_output_value, &context);
-
-	/* Ensure that the total inputs equal total outputs */
-	if (context.input != context.output)
-		return (0);
-
-	/* Return 1 if the transaction is valid */
-	return (1);
+	return (tx_context_is_valid(transaction, &context));
 }
 
 /**
@@ -58,8 +36,12 @@ int validate_input_signature(tx_in_t *in, uint32_t i, tv_t *context)
 	EC_KEY *key = NULL;
 
 	/* Look for a matching unspent transaction output */
-	match_found = llist_find_node(context->unspent,
-		(node_ident_t)&match_unspent_output, in);
+	if (context->set)
+		match_found = utxo_set_find(context->set,
+			in->block_hash, in->tx_id, in->tx_out_hash);
+	else
+		match_found = llist_find_node(context->unspent,
+			(node_ident_t)&match_unspent_output, in);
 
 	/* Return 1 if no matching output is found */
 	if (!match_found)
@@ -68,8 +50,13 @@ int validate_input_signature(tx_in_t *in, uint32_t i, tv_t *context)
 	/* Add the amount of the matched output to the input total */
 	context->input += match_found->out.amount;
 
-	/* Get the public key from the matched unspent output */
-	key = ec_from_pub(match_found->out.pub);
+	/* In batch mode the signature is only queued, checked once per block */
+	if (context->batch)
+		return (sig_batch_add(context->batch, match_found->out.pub,
+			context->tx_id, &in->sig));
+
+	/* Get the public key from the matched unspent output, decoded once */
+	key = ec_cache_get(match_found->out.pub);
 
 	/* Return 1 if no valid public key is found */
 	if (!key)
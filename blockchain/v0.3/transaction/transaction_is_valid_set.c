@@ -0,0 +1,118 @@
+#include "transaction.h"
+
+/**
+* transaction_is_valid_set - Checks whether a transaction is valid against
+* a hashed set of unspent outputs
+* @transaction: The transaction to be validated
+* @set: Set of unspent transaction outputs
+* Return: 1 if the transaction is valid, 0 if invalid
+*
+* Description: Each input is found in O(1) instead of scanning the whole
+* list of unspent outputs, see utxo_set_from_list() to build @set once for
+* many transactions.
+*/
+int transaction_is_valid_set(
+	const transaction_t *transaction, utxo_set_t *set)
+{
+	tv_t context = {0};
+
+	/* Check if either transaction or unspent set is NULL */
+	if (!transaction || !set)
+		return (0);
+
+	/* Copy the transaction ID and unspent set into the context structure */
+	memcpy(context.tx_id, transaction->id, SHA256_DIGEST_LENGTH);
+	context.set = set;
+
+	return (tx_context_is_valid(transaction, &context));
+}
+
+/**
+* tx_context_is_valid - Checks a transaction against a filled in context
+* @transaction: The transaction to be validated
+* @context: Context holding the transaction ID and the unspent outputs
+* Return: 1 if the transaction is valid, 0 if invalid
+*/
+int tx_context_is_valid(const transaction_t *transaction, tv_t *context)
+{
+	uint8_t v_hash[SHA256_DIGEST_LENGTH];
+
+	/* Compute the hash of the transaction */
+	transaction_hash(transaction, v_hash);
+
+	/* Compare the computed hash with the transaction's ID */
+	if (memcmp(v_hash, transaction->id, SHA256_DIGEST_LENGTH))
+		return (0);
+
+	/* Verify the validity of each input transaction */
+	if (llist_for_each(transaction->inputs,
+		(node_func_t)&validate_input_signature, context))
+		return (0);
+
+	/* Two equal outputs would share one key in the unspent set */
+	if (!tx_outputs_unique(transaction))
+		return (0);
+
+	/* Accumulate the total amount from the transaction outputs */
+	llist_for_each(transaction->outputs,
+					(node_func_t)&accumulate_output_value, context);
+
+	/* Ensure that the total inputs equal total outputs */
+	if (context->input != context->output)
+		return (0);
+
+	/* Return 1 if the transaction is valid */
+	return (1);
+}
+
+/**
+* tx_outputs_unique - Checks no two outputs of a transaction share a hash
+* @transaction: The transaction to check
+* Return: 1 if every output hash is unique, 0 otherwise or on failure
+*
+* Description: The hashes are sorted so equal ones end up side by side,
+* O(n log n) in the number of outputs.
+*/
+int tx_outputs_unique(const transaction_t *transaction)
+{
+	uint8_t (*hashes)[SHA256_DIGEST_LENGTH];
+	int n = llist_size(transaction->outputs), i, unique = 1;
+
+	if (n < 2)
+		return (n >= 0);
+	hashes = malloc(n * sizeof(*hashes));
+	if (!hashes)
+		return (0);
+	llist_for_each(transaction->outputs, (node_func_t)&output_hash_cpy,
+		hashes);
+	qsort(hashes, n, sizeof(*hashes), output_hash_cmp);
+	for (i = 1; i < n && unique; i++)
+		unique = memcmp(hashes[i - 1], hashes[i], SHA256_DIGEST_LENGTH) != 0;
+	free(hashes);
+	return (unique);
+}
+
+/**
+* output_hash_cpy - Copies the hash of an output into an array
+* @out: Output to copy the hash of
+* @i: Index of the output in the array
+* @hashes: Array of hashes to copy to
+* Return: Always 0
+*/
+int output_hash_cpy(tx_out_t *out, unsigned int i, void *hashes)
+{
+	memcpy(((uint8_t (*)[SHA256_DIGEST_LENGTH])hashes)[i], out->hash,
+		SHA256_DIGEST_LENGTH);
+	return (0);
+}
+
+/**
+* output_hash_cmp - qsort() comparison of output hashes
+* @a: First hash
+* @b: Second hash
+* Return: Negative, 0 or positive as for memcmp()
+*/
+int output_hash_cmp(const void *a, const void *b)
+{
+	return (memcmp(a, b, SHA256_DIGEST_LENGTH));
+}
@@ -14,7 +14,6 @@ sig_t *tx_in_sign(
 	ti_t *in, uint8_t const tx_id[SHA256_DIGEST_LENGTH], EC_KEY const *sender,
 	llist_t *unused_transactions)
 {
-	uint8_t pub_key[EC_PUB_LEN] = {0};
 	uto_t *trans_out = NULL;
 
 	/* Validate input parameters */
@@ -26,11 +25,8 @@ sig_t *tx_in_sign(
 	if (!trans_out)
 		return (NULL);
 
-	/* Convert the sender's private key to the corresponding public key */
-	ec_to_pub(sender, pub_key);
-
-	/* Verify the public key matches the unspent transaction output */
-	if (memcmp(pub_key, trans_out->out.pub, EC_PUB_LEN))
+	/* Verify the sender's key matches the unspent transaction output */
+	if (!ec_cache_match(sender, trans_out->out.pub))
 		return (NULL);
 
 	/* Sign the transaction input */
@@ -53,3 +49,37 @@ int check_hash(llist_node_t out, void *hash)
 		return (1);
 	return (0);
 }
+
+/**
+* tx_in_sign_set - Signs a transaction input after verifying key, looking
+* the spent output up in a set
+* @in: Transaction input
+* @tx_id: hash of transaction holding tx_input
+* @sender: private key of receiver
+* @set: set of all unspent transactions
+* Return: hash holding the signature or NULL
+*/
+sig_t *tx_in_sign_set(
+	ti_t *in, uint8_t const tx_id[SHA256_DIGEST_LENGTH], EC_KEY const *sender,
+	utxo_set_t const *set)
+{
+	uto_t *trans_out = NULL;
+
+	/* Validate input parameters */
+	if (!in || !tx_id || !sender || !set)
+		return (NULL);
+
+	/* Find the spent output by its full key */
+	trans_out = utxo_set_find(set, in->block_hash, in->tx_id, in->tx_out_hash);
+	if (!trans_out)
+		return (NULL);
+
+	/* Verify the sender's key matches the unspent transaction output */
+	if (!ec_cache_match(sender, trans_out->out.pub))
+		return (NULL);
+
+	/* Sign the transaction input */
+	if (!ec_sign(sender, tx_id, SHA256_DIGEST_LENGTH, &in->sig))
+		return (NULL);
+	return (&in->sig);
+}
@@ -1,23 +1,78 @@
 #include "transaction.h"
 
 /**
-* THIS WILL NOT ACTUALLY WORK - DUMMY IMPLEMENTATION
 * update_unspent - Updates the list of unspent transaction outputs (UTXOs)
 * @transactions: List of validated transactions
 * @block_hash: Hash of the block containing these transactions
 * @all_unspent: Current list of all unspent transaction outputs
-* Return: A new list of unspent transaction outputs
+* Return: @all_unspent, updated in place, or NULL on failure
+*
+* Description: The list is indexed once and the block applied to the index
+* with utxo_set_update(). A plain list can't drop a node without a scan, so
+* the survivors are then relinked in one pass, in their original order,
+* followed by the created outputs. No output is copied. The list is only
+* touched once the whole block applied to the index: if it doesn't, as
+* when a transaction spends an output that isn't there, NULL is returned
+* and @all_unspent is left as it was. Only a failed allocation while
+* relinking, also reported by NULL, can lose outputs. Callers holding a utxo_set_t should call
+* utxo_set_update() directly: it only costs the block's inputs and outputs.
 */
 llist_t *update_unspent(llist_t *transactions,
-							uint8_t block_hash[SHA256_DIGEST_LENGTH] __attribute__((unused)),
-							llist_t *all_unspent __attribute__((unused)))
+							uint8_t block_hash[SHA256_DIGEST_LENGTH],
+							llist_t *all_unspent)
 {
-	/* make a new list for unspent outputs */
-	llist_t *new_unspent = llist_create(MT_SUPPORT_FALSE);
+	llist_t *created;
+	utxo_set_t *set;
+	int fail, lost = 0;
 
-	/* Dummy implementation - loop through the transactions (but do nothing) */
-	llist_for_each(transactions, (node_func_t)NULL, NULL);
+	if (!transactions || !block_hash || !all_unspent)
+		return (NULL);
 
-	/* Return the new unspent list */
-	return (new_unspent);
+	/* Index the current outputs, the list keeps owning them */
+	set = utxo_set_from_list(all_unspent);
+	created = llist_create(MT_SUPPORT_FALSE);
+
+	/* Spent outputs leave the set, new ones go to the set and to created */
+	fail = !set || !created ||
+		utxo_set_update(set, transactions, block_hash, created, 0);
+
+	/* Relink what is still unspent, freeing what was spent */
+	if (!fail)
+	{
+		lost = unspent_keep(all_unspent, all_unspent, set);
+		lost |= unspent_keep(created, all_unspent, set);
+	}
+
+	utxo_set_destroy(set, 0);
+	llist_destroy(created, fail && llist_size(created) > 0, NULL);
+	return (fail || lost ? NULL : all_unspent);
+}
+
+/**
+* unspent_keep - Moves the outputs still in a set from one list to another
+* @from: List to empty
+* @to: List to append the outputs still in @set to, may be @from
+* @set: Set of the outputs to keep, the others are freed
+* Return: 0 on success, 1 on failure, an output that couldn't be added is
+* freed
+*/
+int unspent_keep(llist_t *from, llist_t *to, utxo_set_t const *set)
+{
+	int size = llist_size(from), i, fail = 0;
+	uto_t *unspent;
+
+	/* Popping from the head and adding to the rear keeps the order */
+	for (i = 0; i < size; i++)
+	{
+		unspent = llist_pop(from);
+		if (utxo_set_find(set, unspent->block_hash, unspent->tx_id,
+			unspent->out.hash) != unspent)
+			free(unspent);
+		else if (llist_add_node(to, unspent, ADD_NODE_REAR))
+		{
+			free(unspent);
+			fail = 1;
+		}
+	}
+	return (fail);
 }
@@ -0,0 +1,159 @@
+#include "transaction.h"
+
+/**
+* utxo_addr_hash - Hashes a public key
+* @pub: Public key
+* Return: The hash
+*
+* Description: Byte 0 is always the uncompressed point tag, the X
+* coordinate right after it is already uniform.
+*/
+uint64_t utxo_addr_hash(uint8_t const pub[EC_PUB_LEN])
+{
+	uint64_t h;
+
+	memcpy(&h, pub + 1, sizeof(h));
+	return (h);
+}
+
+/**
+* utxo_addr_find - Looks the outputs of a public key up
+* @set: Set with indexed addresses
+* @pub: Public key
+* Return: The key's outputs, or NULL if it has none
+*/
+utxo_addr_t *utxo_addr_find(utxo_set_t const *set,
+	uint8_t const pub[EC_PUB_LEN])
+{
+	uint64_t hash;
+	size_t mask, i;
+	utxo_addr_t *addr;
+
+	if (!set || !set->addrs || !pub)
+		return (NULL);
+
+	hash = utxo_addr_hash(pub);
+	mask = set->addr_capacity - 1;
+	for (i = hash & mask; set->addrs[i]; i = (i + 1) & mask)
+	{
+		addr = set->addrs[i];
+		if (addr->hash == hash && !memcmp(addr->pub, pub, EC_PUB_LEN))
+			return (addr);
+	}
+	return (NULL);
+}
+
+/**
+* utxo_addr_link - Files an output under its public key
+* @set: Set with indexed addresses
+* @utxo: Output to file
+* Return: 0 on success, 1 on failure
+*/
+int utxo_addr_link(utxo_set_t *set, uto_t *utxo)
+{
+	utxo_addr_t *addr = utxo_addr_find(set, utxo->out.pub);
+	size_t i, mask;
+	uto_t **utxos;
+
+	if (!addr)
+	{
+		if ((set->addr_count + 1) * UTXO_SET_LOAD_DEN >
+			set->addr_capacity * UTXO_SET_LOAD_NUM &&
+			utxo_addr_grow(set, set->addr_capacity * 2))
+			return (1);
+		addr = calloc(1, sizeof(*addr));
+		if (!addr)
+			return (1);
+		memcpy(addr->pub, utxo->out.pub, EC_PUB_LEN);
+		addr->hash = utxo_addr_hash(addr->pub);
+		mask = set->addr_capacity - 1;
+		for (i = addr->hash & mask; set->addrs[i]; i = (i + 1) & mask)
+			;
+		set->addrs[i] = addr;
+		set->addr_count++;
+	}
+	if (addr->count == addr->capacity)
+	{
+		utxos = realloc(addr->utxos, (addr->capacity ? addr->capacity * 2 :
+			4) * sizeof(*utxos));
+		if (!utxos)
+			return (1);
+		addr->utxos = utxos;
+		addr->capacity = addr->capacity ? addr->capacity * 2 : 4;
+	}
+	addr->utxos[addr->count++] = utxo;
+	addr->balance += utxo->out.amount;
+	return (0);
+}
+
+/**
+* utxo_addr_unlink - Takes an output out of its public key's outputs
+* @set: Set with indexed addresses
+* @utxo: Output to take out
+*
+* Description: Costs the number of outputs of the same key. The address
+* is dropped with its last output, shifting its probe run back.
+*/
+void utxo_addr_unlink(utxo_set_t *set, uto_t const *utxo)
+{
+	utxo_addr_t *addr = utxo_addr_find(set, utxo->out.pub);
+	size_t i, j, home, mask = set->addr_capacity - 1;
+
+	if (!addr)
+		return;
+	for (i = 0; i < addr->count && addr->utxos[i] != utxo; i++)
+		;
+	if (i == addr->count)
+		return;
+	/* Keep the oldest first order coin selection relies on */
+	memmove(addr->utxos + i, addr->utxos + i + 1,
+		(addr->count - i - 1) * sizeof(*addr->utxos));
+	addr->count--;
+	addr->balance -= utxo->out.amount;
+	if (addr->count)
+		return;
+
+	for (i = addr->hash & mask; set->addrs[i] != addr; i = (i + 1) & mask)
+		;
+	for (j = (i + 1) & mask; set->addrs[j]; j = (j + 1) & mask)
+	{
+		home = set->addrs[j]->hash & mask;
+		if (((j - home) & mask) >= ((j - i) & mask))
+		{
+			set->addrs[i] = set->addrs[j];
+			i = j;
+		}
+	}
+	set->addrs[i] = NULL;
+	set->addr_count--;
+	free(addr->utxos);
+	free(addr);
+}
+
+/**
+* utxo_addr_grow - Moves every address of a set to a bigger table
+* @set: Set with indexed addresses
+* @capacity: New number of address slots, a power of two
+* Return: 0 on success, 1 on failure, the set is then left untouched
+*/
+int utxo_addr_grow(utxo_set_t *set, size_t capacity)
+{
+	utxo_addr_t **addrs = calloc(capacity, sizeof(*addrs));
+	size_t i, j;
+
+	if (!addrs)
+		return (1);
+	for (i = 0; i < set->addr_capacity; i++)
+	{
+		if (!set->addrs[i])
+			continue;
+		for (j = set->addrs[i]->hash & (capacity - 1); addrs[j];
+			j = (j + 1) & (capacity - 1))
+			;
+		addrs[j] = set->addrs[i];
+	}
+	free(set->addrs);
+	set->addrs = addrs;
+	set->addr_capacity = capacity;
+	return (0);
+}
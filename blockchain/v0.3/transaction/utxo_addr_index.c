@@ -0,0 +1,77 @@
+#include "transaction.h"
+
+/**
+* utxo_set_index_addresses - Starts grouping the outputs of a set by
+* public key, the index is then kept up to date by every add and remove
+* @set: Set to index
+* Return: 0 on success, 1 on failure
+*
+* Description: Off by default, sets only used to validate blocks don't
+* pay for it. Indexing an already indexed set does nothing. The outputs are
+* filed in the order they were added to the set, not in slot order, so
+* each key's outputs are oldest first, as in the list the set was built
+* from.
+*/
+int utxo_set_index_addresses(utxo_set_t *set)
+{
+	utxo_slot_t *sorted;
+	size_t i;
+
+	if (!set)
+		return (1);
+	if (set->addrs)
+		return (0);
+
+	sorted = utxo_set_sorted(set);
+	set->addr_capacity = UTXO_SET_MIN;
+	set->addr_count = 0;
+	set->addrs = calloc(set->addr_capacity, sizeof(*set->addrs));
+	for (i = 0; sorted && set->addrs && i < set->count; i++)
+		if (utxo_addr_link(set, sorted[i].utxo))
+			break;
+	free(sorted);
+	if (!sorted || !set->addrs || i < set->count)
+	{
+		utxo_addr_destroy(set);
+		return (1);
+	}
+	return (0);
+}
+
+/**
+* utxo_set_balance - Sums the unspent outputs paying to a public key
+* @set: Set with indexed addresses
+* @pub: Public key to sum the outputs of
+* Return: The balance, 0 if the key has no output
+*/
+uint64_t utxo_set_balance(utxo_set_t const *set,
+	uint8_t const pub[EC_PUB_LEN])
+{
+	utxo_addr_t const *addr = utxo_addr_find(set, pub);
+
+	return (addr ? addr->balance : 0);
+}
+
+/**
+* utxo_addr_destroy - Frees the address index of a set
+* @set: Set to drop the address index of
+*/
+void utxo_addr_destroy(utxo_set_t *set)
+{
+	size_t i;
+
+	if (!set || !set->addrs)
+		return;
+	for (i = 0; i < set->addr_capacity; i++)
+	{
+		if (set->addrs[i])
+		{
+			free(set->addrs[i]->utxos);
+			free(set->addrs[i]);
+		}
+	}
+	free(set->addrs);
+	set->addrs = NULL;
+	set->addr_capacity = 0;
+	set->addr_count = 0;
+}
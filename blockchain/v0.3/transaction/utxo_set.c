@@ -0,0 +1,125 @@
+#include "transaction.h"
+
+/**
+* utxo_set_create - Creates an empty hashed set of unspent outputs
+* @hint: Number of outputs the set is expected to hold, 0 if unknown
+* Return: NULL or pointer to the new set
+*/
+utxo_set_t *utxo_set_create(size_t hint)
+{
+	utxo_set_t *set = calloc(1, sizeof(*set));
+
+	if (!set)
+		return (NULL);
+
+	/* Smallest power of two keeping the load under UTXO_SET_LOAD */
+	set->capacity = UTXO_SET_MIN;
+	while (hint * UTXO_SET_LOAD_DEN > set->capacity * UTXO_SET_LOAD_NUM)
+		set->capacity *= 2;
+
+	set->slots = calloc(set->capacity, sizeof(*set->slots));
+	if (!set->slots)
+	{
+		free(set);
+		return (NULL);
+	}
+	return (set);
+}
+
+/**
+* utxo_set_destroy - Frees a set of unspent outputs
+* @set: Set to free
+* @free_utxos: 1 to also free the outputs it holds, 0 to leave them alone
+*/
+void utxo_set_destroy(utxo_set_t *set, int free_utxos)
+{
+	size_t i;
+
+	if (!set)
+		return;
+
+	/* The outputs may be shared with an llist, only free them if asked */
+	for (i = 0; free_utxos && i < set->capacity; i++)
+		free(set->slots[i].utxo);
+	utxo_addr_destroy(set);
+	free(set->slots);
+	free(set);
+}
+
+/**
+* utxo_key_hash - Hashes the key of an unspent output
+* @block_hash: Hash of the block holding the output
+* @tx_id: ID of the transaction holding the output
+* @out_hash: Hash of the output
+* Return: The key hash
+*
+* Description: The three parts are already SHA-256 digests, so eight bytes
+* of each, mixed, are uniform enough. The transaction ID has to take part:
+* two outputs of the same amount to the same key share their hash.
+*/
+uint64_t utxo_key_hash(uint8_t const block_hash[SHA256_DIGEST_LENGTH],
+	uint8_t const tx_id[SHA256_DIGEST_LENGTH],
+	uint8_t const out_hash[SHA256_DIGEST_LENGTH])
+{
+	uint64_t a, b, c, h;
+
+	memcpy(&a, block_hash, sizeof(a));
+	memcpy(&b, tx_id, sizeof(b));
+	memcpy(&c, out_hash, sizeof(c));
+	h = a ^ b * 0x9e3779b97f4a7c15ULL ^ c * 0xc2b2ae3d27d4eb4fULL;
+	return (h ^ h >> 29);
+}
+
+/**
+* utxo_set_slot - Finds the slot of an unspent output, or where it would go
+* @set: Set to search
+* @hash: Key hash, from utxo_key_hash()
+* @block_hash: Hash of the block holding the output
+* @tx_id: ID of the transaction holding the output
+* @out_hash: Hash of the output
+* Return: Index of the matching slot, or of the empty slot ending the probe
+*/
+size_t utxo_set_slot(utxo_set_t const *set, uint64_t hash,
+	uint8_t const block_hash[SHA256_DIGEST_LENGTH],
+	uint8_t const tx_id[SHA256_DIGEST_LENGTH],
+	uint8_t const out_hash[SHA256_DIGEST_LENGTH])
+{
+	size_t mask = set->capacity - 1, i = hash & mask;
+	utxo_slot_t const *slot;
+
+	/* Linear probing; the load factor guarantees an empty slot exists */
+	for (; ; i = (i + 1) & mask)
+	{
+		slot = &set->slots[i];
+		if (!slot->utxo)
+			return (i);
+		if (slot->hash == hash &&
+			!memcmp(slot->utxo->out.hash, out_hash, SHA256_DIGEST_LENGTH) &&
+			!memcmp(slot->utxo->tx_id, tx_id, SHA256_DIGEST_LENGTH) &&
+			!memcmp(slot->utxo->block_hash, block_hash, SHA256_DIGEST_LENGTH))
+			return (i);
+	}
+}
+
+/**
+* utxo_set_find - Looks an unspent output up by its key
+* @set: Set to search
+* @block_hash: Hash of the block holding the output
+* @tx_id: ID of the transaction holding the output
+* @out_hash: Hash of the output
+* Return: The unspent output, or NULL if the set doesn't hold it
+*/
+uto_t *utxo_set_find(utxo_set_t const *set,
+	uint8_t const block_hash[SHA256_DIGEST_LENGTH],
+	uint8_t const tx_id[SHA256_DIGEST_LENGTH],
+	uint8_t const out_hash[SHA256_DIGEST_LENGTH])
+{
+	uint64_t hash;
+
+	if (!set || !block_hash || !tx_id || !out_hash)
+		return (NULL);
+
+	hash = utxo_key_hash(block_hash, tx_id, out_hash);
+	return (set->slots[utxo_set_slot(set, hash, block_hash, tx_id,
+		out_hash)].utxo);
+}
@@ -0,0 +1,108 @@
+#include "transaction.h"
+
+/**
+* utxo_set_add - Inserts an unspent output into a set
+* @set: Set to insert into
+* @utxo: Output to insert, the set only keeps the pointer
+* Return: 0 on success, 1 on failure or if the set already holds its key
+*/
+int utxo_set_add(utxo_set_t *set, uto_t *utxo)
+{
+	uint64_t hash;
+	size_t i;
+
+	if (!set || !utxo)
+		return (1);
+
+	/* Grow before the insert would push the load past UTXO_SET_LOAD */
+	if ((set->count + 1) * UTXO_SET_LOAD_DEN >
+		set->capacity * UTXO_SET_LOAD_NUM &&
+		utxo_set_grow(set, set->capacity * 2))
+		return (1);
+
+	hash = utxo_key_hash(utxo->block_hash, utxo->tx_id, utxo->out.hash);
+	i = utxo_set_slot(set, hash, utxo->block_hash, utxo->tx_id,
+		utxo->out.hash);
+	if (set->slots[i].utxo)
+		return (1);
+	if (set->addrs && utxo_addr_link(set, utxo))
+		return (1);
+	set->slots[i].hash = hash;
+	set->slots[i].utxo = utxo;
+	set->slots[i].seq = set->next_seq++;
+	set->count++;
+	return (0);
+}
+
+/**
+* utxo_set_remove - Takes an unspent output out of a set
+* @set: Set to remove from
+* @block_hash: Hash of the block holding the output
+* @tx_id: ID of the transaction holding the output
+* @out_hash: Hash of the output
+* Return: The removed output, for the caller to free, or NULL if not found
+*/
+uto_t *utxo_set_remove(utxo_set_t *set,
+	uint8_t const block_hash[SHA256_DIGEST_LENGTH],
+	uint8_t const tx_id[SHA256_DIGEST_LENGTH],
+	uint8_t const out_hash[SHA256_DIGEST_LENGTH])
+{
+	size_t mask, i, j, home;
+	uto_t *utxo;
+
+	if (!set || !block_hash || !tx_id || !out_hash)
+		return (NULL);
+
+	mask = set->capacity - 1;
+	i = utxo_set_slot(set, utxo_key_hash(block_hash, tx_id, out_hash),
+		block_hash, tx_id, out_hash);
+	utxo = set->slots[i].utxo;
+	if (!utxo)
+		return (NULL);
+	if (set->addrs)
+		utxo_addr_unlink(set, utxo);
+
+	/* Shift the rest of the probe run back instead of leaving a tombstone */
+	for (j = (i + 1) & mask; set->slots[j].utxo; j = (j + 1) & mask)
+	{
+		home = set->slots[j].hash & mask;
+		if (((j - home) & mask) >= ((j - i) & mask))
+		{
+			set->slots[i] = set->slots[j];
+			i = j;
+		}
+	}
+	set->slots[i].utxo = NULL;
+	set->count--;
+	return (utxo);
+}
+
+/**
+* utxo_set_grow - Moves every output of a set to a bigger slot array
+* @set: Set to grow
+* @capacity: New number of slots, a power of two
+* Return: 0 on success, 1 on failure, the set is then left untouched
+*/
+int utxo_set_grow(utxo_set_t *set, size_t capacity)
+{
+	utxo_slot_t *slots = calloc(capacity, sizeof(*slots)), *old = set->slots;
+	size_t i, j, old_capacity = set->capacity;
+
+	if (!slots)
+		return (1);
+
+	/* Keys are unique, so each one goes to the first empty slot it meets */
+	for (i = 0; i < old_capacity; i++)
+	{
+		if (!old[i].utxo)
+			continue;
+		for (j = old[i].hash & (capacity - 1); slots[j].utxo;
+			j = (j + 1) & (capacity - 1))
+			;
+		slots[j] = old[i];
+	}
+	set->slots = slots;
+	set->capacity = capacity;
+	free(old);
+	return (0);
+}
@@ -0,0 +1,111 @@
+#include "transaction.h"
+
+/**
+* utxo_set_from_list - Indexes an llist of unspent outputs in a new set
+* @list: List of unspent outputs (uto_t)
+* Return: NULL or pointer to the new set
+*
+* Description: The set shares the outputs with @list, so it must be
+* destroyed with utxo_set_destroy(set, 0) while @list keeps owning them.
+*/
+utxo_set_t *utxo_set_from_list(llist_t *list)
+{
+	utxo_set_t *set;
+	int size;
+
+	if (!list)
+		return (NULL);
+
+	size = llist_size(list);
+	set = utxo_set_create(size > 0 ? (size_t)size : 0);
+	if (!set)
+		return (NULL);
+	if (llist_for_each(list, utxo_set_add_node, set))
+	{
+		utxo_set_destroy(set, 0);
+		return (NULL);
+	}
+	return (set);
+}
+
+/**
+* utxo_set_add_node - llist_for_each() action inserting an output in a set
+* @utxo: Unspent output (uto_t)
+* @iter: Index of the output in its list (unused)
+* @set: Set to insert into
+* Return: 0 on success, 1 on failure
+*/
+int utxo_set_add_node(llist_node_t utxo, unsigned int iter, void *set)
+{
+	uto_t *unspent = utxo;
+
+	(void)iter;
+	if (!utxo_set_add(set, unspent))
+		return (0);
+
+	/* A duplicate key in the list is kept out of the set, not an error */
+	return (!utxo_set_find(set, unspent->block_hash, unspent->tx_id,
+		unspent->out.hash));
+}
+
+/**
+* utxo_set_to_list - Lists the outputs of a set in an llist
+* @set: Set to list
+* Return: NULL or pointer to a new list sharing the outputs with @set, in
+* the order they were added to the set
+*/
+llist_t *utxo_set_to_list(utxo_set_t const *set)
+{
+	utxo_slot_t *sorted;
+	llist_t *list;
+	size_t i;
+
+	if (!set)
+		return (NULL);
+
+	sorted = utxo_set_sorted(set);
+	list = sorted ? llist_create(MT_SUPPORT_FALSE) : NULL;
+	for (i = 0; list && i < set->count; i++)
+	{
+		if (llist_add_node(list, sorted[i].utxo, ADD_NODE_REAR))
+		{
+			llist_destroy(list, 0, NULL);
+			list = NULL;
+		}
+	}
+	free(sorted);
+	return (list);
+}
+
+/**
+* utxo_set_sorted - Copies the full slots of a set in insertion order
+* @set: Set
+* Return: NULL or array of @set->count slots, to free
+*/
+utxo_slot_t *utxo_set_sorted(utxo_set_t const *set)
+{
+	utxo_slot_t *sorted = malloc((set->count + 1) * sizeof(*sorted));
+	size_t i, n = 0;
+
+	if (!sorted)
+		return (NULL);
+	for (i = 0; i < set->capacity; i++)
+		if (set->slots[i].utxo)
+			sorted[n++] = set->slots[i];
+	qsort(sorted, n, sizeof(*sorted), utxo_slot_seq_cmp);
+	return (sorted);
+}
+
+/**
+* utxo_slot_seq_cmp - qsort() comparison of slots by insertion number
+* @a: First slot
+* @b: Second slot
+* Return: Negative, 0 or positive as @a was added before, with or after @b
+*/
+int utxo_slot_seq_cmp(void const *a, void const *b)
+{
+	uint64_t x = ((utxo_slot_t const *)a)->seq;
+	uint64_t y = ((utxo_slot_t const *)b)->seq;
+
+	return ((x > y) - (x < y));
+}
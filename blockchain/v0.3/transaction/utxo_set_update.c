@@ -0,0 +1,107 @@
+#include "transaction.h"
+
+/**
+* utxo_set_update - Applies the transactions of a block to a set of
+* unspent outputs
+* @set: Set to update
+* @transactions: List of validated transactions
+* @block_hash: Hash of the block containing these transactions
+* @created: List to append each created output to, or NULL; must be NULL
+* when @free_spent is 1, an output spent in its own block would be freed
+* @free_spent: 1 if the set owns its outputs and frees them once spent
+* Return: 0 on success, 1 on failure
+*
+* Description: Costs one removal per input and one insertion per output,
+* whatever the size of the set. Transactions are applied in order, so one
+* may spend an output created earlier in the same block.
+*/
+int utxo_set_update(utxo_set_t *set, llist_t *transactions,
+	uint8_t const block_hash[SHA256_DIGEST_LENGTH], llist_t *created,
+	int free_spent)
+{
+	ul_t context = {0};
+
+	if (!set || !transactions || !block_hash || (created && free_spent))
+		return (1);
+
+	memcpy(context.hash, block_hash, SHA256_DIGEST_LENGTH);
+	context.unspent = created;
+	context.set = set;
+	context.free_spent = free_spent;
+	return (llist_for_each(transactions, utxo_apply_tx, &context) != 0);
+}
+
+/**
+* utxo_apply_tx - llist_for_each() action applying one transaction
+* @tx: Transaction (transaction_t)
+* @iter: Index of the transaction in its block (unused)
+* @context: Update context (ul_t)
+* Return: 0 on success, 1 on failure
+*/
+int utxo_apply_tx(llist_node_t tx, unsigned int iter, void *context)
+{
+	transaction_t *transaction = tx;
+	ul_t *update = context;
+
+	(void)iter;
+	memcpy(update->tx_id, transaction->id, SHA256_DIGEST_LENGTH);
+
+	/* Spend first: the outputs of a transaction can't fund its own inputs */
+	llist_for_each(transaction->inputs, utxo_spend_input, update);
+	if (llist_for_each(transaction->outputs, utxo_add_output, update))
+		return (1);
+	return (0);
+}
+
+/**
+* utxo_spend_input - llist_for_each() action removing a spent output
+* @in: Transaction input (tx_in_t)
+* @iter: Index of the input (unused)
+* @context: Update context (ul_t)
+* Return: Always 0
+*/
+int utxo_spend_input(llist_node_t in, unsigned int iter, void *context)
+{
+	tx_in_t *input = in;
+	ul_t *update = context;
+	uto_t *spent;
+
+	(void)iter;
+	spent = utxo_set_remove(update->set,
+		input->block_hash, input->tx_id, input->tx_out_hash);
+	if (spent && update->free_spent)
+		free(spent);
+	return (0);
+}
+
+/**
+* utxo_add_output - llist_for_each() action adding a created output
+* @out: Transaction output (tx_out_t)
+* @iter: Index of the output (unused)
+* @context: Update context (ul_t)
+* Return: 0 on success, 1 on failure
+*/
+int utxo_add_output(llist_node_t out, unsigned int iter, void *context)
+{
+	ul_t *update = context;
+	uto_t *unspent;
+
+	(void)iter;
+	unspent = unspent_tx_out_create(update->hash, update->tx_id, out);
+	if (!unspent)
+		return (1);
+	if (utxo_set_add(update->set, unspent))
+	{
+		free(unspent);
+		return (1);
+	}
+	if (update->unspent &&
+		llist_add_node(update->unspent, unspent, ADD_NODE_REAR))
+	{
+		utxo_set_remove(update->set, unspent->block_hash, unspent->tx_id,
+			unspent->out.hash);
+		free(unspent);
+		return (1);
+	}
+	return (0);
+}
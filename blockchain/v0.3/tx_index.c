@@ -0,0 +1,271 @@
+#include "blockchain.h"
+#include <fcntl.h>
+
+int tx_index_cmp(void const *a, void const *b);
+int tx_index_open(char const *path, uint32_t *count);
+int tx_index_search(int fd, uint32_t count,
+	uint8_t const id[SHA256_DIGEST_LENGTH], tx_index_entry_t *entry);
+int tx_index_write(tx_index_entry_t *entries, uint32_t n, uint32_t nblocks,
+	uint64_t chain_size, char const *path);
+
+/**
+ * tx_index_save - writes the transaction index sidecar of a chain file
+ * @blockchain: chain saved to @path, its transactions get indexed
+ * @path: chain file
+ * Return: 0 on success, 1 on fail
+ */
+int tx_index_save(blockchain_t *blockchain, char const *path)
+{
+	tx_index_entry_t *entries;
+	chain_store_t const *store;
+	struct stat st;
+	uint32_t i, n = 0;
+	int ret;
+
+	if (!blockchain || !path || stat(path, &st) ||
+		blockchain_index_txs(blockchain) ||
+		(!chain_store_fresh(blockchain) && chain_store_sync(blockchain)))
+		return (1);
+	store = &blockchain->store;
+	entries = malloc((store->tx_count + 1) * sizeof(*entries));
+	if (!entries)
+		return (1);
+	for (i = 0; i < store->tx_capacity; i++)
+	{
+		if (!store->txs[i].tx)
+			continue;
+		memcpy(entries[n].id, store->txs[i].tx->id, SHA256_DIGEST_LENGTH);
+		entries[n].height = store->txs[i].height;
+		entries[n++].pos = store->txs[i].pos;
+	}
+	ret = tx_index_write(entries, n, store->count, st.st_size, path);
+	free(entries);
+	return (ret);
+}
+
+/**
+ * tx_index_rebuild - writes the transaction index sidecar of a chain file
+ * from the file itself
+ * @path: chain file
+ * Return: 0 on success, 1 on fail
+ */
+int tx_index_rebuild(char const *path)
+{
+	chain_map_t *map = chain_map_open(path);
+	tx_index_entry_t *entries;
+	tx_view_t view;
+	uint32_t i;
+	size_t t;
+	int ret = 1;
+
+	if (!map)
+		return (1);
+	entries = malloc((map->ntxs + 1) * sizeof(*entries));
+	for (i = 0, t = 0; entries && i < map->nblocks; i++)
+	{
+		for (; t < map->first_tx[i + 1]; t++)
+		{
+			if (chain_map_tx_view(map, t, &view))
+				goto out;
+			memcpy(entries[t].id, view.id, SHA256_DIGEST_LENGTH);
+			entries[t].height = i;
+			entries[t].pos = t - map->first_tx[i];
+		}
+	}
+	if (entries)
+		ret = tx_index_write(entries, map->ntxs, map->nblocks, map->size,
+			path);
+out:
+	free(entries);
+	chain_map_close(map);
+	return (ret);
+}
+
+/**
+ * tx_index_write - sorts transaction index entries and writes them in the
+ * sidecar of a chain file
+ * @entries: entries, sorted by ID in place
+ * @n: number of entries
+ * @nblocks: number of blocks of the chain file
+ * @chain_size: size of the chain file, to tell when the sidecar is stale
+ * @path: chain file
+ * Return: 0 on success, 1 on fail
+ *
+ * Description: The sidecar holds a header, then the ID, block height and
+ * position in the block of each transaction, sorted by ID.
+ */
+int tx_index_write(tx_index_entry_t *entries, uint32_t n, uint32_t nblocks,
+	uint64_t chain_size, char const *path)
+{
+	serial_buf_t sb = {-1, NULL, 0, 0, 0, NULL, 0, 0};
+	char *txi = NULL, *tmp = NULL;
+	uint32_t i;
+	uint8_t *p;
+	int ret = 1;
+
+	txi = malloc(strlen(path) + sizeof(TX_INDEX_EXT));
+	tmp = malloc(strlen(path) + sizeof(TX_INDEX_EXT) + 4);
+	sb.buf = malloc(SERIAL_BUF_SIZE);
+	if (!txi || !tmp || !sb.buf)
+		goto out;
+	sprintf(txi, "%s%s", path, TX_INDEX_EXT);
+	sprintf(tmp, "%s.tmp", txi);
+	qsort(entries, n, sizeof(*entries), tx_index_cmp);
+	sb.fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (sb.fd == -1)
+		goto out;
+
+	p = serial_reserve(&sb, TX_INDEX_HEADER_SIZE);
+	memcpy(&p[0], TX_INDEX_MAGIC, 7);
+	memcpy(&p[7], END, 1);
+	memcpy(&p[8], &n, 4);
+	memcpy(&p[12], &nblocks, 4);
+	memcpy(&p[16], &chain_size, 8);
+	for (i = 0; i < n && (p = serial_reserve(&sb, TX_INDEX_ENTRY_SIZE)); i++)
+		memcpy(p, &entries[i], TX_INDEX_ENTRY_SIZE);
+	serial_flush(&sb);
+	if (close(sb.fd) || sb.error || rename(tmp, txi))
+		remove(tmp);
+	else
+		ret = 0;
+out:
+	free(sb.buf);
+	free(tmp);
+	free(txi);
+	return (ret);
+}
+
+/**
+ * blockchain_load_block_by_tx - loads the block of a chain file holding
+ * the transaction with the given ID
+ * @path: chain file
+ * @id: ID of the transaction
+ * @pos: set to the position of the transaction in the block, may be NULL
+ * Return: pointer to the block or NULL if the chain has no such
+ * transaction
+ *
+ * Description: The ID is found with a binary search of the transaction
+ * index sidecar, then the block read with a single seek. A sidecar that is
+ * missing, or whose block count or chain file size isn't the file's, as
+ * after chain_log_append(), is rebuilt first. The transaction is still
+ * checked to be in the block read.
+ */
+block_t *blockchain_load_block_by_tx(char const *path,
+	uint8_t const id[SHA256_DIGEST_LENGTH], uint32_t *pos)
+{
+	tx_index_entry_t entry;
+	transaction_t *tx;
+	block_t *block = NULL;
+	uint32_t count;
+	int fd;
+
+	if (!path || !id)
+		return (NULL);
+	fd = tx_index_open(path, &count);
+	if (fd == -1)
+		return (NULL);
+	if (tx_index_search(fd, count, id, &entry))
+		block = blockchain_load_block(path, entry.height);
+	close(fd);
+	tx = block ? llist_get_node_at(block->transactions, entry.pos) : NULL;
+	if (!tx || memcmp(tx->id, id, SHA256_DIGEST_LENGTH))
+	{
+		block_destroy(block);
+		block = NULL;
+	}
+	else if (pos)
+		*pos = entry.pos;
+	return (block);
+}
+
+/**
+ * tx_index_open - opens the transaction index sidecar of a chain file,
+ * rebuilding it if it is missing or stale
+ * @path: chain file
+ * @count: set to the number of transactions of the sidecar
+ * Return: file descriptor of the sidecar, or -1
+ */
+int tx_index_open(char const *path, uint32_t *count)
+{
+	char *txi = malloc(strlen(path) + sizeof(TX_INDEX_EXT));
+	uint8_t header[TX_INDEX_HEADER_SIZE];
+	uint32_t nblocks, chain_nblocks;
+	uint64_t chain_size;
+	struct stat st;
+	int fd = -1, chain, tries;
+
+	chain = open(path, O_RDONLY);
+	if (!txi || chain == -1 || fstat(chain, &st) ||
+		pread(chain, &chain_nblocks, 4, 8) != 4)
+		goto out;
+	sprintf(txi, "%s%s", path, TX_INDEX_EXT);
+	for (tries = 0; tries < 2; tries++)
+	{
+		if (tries && tx_index_rebuild(path))
+			break;
+		fd = open(txi, O_RDONLY);
+		if (fd == -1)
+			continue;
+		if (read(fd, header, sizeof(header)) == sizeof(header) &&
+			!memcmp(header, TX_INDEX_MAGIC, 7) &&
+			header[7] == (uint8_t)END[0])
+		{
+			memcpy(count, &header[8], 4);
+			memcpy(&nblocks, &header[12], 4);
+			memcpy(&chain_size, &header[16], 8);
+			if (nblocks == chain_nblocks &&
+				chain_size == (uint64_t)st.st_size)
+				break;
+		}
+		close(fd);
+		fd = -1;
+	}
+out:
+	if (chain != -1)
+		close(chain);
+	free(txi);
+	return (fd);
+}
+
+/**
+ * tx_index_search - binary searches a transaction index sidecar
+ * @fd: open sidecar
+ * @count: number of transactions of the sidecar
+ * @id: ID of the transaction
+ * @entry: set to the matching entry
+ * Return: 1 if found, 0 otherwise
+ */
+int tx_index_search(int fd, uint32_t count,
+	uint8_t const id[SHA256_DIGEST_LENGTH], tx_index_entry_t *entry)
+{
+	uint32_t lo, hi = count, mid;
+	int cmp;
+
+	for (lo = 0; lo < hi;)
+	{
+		mid = lo + (hi - lo) / 2;
+		if (pread(fd, entry, TX_INDEX_ENTRY_SIZE, TX_INDEX_HEADER_SIZE +
+			(off_t)mid * TX_INDEX_ENTRY_SIZE) != TX_INDEX_ENTRY_SIZE)
+			return (0);
+		cmp = memcmp(entry->id, id, SHA256_DIGEST_LENGTH);
+		if (!cmp)
+			return (1);
+		if (cmp < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return (0);
+}
+
+/**
+ * tx_index_cmp - qsort() comparison of transaction index entries by ID
+ * @a: first entry
+ * @b: second entry
+ * Return: memcmp() of the IDs
+ */
+int tx_index_cmp(void const *a, void const *b)
+{
+	return (memcmp(((tx_index_entry_t const *)a)->id,
+		((tx_index_entry_t const *)b)->id, SHA256_DIGEST_LENGTH));
+}
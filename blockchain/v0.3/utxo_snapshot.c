@@ -0,0 +1,109 @@
+#include "blockchain.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+
+/**
+ * utxo_snapshot_save - saves a set of unspent outputs, tagged with the
+ * block it is up to date with
+ * @set: set to save
+ * @tip: last block applied to @set
+ * @height: height of @tip in its chain
+ * @path: file to save to
+ * Return: 0 on success, 1 on fail
+ *
+ * Description: The records are the 165 byte ones blockchain_serialize()
+ * writes, in the order the outputs were added to @set. The file is written
+ * aside and renamed over @path, so a crash leaves the previous snapshot
+ * whole.
+ */
+int utxo_snapshot_save(utxo_set_t const *set, block_t const *tip,
+	uint32_t height, char const *path)
+{
+	serial_buf_t sb = {-1, NULL, 0, 0, 0, NULL, 0, 0};
+	utxo_slot_t *sorted;
+	uint32_t count;
+	char *tmp = NULL;
+	uint8_t *p;
+	size_t i;
+	int ret = 1;
+
+	if (!set || !tip || !path)
+		return (1);
+	count = set->count;
+	tmp = malloc(strlen(path) + 5);
+	sb.buf = malloc(SERIAL_BUF_SIZE);
+	if (!tmp || !sb.buf)
+		goto out;
+	sprintf(tmp, "%s.tmp", path);
+	sb.fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+	if (sb.fd == -1)
+		goto out;
+
+	p = serial_reserve(&sb, UTXO_SNAPSHOT_HEADER_SIZE);
+	memcpy(&p[0], UTXO_SNAPSHOT_MAGIC, 7);
+	memcpy(&p[7], END, 1);
+	memcpy(&p[8], &height, 4);
+	memcpy(&p[12], &count, 4);
+	memcpy(&p[16], tip->hash, SHA256_DIGEST_LENGTH);
+	sorted = utxo_set_sorted(set);
+	if (!sorted)
+		sb.error = 1;
+	for (i = 0; sorted && i < set->count && !sb.error; i++)
+		write_unspent(sorted[i].utxo, 0, &sb);
+	free(sorted);
+	serial_flush(&sb);
+	if (close(sb.fd) || sb.error || rename(tmp, path))
+		remove(tmp);
+	else
+		ret = 0;
+out:
+	free(sb.buf);
+	free(tmp);
+	return (ret);
+}
+
+/**
+ * utxo_snapshot_load - loads a UTXO snapshot in a new set
+ * @path: file to load
+ * @height: set to the height of the block the snapshot is up to date with
+ * @tip: filled in with the hash of that block
+ * Return: set owning its outputs, or NULL if the file is missing or broken
+ */
+utxo_set_t *utxo_snapshot_load(char const *path, uint32_t *height,
+	uint8_t tip[SHA256_DIGEST_LENGTH])
+{
+	chain_map_t map = {0};
+	utxo_set_t *set = NULL;
+	uint32_t count, i;
+	uto_t *unspent;
+
+	if (!path || !height || !tip || chain_map_file(&map, path))
+		return (NULL);
+	if (map.size < UTXO_SNAPSHOT_HEADER_SIZE ||
+		memcmp(map.base, UTXO_SNAPSHOT_MAGIC, 7) ||
+		map.base[7] != (uint8_t)END[0])
+		goto out;
+	memcpy(&count, map.base + 12, 4);
+	if ((map.size - UTXO_SNAPSHOT_HEADER_SIZE) / HBLK_UNSPENT_SIZE != count)
+		goto out;
+	map.unspent = UTXO_SNAPSHOT_HEADER_SIZE, map.nunspent = count;
+	set = utxo_set_create(count);
+	for (i = 0; set && i < count; i++)
+	{
+		unspent = chain_map_unspent(&map, i);
+		if (!unspent || utxo_set_add(set, unspent))
+		{
+			free(unspent);
+			utxo_set_destroy(set, 1);
+			set = NULL;
+		}
+	}
+	if (set)
+	{
+		memcpy(height, map.base + 8, 4);
+		memcpy(tip, map.base + 16, SHA256_DIGEST_LENGTH);
+	}
+out:
+	munmap((void *)map.base, map.size);
+	return (set);
+}
@@ -0,0 +1,60 @@
+#include "blockchain.h"
+
+/**
+ * utxo_snapshot_sync - brings the unspent outputs of a chain up to date
+ * from a UTXO snapshot
+ * @path: snapshot file
+ * @blockchain: chain, its store is filled again if it isn't in step and
+ * the blocks replayed loaded if they are pending
+ * @replayed: set to the number of blocks applied, may be NULL
+ * Return: set owning its outputs, up to date with the last block of
+ * @blockchain, or NULL on fail
+ *
+ * Description: Nothing is replayed when the snapshot was taken at the tip
+ * of @blockchain, and only the later blocks are when it is older, reached
+ * by height without walking the ones before. A snapshot that is missing,
+ * broken, or whose tip isn't in @blockchain at its height, as after a
+ * reorganization, is dropped for a replay of the whole chain.
+ */
+utxo_set_t *utxo_snapshot_sync(char const *path, blockchain_t *blockchain,
+	uint32_t *replayed)
+{
+	uint8_t tip[SHA256_DIGEST_LENGTH];
+	uint32_t height = 0, from = 0, count = 0;
+	utxo_set_t *set;
+	block_t *block;
+
+	if (!blockchain || (!chain_store_fresh(blockchain) &&
+		chain_store_sync(blockchain)))
+		return (NULL);
+	set = utxo_snapshot_load(path, &height, tip);
+	if (set)
+	{
+		block = blockchain_block_at(blockchain, height);
+		if (block && !memcmp(block->hash, tip, SHA256_DIGEST_LENGTH))
+			from = height + 1;
+		else
+		{
+			utxo_set_destroy(set, 1);
+			set = NULL;
+		}
+	}
+	if (!set)
+		set = utxo_set_create(0);
+	for (; set && (block = blockchain_block_at(blockchain, from)); from++)
+	{
+		/* A pending block of a lazy chain gets its transactions loaded */
+		if (!chain_lazy_txs(block->lazy, block) && !block->lazy)
+			continue;
+		count++;
+		if (!block->transactions || utxo_set_update(set, block->transactions,
+			block->hash, NULL, 1))
+		{
+			utxo_set_destroy(set, 1);
+			return (NULL);
+		}
+	}
+	if (set && replayed)
+		*replayed = count;
+	return (set);
+}